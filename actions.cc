@@ -19,15 +19,19 @@
 
 #include "actions.h"
 
+#include <algorithm>
 #include <limits>
 #include <stack>
 #include <typeinfo>
+#include <unordered_map>
 
 #include "problems.h"
 #include "refcount.h"
 #include "types.h"
 
-size_t Action::next_id = 0;
+#include "src/worker-pool.h"
+
+std::atomic<size_t> Action::next_id(0);
 
 Action::Action(const std::string& name, bool durative)
     : id_(next_id++),
@@ -137,8 +141,170 @@ ActionSchema::ActionSchema(const std::string& name, bool durative)
 
 void ActionSchema::add_parameter(Variable var) { parameters_.push_back(var); }
 
+namespace {
+
+// Hash function object for term tuples.
+struct TermsHash {
+  size_t operator()(const std::vector<Term>& terms) const {
+    size_t h = 0;
+    for (std::vector<Term>::const_iterator ti = terms.begin();
+         ti != terms.end(); ti++) {
+      h = 31 * h + std::hash<Term>()(*ti);
+    }
+    return h;
+  }
+};
+
+// A static precondition of an action schema, joined with the initial state
+// when the last of its parameters is bound during grounding.
+struct StaticJoin {
+  StaticJoin(const Atom& atom, Term parameter)
+      : atom(&atom), parameter(parameter) {}
+
+  // Atom of the static precondition.
+  const Atom* atom;
+  // The parameter bound by this join.  All other parameters of the atom
+  // precede it in the parameter list.
+  Term parameter;
+  // Objects for the parameter that make the atom true in the initial state,
+  // in grounding order, keyed on the values of the other variables of the
+  // atom.
+  std::unordered_map<std::vector<Term>, std::vector<Object>, TermsHash>
+      objects;
+};
+
+// Static preconditions joined at a single parameter.
+struct ParameterJoins {
+  // Position of each compatible object for the parameter.
+  std::unordered_map<Term, size_t> rank;
+  // Joins binding the parameter.
+  std::vector<StaticJoin> joins;
+};
+
+// Collects the static atoms that must be true in the initial state for the
+// given condition to hold.
+void CollectStaticAtoms(const Formula& condition,
+                        std::vector<const Atom*>* atoms) {
+  const Conjunction* conj = dynamic_cast<const Conjunction*>(&condition);
+  if (conj != 0) {
+    for (FormulaList::const_iterator fi = conj->conjuncts().begin();
+         fi != conj->conjuncts().end(); fi++) {
+      CollectStaticAtoms(**fi, atoms);
+    }
+    return;
+  }
+  const TimedLiteral* tl = dynamic_cast<const TimedLiteral*>(&condition);
+  if (tl != 0) {
+    CollectStaticAtoms(tl->literal(), atoms);
+    return;
+  }
+  const Atom* atom = dynamic_cast<const Atom*>(&condition);
+  if (atom != 0 && PredicateTable::static_predicate(atom->predicate())) {
+    atoms->push_back(atom);
+  }
+}
+
+// Indexes the initial atoms that match the atom of the given join.
+void IndexStaticJoin(const AtomSet& init_atoms,
+                     const std::unordered_map<Term, size_t>& rank,
+                     StaticJoin* join) {
+  const Atom& atom = *join->atom;
+  for (AtomSet::const_iterator ai = init_atoms.begin();
+       ai != init_atoms.end(); ai++) {
+    const Atom& init_atom = **ai;
+    if (init_atom.predicate() != atom.predicate()) {
+      continue;
+    }
+    const Term* value = 0;
+    std::vector<Term> key;
+    bool match = true;
+    for (size_t i = 0; i < atom.arity() && match; i++) {
+      const Term& t = atom.term(i);
+      if (t == join->parameter) {
+        if (value == 0) {
+          value = &init_atom.term(i);
+        } else {
+          match = (*value == init_atom.term(i));
+        }
+      } else if (t.object()) {
+        match = (t == init_atom.term(i));
+      } else {
+        key.push_back(init_atom.term(i));
+      }
+    }
+    if (match && rank.find(*value) != rank.end()) {
+      join->objects[key].push_back(value->as_object());
+    }
+  }
+  for (auto oi = join->objects.begin(); oi != join->objects.end(); oi++) {
+    std::vector<Object>& objects = (*oi).second;
+    std::sort(objects.begin(), objects.end(),
+              [&rank](Object o1, Object o2) {
+                return rank.find(o1)->second < rank.find(o2)->second;
+              });
+  }
+}
+
+// Returns the objects to try for a parameter, given the arguments bound to
+// the parameters preceding it.  Objects that fail a static precondition are
+// left out.
+const std::vector<Object>* ParameterObjects(
+    const std::vector<Object>& compatible, const ParameterJoins& pj,
+    const std::map<Variable, Term>& args, std::vector<Object>* joined) {
+  if (pj.joins.empty()) {
+    return &compatible;
+  }
+  joined->clear();
+  for (std::vector<StaticJoin>::const_iterator ji = pj.joins.begin();
+       ji != pj.joins.end(); ji++) {
+    const StaticJoin& join = *ji;
+    std::vector<Term> key;
+    for (size_t i = 0; i < join.atom->arity(); i++) {
+      const Term& t = join.atom->term(i);
+      if (t.variable() && t != join.parameter) {
+        key.push_back((*args.find(t.as_variable())).second);
+      }
+    }
+    auto oi = join.objects.find(key);
+    if (oi == join.objects.end()) {
+      joined->clear();
+      break;
+    }
+    const std::vector<Object>& objects = (*oi).second;
+    if (ji == pj.joins.begin()) {
+      *joined = objects;
+    } else {
+      // Intersect two lists of objects ordered by rank.
+      std::vector<Object> both;
+      std::vector<Object>::const_iterator i1 = joined->begin();
+      std::vector<Object>::const_iterator i2 = objects.begin();
+      while (i1 != joined->end() && i2 != objects.end()) {
+        size_t r1 = pj.rank.find(*i1)->second;
+        size_t r2 = pj.rank.find(*i2)->second;
+        if (r1 < r2) {
+          i1++;
+        } else if (r2 < r1) {
+          i2++;
+        } else {
+          both.push_back(*i1);
+          i1++;
+          i2++;
+        }
+      }
+      joined->swap(both);
+    }
+    if (joined->empty()) {
+      break;
+    }
+  }
+  return joined;
+}
+
+}  // namespace
+
 void ActionSchema::instantiations(std::vector<const GroundAction*>& actions,
-                                  const Problem& problem) const {
+                                  const Problem& problem,
+                                  WorkerPool* pool) const {
   size_t n = parameters().size();
   if (n == 0) {
     const GroundAction* inst_action =
@@ -147,63 +313,155 @@ void ActionSchema::instantiations(std::vector<const GroundAction*>& actions,
       actions.push_back(inst_action);
     }
   } else {
-    std::map<Variable, Term> args;
-    std::vector<const std::vector<Object>*> arguments(n);
-    std::vector<std::vector<Object>::const_iterator> next_arg;
+    std::vector<const std::vector<Object>*> compatible(n);
     for (size_t i = 0; i < n; i++) {
       const Type& t = TermTable::type(parameters()[i]);
-      arguments[i] = &problem.terms().compatible_objects(t);
-      if (arguments[i]->empty()) {
+      compatible[i] = &problem.terms().compatible_objects(t);
+      if (compatible[i]->empty()) {
         return;
       }
-      next_arg.push_back(arguments[i]->begin());
     }
-    std::stack<const Formula*> conds;
-    conds.push(&condition());
-    Formula::register_use(conds.top());
-    for (size_t i = 0; i < n;) {
-      args.insert(std::make_pair(parameters()[i], *next_arg[i]));
-      std::map<Variable, Term> pargs;
-      pargs.insert(std::make_pair(parameters()[i], *next_arg[i]));
-      const Formula& inst_cond = conds.top()->instantiation(pargs, problem);
-      conds.push(&inst_cond);
-      Formula::register_use(conds.top());
-      if (i + 1 == n || inst_cond.contradiction()) {
-        if (!inst_cond.contradiction()) {
-          const GroundAction* inst_action =
-              instantiation(args, problem, inst_cond);
-          if (inst_action != NULL) {
-            actions.push_back(inst_action);
+    // Join each static precondition at the last parameter it mentions, so
+    // that only objects making it true in the initial state are tried.
+    std::vector<ParameterJoins> joins(n);
+    std::vector<const Atom*> static_atoms;
+    CollectStaticAtoms(condition(), &static_atoms);
+    for (std::vector<const Atom*>::const_iterator ai = static_atoms.begin();
+         ai != static_atoms.end(); ai++) {
+      const Atom& atom = **ai;
+      int last = -1;
+      for (size_t i = 0; i < atom.arity() && last >= -1; i++) {
+        const Term& t = atom.term(i);
+        if (t.variable()) {
+          std::vector<Variable>::const_iterator pi = std::find_if(
+              parameters().begin(), parameters().end(),
+              [&t](Variable v) { return t == v; });
+          if (pi == parameters().end()) {
+            last = -2;
+          } else {
+            last = std::max(last, int(pi - parameters().begin()));
+          }
+        }
+      }
+      if (last >= 0) {
+        ParameterJoins& pj = joins[last];
+        if (pj.rank.empty()) {
+          for (size_t i = 0; i < compatible[last]->size(); i++) {
+            pj.rank.insert(std::make_pair((*compatible[last])[i], i));
           }
         }
-        for (int j = i; j >= 0; j--) {
-          Formula::unregister_use(conds.top());
-          conds.pop();
-          args.erase(parameters()[j]);
-          next_arg[j]++;
-          if (next_arg[j] == arguments[j]->end()) {
+        pj.joins.push_back(StaticJoin(atom, parameters()[last]));
+        IndexStaticJoin(problem.init_atoms(), pj.rank, &pj.joins.back());
+      }
+    }
+
+    std::vector<Object> first_joined;
+    const std::vector<Object>* first_args = ParameterObjects(
+        *compatible[0], joins[0], std::map<Variable, Term>(), &first_joined);
+    // Adds the instantiations with the first parameter bound to the given
+    // object to the given list.  The join indices are only read, so this can
+    // run on several threads at once.
+    auto instantiate = [&](size_t first,
+                           std::vector<const GroundAction*>* insts) {
+      std::map<Variable, Term> args;
+      std::vector<const std::vector<Object>*> arguments(n);
+      std::vector<std::vector<Object>> joined(n);
+      std::vector<size_t> next_arg(n);
+      arguments[0] = first_args;
+      next_arg[0] = first;
+      std::stack<const Formula*> conds;
+      conds.push(&condition());
+      Formula::register_use(conds.top());
+      for (size_t i = 0; i < n;) {
+        const Object& arg = (*arguments[i])[next_arg[i]];
+        args.insert(std::make_pair(parameters()[i], arg));
+        std::map<Variable, Term> pargs;
+        pargs.insert(std::make_pair(parameters()[i], arg));
+        const Formula& inst_cond = conds.top()->instantiation(pargs, problem);
+        conds.push(&inst_cond);
+        Formula::register_use(conds.top());
+        bool backtrack = i + 1 == n || inst_cond.contradiction();
+        if (!backtrack) {
+          arguments[i + 1] = ParameterObjects(*compatible[i + 1],
+                                              joins[i + 1], args,
+                                              &joined[i + 1]);
+          next_arg[i + 1] = 0;
+          backtrack = arguments[i + 1]->empty();
+        }
+        if (backtrack) {
+          if (i + 1 == n && !inst_cond.contradiction()) {
+            const GroundAction* inst_action =
+                instantiation(args, problem, inst_cond);
+            if (inst_action != NULL) {
+              insts->push_back(inst_action);
+            }
+          }
+          for (int j = i; j >= 0; j--) {
+            Formula::unregister_use(conds.top());
+            conds.pop();
+            args.erase(parameters()[j]);
             if (j == 0) {
               i = n;
               break;
-            } else {
-              next_arg[j] = arguments[j]->begin();
             }
-          } else {
-            i = j;
-            break;
+            next_arg[j]++;
+            if (next_arg[j] < arguments[j]->size()) {
+              i = j;
+              break;
+            }
           }
+        } else {
+          i++;
         }
-      } else {
-        i++;
+      }
+      while (!conds.empty()) {
+        Formula::unregister_use(conds.top());
+        conds.pop();
+      }
+    };
+    if (pool == NULL) {
+      for (size_t i = 0; i < first_args->size(); i++) {
+        instantiate(i, &actions);
+      }
+    } else {
+      std::vector<std::vector<const GroundAction*>> insts(first_args->size());
+      pool->ParallelFor(first_args->size(),
+                        [&](size_t i) { instantiate(i, &insts[i]); });
+      for (size_t i = 0; i < insts.size(); i++) {
+        actions.insert(actions.end(), insts[i].begin(), insts[i].end());
       }
     }
-    while (!conds.empty()) {
-      Formula::unregister_use(conds.top());
-      conds.pop();
-    }
   }
 }
 
+const GroundAction* ActionSchema::instantiation(
+    const std::vector<Object>& arguments, const Problem& problem) const {
+  size_t n = parameters().size();
+  if (arguments.size() != n) {
+    return NULL;
+  }
+  // Bind one parameter at a time, as instantiations() does, so that the
+  // condition is simplified in the same way.
+  std::map<Variable, Term> args;
+  const Formula* cond = &condition();
+  Formula::register_use(cond);
+  for (size_t i = 0; i < n && !cond->contradiction(); i++) {
+    args.insert(std::make_pair(parameters()[i], arguments[i]));
+    std::map<Variable, Term> pargs;
+    pargs.insert(std::make_pair(parameters()[i], arguments[i]));
+    const Formula* inst_cond = &cond->instantiation(pargs, problem);
+    Formula::register_use(inst_cond);
+    Formula::unregister_use(cond);
+    cond = inst_cond;
+  }
+  const GroundAction* inst_action = NULL;
+  if (n == 0 || !cond->contradiction()) {
+    inst_action = instantiation(args, problem, *cond);
+  }
+  Formula::unregister_use(cond);
+  return inst_action;
+}
+
 const GroundAction* ActionSchema::instantiation(
     const std::map<Variable, Term>& args, const Problem& problem,
     const Formula& condition) const {
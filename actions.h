@@ -22,6 +22,7 @@
 #ifndef ACTIONS_H_
 #define ACTIONS_H_
 
+#include <atomic>
 #include <cstddef>
 #include <iostream>
 #include <string>
@@ -33,6 +34,7 @@
 #include "terms.h"
 
 struct Domain;
+class WorkerPool;
 
 // Abstract action definition.
 class Action {
@@ -88,8 +90,8 @@ class Action {
   Action(const std::string& name, bool durative);
 
  private:
-  // Next action id.
-  static size_t next_id;
+  // Next action id.  Actions may be grounded by several threads at once.
+  static std::atomic<size_t> next_id;
 
   // Unique id for actions.
   size_t id_;
@@ -141,9 +143,15 @@ class ActionSchema : public Action {
   const std::vector<Variable>& parameters() const { return parameters_; }
 
   // Fills the provided action list with all instantiations of this action
-  // schema.
+  // schema.  If pool is not null, instantiations are generated in parallel on
+  // its threads, but are added to the list in the same order.
   void instantiations(std::vector<const GroundAction*>& actions,
-                      const Problem& problem) const;
+                      const Problem& problem, WorkerPool* pool) const;
+
+  // Returns the instantiation of this action schema with the given objects
+  // bound to its parameters, or NULL if the instantiation is inconsistent.
+  const GroundAction* instantiation(const std::vector<Object>& arguments,
+                                    const Problem& problem) const;
 
   // Prints this action on the given stream.
   void print(std::ostream& os) const;
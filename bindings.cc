@@ -22,6 +22,7 @@
 #include <limits.h>
 #include <algorithm>
 #include <limits>
+#include <mutex>
 #include <typeinfo>
 
 #include "debug.h"
@@ -33,20 +34,21 @@
 #include "refcount.h"
 #include "types.h"
 
+#include "src/hash.h"
+
 /* ====================================================================== */
 /* StepVariable */
 
-typedef std::pair<Variable, size_t> StepVariable;
+/* Returns a hash value for the given step variable. */
+size_t StepVariableHash::operator()(const StepVariable& step_var) const {
+  return HashCombine(std::hash<Term>()(step_var.first), step_var.second);
+}
 
 
-/* ====================================================================== */
-/* VariableSet */
-
-/*
- * A set of variables.
- */
-struct VariableSet : public std::set<StepVariable> {
-};
+/* Returns a hash value for the given object. */
+size_t ObjectHash::operator()(const Object& obj) const {
+  return HashCombine(0, std::hash<Term>()(obj));
+}
 
 
 /* ====================================================================== */
@@ -311,38 +313,68 @@ private:
 
 
 /* Returns the varset containing the given object, or 0 if none do. */
-static const Varset* find_varset(const Chain<Varset>* varsets,
+static const Varset* find_varset(const ObjectIndex& objects,
                                  const Object& obj) {
-  for (const Chain<Varset>* vsc = varsets; vsc != 0; vsc = vsc->tail) {
-    const Varset& vs = vsc->head;
-    if (vs.includes(obj)) {
-      return &vs;
-    }
-  }
-  return 0;
+  const Varset* const* vs = objects.find(obj);
+  return (vs != 0) ? *vs : 0;
 }
 
 
 /* Returns the varset containing the given variable, or 0 if none do. */
-static const Varset* find_varset(const Chain<Varset>* varsets,
+static const Varset* find_varset(const VariableIndex& variables,
                                  const Variable& var, size_t step_id) {
-  for (const Chain<Varset>* vsc = varsets; vsc != 0; vsc = vsc->tail) {
-    const Varset& vs = vsc->head;
-    if (vs.includes(var, step_id)) {
-      return &vs;
-    }
-  }
-  return 0;
+  const Varset* const* vs = variables.find(std::make_pair(var, step_id));
+  return (vs != 0) ? *vs : 0;
 }
 
 
 /* Returns the varset containing the given term, or 0 if none do. */
-static const Varset* find_varset(const Chain<Varset>* varsets,
+static const Varset* find_varset(const VariableIndex& variables,
+                                 const ObjectIndex& objects,
                                  const Term& term, size_t step_id) {
   if (term.object()) {
-    return find_varset(varsets, term.as_object());
+    return find_varset(objects, term.as_object());
   } else {
-    return find_varset(varsets, term.as_variable(), step_id);
+    return find_varset(variables, term.as_variable(), step_id);
+  }
+}
+
+
+/* Returns the varset containing the given term, or 0 if none do.  The
+   varsets pushed in front of the indexed varsets are searched first. */
+static const Varset* find_varset(const Chain<Varset>* varsets,
+                                 const Chain<Varset>* indexed,
+                                 const VariableIndex& variables,
+                                 const ObjectIndex& objects,
+                                 const Term& term, size_t step_id) {
+  for (const Chain<Varset>* vsc = varsets; vsc != indexed; vsc = vsc->tail) {
+    const Varset& vs = vsc->head;
+    if (term.object()
+        ? vs.includes(term.as_object())
+        : vs.includes(term.as_variable(), step_id)) {
+      return &vs;
+    }
+  }
+  return find_varset(variables, objects, term, step_id);
+}
+
+
+/* Indexes the varsets pushed in front of the indexed varsets under
+   their constants and codesignated variables, so that each object and
+   variable maps to the first varset that contains it. */
+static void index_varsets(VariableIndex& variables, ObjectIndex& objects,
+                          const Chain<Varset>* varsets,
+                          const Chain<Varset>* indexed) {
+  if (varsets != indexed) {
+    index_varsets(variables, objects, varsets->tail, indexed);
+    const Varset& vs = varsets->head;
+    if (vs.constant() != 0) {
+      objects.set(*vs.constant(), &vs);
+    }
+    for (const Chain<StepVariable>* vc = vs.cd_set();
+         vc != 0; vc = vc->tail) {
+      variables.set(vc->head, &vs);
+    }
   }
 }
 
@@ -392,13 +424,7 @@ struct StepDomain {
   /* Checks if this step domain includes the given object in the given
      column. */
   bool includes(const Object& obj, size_t column) const {
-    for (TupleList::const_iterator ti = domain().tuples().begin();
-         ti != domain().tuples().end(); ti++) {
-      if ((**ti)[column] == obj) {
-        return true;
-      }
-    }
-    return false;
+    return domain().includes(obj, column);
   }
 
   /* Returns the set of objects from the given column. */
@@ -511,36 +537,161 @@ find_step_domain(const Chain<StepDomain>* step_domains,
 /* ====================================================================== */
 /* ActionDomain */
 
+/*
+ * A set of tuple indices, stored as the nonzero words of a bitset
+ * together with their positions.
+ */
+struct TupleBits {
+  /* Positions of the nonzero words. */
+  std::vector<size_t> positions;
+  /* The nonzero words. */
+  std::vector<uint64_t> words;
+
+  /* Adds the given index, which is not below any index in this set. */
+  void add(size_t i) {
+    size_t w = i/64;
+    if (positions.empty() || positions.back() != w) {
+      positions.push_back(w);
+      words.push_back(0);
+    }
+    words.back() |= uint64_t(1) << (i%64);
+  }
+
+  /* Checks if this set shares an index with the given bitset. */
+  bool intersects(const std::vector<uint64_t>& bits) const {
+    for (size_t i = 0; i < words.size(); i++) {
+      if ((bits[positions[i]] & words[i]) != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+
+/*
+ * The tuples of an action, stored one after the other, with a set of
+ * tuple indices for each object in each column.
+ */
+struct ActionDomain::TupleTable {
+  /* Constructs an empty table with the given number of columns. */
+  explicit TupleTable(size_t arity) : arity(arity), columns(arity) {}
+
+  /* Returns the object in the given column of the given tuple. */
+  const Object& at(size_t tuple, size_t column) const {
+    return objects[tuple*arity + column];
+  }
+
+  /* Returns the indices of the tuples with the given object in the
+     given column, or 0 if there are none. */
+  const TupleBits* find(const Object& obj, size_t column) const {
+    std::map<Object, TupleBits>::const_iterator ci = columns[column].find(obj);
+    return (ci != columns[column].end()) ? &(*ci).second : 0;
+  }
+
+  /* Number of columns. */
+  size_t arity;
+  /* Objects of the tuples. */
+  std::vector<Object> objects;
+  /* Indices of the tuples for each object in each column. */
+  std::vector<std::map<Object, TupleBits> > columns;
+};
+
+
+/* Returns the number of set bits in the given bitset. */
+static size_t count_bits(const std::vector<uint64_t>& bits) {
+  size_t n = 0;
+  for (size_t i = 0; i < bits.size(); i++) {
+    n += __builtin_popcountll(bits[i]);
+  }
+  return n;
+}
+
+
 /* Constructs an action domain with a single tuple. */
-ActionDomain::ActionDomain(const std::vector<Object>& tuple) : ref_count_(0) {
+ActionDomain::ActionDomain(const std::vector<Object>& tuple)
+  : table_(new TupleTable(tuple.size())), owner_(0), size_(0),
+    ref_count_(0) {
   add(tuple);
 }
 
+
+/* Constructs a domain with the given tuples of the given domain. */
+ActionDomain::ActionDomain(const ActionDomain& domain,
+                           const std::vector<uint64_t>& tuples, size_t size)
+  : table_(domain.table_),
+    owner_((domain.owner_ != 0) ? domain.owner_ : &domain),
+    tuples_(tuples), size_(size), ref_count_(0) {
+  ActionDomain::register_use(owner_);
+  /* Restricted domains are made during search, so their memory
+     counts as in use by the search. */
+  NodePool::Charge(restricted_bytes());
+}
+
+
 /* Deletes this action domain. */
 ActionDomain::~ActionDomain() {
   for (ProjectionMap::const_iterator pi = projections_.begin();
        pi != projections_.end(); pi++) {
     delete (*pi).second;
   }
+  if (owner_ == 0) {
+    delete table_;
+  } else {
+    ActionDomain::unregister_use(owner_);
+    NodePool::Charge(-restricted_bytes());
+  }
 }
 
 
-/* Adds a tuple to this domain. */
+/* Returns the number of bytes held by this domain if it is a
+   restriction of another domain. */
+long ActionDomain::restricted_bytes() const {
+  return sizeof *this + sizeof(uint64_t)*tuples_.capacity();
+}
+
+
+/* Adds a tuple to this domain, which must not have been restricted
+   yet. */
 void ActionDomain::add(const std::vector<Object>& tuple) {
-  tuples_.push_back(&tuple);
+  size_t i = size_;
+  table_->objects.insert(table_->objects.end(), tuple.begin(), tuple.end());
+  for (size_t c = 0; c < tuple.size(); c++) {
+    table_->columns[c][tuple[c]].add(i);
+  }
+  if (i/64 >= tuples_.size()) {
+    tuples_.push_back(0);
+  }
+  tuples_[i/64] |= uint64_t(1) << (i%64);
+  size_++;
 }
 
+
+/* Checks if this domain includes the given object in the given
+   column. */
+bool ActionDomain::includes(const Object& obj, size_t column) const {
+  const TupleBits* bits = table_->find(obj, column);
+  return bits != 0 && bits->intersects(tuples_);
+}
+
+
 /* Returns the set of names from the given column. */
 const NameSet& ActionDomain::projection(size_t column) const {
+  /* Action domains are shared between plans expanded by different
+     search threads. */
+  static std::mutex projections_mutex;
+  std::lock_guard<std::mutex> lock(projections_mutex);
   ProjectionMap::const_iterator pi = projections_.find(column);
   if (pi != projections_.end()) {
     return *(*pi).second;
   } else {
     NameSet* projection = new NameSet();
-    for (TupleList::const_iterator ti = tuples().begin();
-         ti != tuples().end(); ti++) {
-      const std::vector<Object>& tuple = **ti;
-      projection->insert(tuple[column]);
+    const std::map<Object, TupleBits>& objects = table_->columns[column];
+    for (std::map<Object, TupleBits>::const_iterator oi = objects.begin();
+         oi != objects.end(); oi++) {
+      if ((*oi).second.intersects(tuples_)) {
+        projection->insert(projection->end(), (*oi).first);
+      }
     }
     projections_.insert(std::make_pair(column, projection));
     return *projection;
@@ -558,24 +709,22 @@ const size_t ActionDomain::projection_size(size_t column) const {
    the given object, or 0 if this would leave an empty domain. */
 const ActionDomain* ActionDomain::restrict(const Object& obj,
                                            size_t column) const {
-  ActionDomain* new_domain = 0;
-  for (TupleList::const_iterator ti = tuples().begin();
-       ti != tuples().end(); ti++) {
-    const std::vector<Object>& tuple = **ti;
-    if (tuple[column] == obj) {
-      if (new_domain == 0) {
-        new_domain = new ActionDomain(tuple);
-      } else {
-        new_domain->add(tuple);
-      }
-    }
+  const TupleBits* bits = table_->find(obj, column);
+  if (bits == 0) {
+    return 0;
+  }
+  std::vector<uint64_t> tuples(tuples_.size(), 0);
+  for (size_t i = 0; i < bits->words.size(); i++) {
+    size_t w = bits->positions[i];
+    tuples[w] = tuples_[w] & bits->words[i];
   }
-  if (new_domain != 0 && new_domain->size() == size()) {
-    ActionDomain::register_use(new_domain);
-    ActionDomain::unregister_use(new_domain);
+  size_t n = count_bits(tuples);
+  if (n == 0) {
+    return 0;
+  } else if (n == size()) {
     return this;
   } else {
-    return new_domain;
+    return new ActionDomain(*this, tuples, n);
   }
 }
 
@@ -585,24 +734,25 @@ const ActionDomain* ActionDomain::restrict(const Object& obj,
    domain. */
 const ActionDomain* ActionDomain::restrict(const NameSet& names,
                                            size_t column) const {
-  ActionDomain* new_domain = 0;
-  for (TupleList::const_iterator ti = tuples().begin();
-       ti != tuples().end(); ti++) {
-    const std::vector<Object>& tuple = **ti;
-    if (names.find(tuple[column]) != names.end()) {
-      if (new_domain == 0) {
-        new_domain = new ActionDomain(tuple);
-      } else {
-        new_domain->add(tuple);
+  std::vector<uint64_t> tuples(tuples_.size(), 0);
+  for (NameSet::const_iterator ni = names.begin(); ni != names.end(); ni++) {
+    const TupleBits* bits = table_->find(*ni, column);
+    if (bits != 0) {
+      for (size_t i = 0; i < bits->words.size(); i++) {
+        tuples[bits->positions[i]] |= bits->words[i];
       }
     }
   }
-  if (new_domain != 0 && new_domain->size() == size()) {
-    ActionDomain::register_use(new_domain);
-    ActionDomain::unregister_use(new_domain);
+  for (size_t w = 0; w < tuples.size(); w++) {
+    tuples[w] &= tuples_[w];
+  }
+  size_t n = count_bits(tuples);
+  if (n == 0) {
+    return 0;
+  } else if (n == size()) {
     return this;
   } else {
-    return new_domain;
+    return new ActionDomain(*this, tuples, n);
   }
 }
 
@@ -611,46 +761,53 @@ const ActionDomain* ActionDomain::restrict(const NameSet& names,
    or 0 if this would leave an empty domain. */
 const ActionDomain* ActionDomain::exclude(const Object& obj,
                                           size_t column) const {
-  ActionDomain* new_domain = 0;
-  for (TupleList::const_iterator ti = tuples().begin();
-       ti != tuples().end(); ti++) {
-    const std::vector<Object>& tuple = **ti;
-    if (tuple[column] != obj) {
-      if (new_domain == 0) {
-        new_domain = new ActionDomain(tuple);
-      } else {
-        new_domain->add(tuple);
-      }
-    }
+  const TupleBits* bits = table_->find(obj, column);
+  if (bits == 0) {
+    return this;
+  }
+  std::vector<uint64_t> tuples(tuples_);
+  for (size_t i = 0; i < bits->words.size(); i++) {
+    tuples[bits->positions[i]] &= ~bits->words[i];
   }
-  if (new_domain != 0 && new_domain->size() == size()) {
-    ActionDomain::register_use(new_domain);
-    ActionDomain::unregister_use(new_domain);
+  size_t n = count_bits(tuples);
+  if (n == 0) {
+    return 0;
+  } else if (n == size()) {
     return this;
   } else {
-    return new_domain;
+    return new ActionDomain(*this, tuples, n);
   }
 }
 
 
+/* Appends to the given key the tuples of this domain. */
+void ActionDomain::key(std::vector<uint64_t>& key) const {
+  key.push_back(reinterpret_cast<uintptr_t>(table_));
+  key.push_back(tuples_.size());
+  key.insert(key.end(), tuples_.begin(), tuples_.end());
+}
+
+
 /* Prints this object on the given stream. */
 void ActionDomain::print(std::ostream& os) const {
   os << '{';
-  for (TupleList::const_iterator ti = tuples().begin();
-       ti != tuples().end(); ti++) {
-    if (ti != tuples().begin()) {
-      os << ' ';
-    }
-    os << '<';
-    const std::vector<Object>& tuple = **ti;
-    for (std::vector<Object>::const_iterator ni = tuple.begin();
-         ni != tuple.end(); ni++) {
-      if (ni != tuple.begin()) {
+  bool first = true;
+  for (size_t w = 0; w < tuples_.size(); w++) {
+    for (uint64_t bits = tuples_[w]; bits != 0; bits &= bits - 1) {
+      size_t t = w*64 + __builtin_ctzll(bits);
+      if (!first) {
         os << ' ';
       }
-      os << *ni;
+      first = false;
+      os << '<';
+      for (size_t c = 0; c < table_->arity; c++) {
+        if (c > 0) {
+          os << ' ';
+        }
+        os << table_->at(t, c);
+      }
+      os << '>';
     }
-    os << '>';
   }
   os << '}';
 }
@@ -681,15 +838,16 @@ bool Bindings::unifiable(BindingList& mgu,
 
 /* Constructs an empty binding collection. */
 Bindings::Bindings()
-  : varsets_(0), high_step_(0), step_domains_(0), ref_count_(1) {
+  : varsets_(0), step_domains_(0), ref_count_(1) {
 }
 
 
 /* Constructs a binding collection. */
-Bindings::Bindings(const Chain<Varset>* varsets, size_t high_step,
+Bindings::Bindings(const Chain<Varset>* varsets,
+                   const VariableIndex& variables, const ObjectIndex& objects,
                    const Chain<StepDomain>* step_domains)
-  : varsets_(varsets), high_step_(high_step), step_domains_(step_domains),
-    ref_count_(0) {
+  : varsets_(varsets), variables_(variables), objects_(objects),
+    step_domains_(step_domains), ref_count_(0) {
   RCObject::ref(varsets_);
   RCObject::ref(step_domains_);
 }
@@ -706,9 +864,7 @@ Bindings::~Bindings() {
      not bound to a single object. */
 Term Bindings::binding(const Term& term, size_t step_id) const {
   if (term.variable()) {
-    const Varset* vs =
-      ((step_id <= high_step_)
-       ? find_varset(varsets_, term.as_variable(), step_id) : 0);
+    const Varset* vs = find_varset(variables_, term.as_variable(), step_id);
     if (vs != 0 && vs->constant() != 0) {
       return *vs->constant();
     }
@@ -729,14 +885,12 @@ const NameSet& Bindings::domain(const Variable& var, size_t step_id,
         problem.terms().compatible_objects(TermTable::type(var));
     NameSet* names = new NameSet();
     names->insert(objects.begin(), objects.end());
-    const Varset* vs =
-      (step_id <= high_step_) ? find_varset(varsets_, var, step_id) : 0;
+    const Varset* vs = find_varset(variables_, var, step_id);
     if (vs != 0) {
       for (const Chain<StepVariable>* vc = vs->ncd_set();
            vc != 0; vc = vc->tail) {
         const StepVariable& sv = vc->head;
-        const Varset* vs2 = ((sv.second <= high_step_)
-                             ? find_varset(varsets_, sv.first, sv.second) : 0);
+        const Varset* vs2 = find_varset(variables_, sv.first, sv.second);
         if (vs2 != 0 && vs2->constant() != 0) {
           names->erase(*vs2->constant());
         }
@@ -910,8 +1064,7 @@ bool Bindings::unify(BindingList& mgu, const Literal& l1, size_t id1,
 bool Bindings::consistent_with(const Equality& eq, size_t step_id) const {
   size_t var_id = eq.step_id1(step_id);
   size_t term_id = eq.step_id2(step_id);
-  const Varset* vs =
-    (term_id <= high_step_) ? find_varset(varsets_, eq.term(), term_id) : 0;
+  const Varset* vs = find_varset(variables_, objects_, eq.term(), term_id);
   if (vs == 0 || vs->includes(eq.variable(), var_id)) {
     return true;
   } else if (vs->excludes(eq.variable(), var_id)) {
@@ -932,8 +1085,7 @@ bool Bindings::consistent_with(const Equality& eq, size_t step_id) const {
 bool Bindings::consistent_with(const Inequality& neq, size_t step_id) const {
   size_t var_id = neq.step_id1(step_id);
   size_t term_id = neq.step_id2(step_id);
-  const Varset* vs =
-    (term_id <= high_step_) ? find_varset(varsets_, neq.term(), term_id) : 0;
+  const Varset* vs = find_varset(variables_, objects_, neq.term(), term_id);
   return (vs == 0
           || !vs->includes(neq.variable(), var_id)
           || vs->excludes(neq.variable(), var_id));
@@ -966,12 +1118,9 @@ const Bindings* Bindings::add(const BindingList& new_bindings,
     return this;
   }
 
-  /* Varsets for new binding collection */
+  /* Varsets for new binding collection; the ones in front of
+     varsets_ are not indexed yet. */
   const Chain<Varset>* varsets = varsets_;
-  /* Highest step id of variable in varsets. */
-  size_t high_step = high_step_;
-  /* Variables above previous high step. */
-  VariableSet high_step_vars;
   /* Step domains for new binding collection */
   const Chain<StepDomain>* step_domains = step_domains_;
 
@@ -991,35 +1140,11 @@ const Bindings* Bindings::add(const BindingList& new_bindings,
        * Adding equality binding.
        */
       /* Varset for variable. */
-      const Varset* vs1;
-      StepVariable sv(bind.var(), bind.var_id());
-      if (bind.var_id() <= high_step_
-          || high_step_vars.find(sv) != high_step_vars.end()) {
-        vs1 = find_varset(varsets, bind.var(), bind.var_id());
-      } else {
-        if (bind.var_id() > high_step) {
-          high_step = bind.var_id();
-        }
-        high_step_vars.insert(sv);
-        vs1 = 0;
-      }
+      const Varset* vs1 = find_varset(varsets, varsets_, variables_, objects_,
+                                      bind.var(), bind.var_id());
       /* Varset for term. */
-      const Varset* vs2;
-      if (bind.term().object()) {
-        vs2 = find_varset(varsets, bind.term().as_object());
-      } else {
-        StepVariable sv(bind.term().as_variable(), bind.term_id());
-        if (bind.term_id() <= high_step_
-            || high_step_vars.find(sv) != high_step_vars.end()) {
-          vs2 = find_varset(varsets, sv.first, bind.term_id());
-        } else {
-          if (bind.term_id() > high_step) {
-            high_step = bind.term_id();
-          }
-          high_step_vars.insert(sv);
-          vs2 = 0;
-        }
-      }
+      const Varset* vs2 = find_varset(varsets, varsets_, variables_, objects_,
+                                      bind.term(), bind.term_id());
       /* Combined varset, or 0 if binding is inconsistent with
          current bindings. */
       const Varset* comb;
@@ -1192,35 +1317,11 @@ const Bindings* Bindings::add(const BindingList& new_bindings,
        * Adding inequality binding.
        */
       /* Varset for variable. */
-      const Varset* vs1;
-      StepVariable sv(bind.var(), bind.var_id());
-      if (bind.var_id() <= high_step_
-          || high_step_vars.find(sv) != high_step_vars.end()) {
-        vs1 = find_varset(varsets, bind.var(), bind.var_id());
-      } else {
-        if (bind.var_id() > high_step) {
-          high_step = bind.var_id();
-        }
-        high_step_vars.insert(sv);
-        vs1 = 0;
-      }
+      const Varset* vs1 = find_varset(varsets, varsets_, variables_, objects_,
+                                      bind.var(), bind.var_id());
       /* Varset for term. */
-      const Varset* vs2;
-      if (bind.term().object()) {
-        vs2 = find_varset(varsets, bind.term().as_object());
-      } else {
-        StepVariable sv(bind.term().as_variable(), bind.term_id());
-        if (bind.term_id() <= high_step_
-            || high_step_vars.find(sv) != high_step_vars.end()) {
-          vs2 = find_varset(varsets, sv.first, bind.term_id());
-        } else {
-          if (bind.term_id() > high_step) {
-            high_step = bind.term_id();
-          }
-          high_step_vars.insert(sv);
-          vs2 = 0;
-        }
-      }
+      const Varset* vs2 = find_varset(varsets, varsets_, variables_, objects_,
+                                      bind.term(), bind.term_id());
       if (vs1 != 0 && vs2 != 0 && vs1 == vs2) {
         /* The terms are already bound to eachother. */
         RCObject::ref(varsets);
@@ -1323,15 +1424,17 @@ const Bindings* Bindings::add(const BindingList& new_bindings,
   }
   /* New bindings are consistent with the current bindings. */
   if (test_only
-      || (varsets == varsets_ && high_step == high_step_
-          && step_domains == step_domains_)) {
+      || (varsets == varsets_ && step_domains == step_domains_)) {
     RCObject::ref(varsets);
     RCObject::destructive_deref(varsets);
     RCObject::ref(step_domains);
     RCObject::destructive_deref(step_domains);
     return this;
   } else {
-    return new Bindings(varsets, high_step, step_domains);
+    VariableIndex variables(variables_);
+    ObjectIndex objects(objects_);
+    index_varsets(variables, objects, varsets, varsets_);
+    return new Bindings(varsets, variables, objects, step_domains);
   }
 }
 
@@ -1353,7 +1456,6 @@ const Bindings* Bindings::add(size_t step_id, const Action& step_action,
     new Chain<StepDomain>(StepDomain(step_id, action->parameters(), *domain),
                           step_domains_);
   const Chain<Varset>* varsets = varsets_;
-  size_t high_step = high_step_;
   const StepDomain& step_domain = step_domains->head;
   for (size_t c = 0; c < step_domain.parameters().size(); c++) {
     if (step_domain.projection_size(c) == 1) {
@@ -1365,21 +1467,98 @@ const Bindings* Bindings::add(size_t step_id, const Action& step_action,
       varsets = new Chain<Varset>(Varset(&*step_domain.projection(c).begin(),
                                          cd_set, 0, type),
                                   varsets);
-      if (step_id > high_step) {
-        high_step = step_id;
-      }
     }
   }
   if (test_only
-      || (varsets == varsets_ && high_step == high_step_
-          && step_domains == step_domains_)) {
+      || (varsets == varsets_ && step_domains == step_domains_)) {
     RCObject::ref(varsets);
     RCObject::destructive_deref(varsets);
     RCObject::ref(step_domains);
     RCObject::destructive_deref(step_domains);
     return this;
   } else {
-    return new Bindings(varsets, high_step, step_domains);
+    VariableIndex variables(variables_);
+    ObjectIndex objects(objects_);
+    index_varsets(variables, objects, varsets, varsets_);
+    return new Bindings(varsets, variables, objects, step_domains);
+  }
+}
+
+
+/* Returns the given step id renamed by the given map. */
+static size_t renamed(const std::vector<size_t>& step_ids, size_t id) {
+  return (id < step_ids.size()) ? step_ids[id] : id;
+}
+
+
+/* Appends to the given key the given step variables, with step ids
+   renamed by the given map, in a canonical order. */
+static void append_step_vars(std::vector<uint64_t>& key,
+                             const Chain<StepVariable>* step_vars,
+                             const std::vector<size_t>& step_ids) {
+  std::vector<std::pair<uint64_t, uint64_t> > vars;
+  for (const Chain<StepVariable>* vc = step_vars; vc != 0; vc = vc->tail) {
+    vars.push_back(std::make_pair(
+        static_cast<uint32_t>(Term(vc->head.first).index()),
+        renamed(step_ids, vc->head.second)));
+  }
+  std::sort(vars.begin(), vars.end());
+  key.push_back(vars.size());
+  for (size_t i = 0; i < vars.size(); i++) {
+    key.push_back(vars[i].first);
+    key.push_back(vars[i].second);
+  }
+}
+
+
+/* Appends to the given key the codesignation, non-codesignation and
+   step domain constraints of this binding collection, with step ids
+   renamed by the given map. */
+void Bindings::key(std::vector<uint64_t>& key,
+                   const std::vector<size_t>& step_ids) const {
+  /* Varsets and step domains are replaced by pushing new ones in
+     front of them, so only the first varset containing a term and the
+     first domain for a step are in effect. */
+  std::set<StepVariable> seen_vars;
+  std::set<Object> seen_objs;
+  std::vector<std::vector<uint64_t> > varsets;
+  for (const Chain<Varset>* vsc = varsets_; vsc != 0; vsc = vsc->tail) {
+    const Varset& vs = vsc->head;
+    bool seen = (vs.constant() != 0
+                 && !seen_objs.insert(*vs.constant()).second);
+    for (const Chain<StepVariable>* vc = vs.cd_set(); vc != 0; vc = vc->tail) {
+      if (!seen_vars.insert(vc->head).second) {
+        seen = true;
+      }
+    }
+    if (seen) {
+      continue;
+    }
+    varsets.push_back(std::vector<uint64_t>());
+    std::vector<uint64_t>& varset = varsets.back();
+    varset.push_back((vs.constant() != 0)
+                     ? Term(*vs.constant()).index() + uint64_t{1} : 0);
+    append_step_vars(varset, vs.cd_set(), step_ids);
+    append_step_vars(varset, vs.ncd_set(), step_ids);
+  }
+  std::set<size_t> seen_steps;
+  std::vector<std::vector<uint64_t> > step_domains;
+  for (const Chain<StepDomain>* sd = step_domains_; sd != 0; sd = sd->tail) {
+    if (seen_steps.insert(sd->head.id()).second) {
+      step_domains.push_back(
+          std::vector<uint64_t>(1, renamed(step_ids, sd->head.id())));
+      sd->head.domain().key(step_domains.back());
+    }
+  }
+  std::sort(varsets.begin(), varsets.end());
+  std::sort(step_domains.begin(), step_domains.end());
+  key.push_back(varsets.size());
+  for (size_t i = 0; i < varsets.size(); i++) {
+    key.insert(key.end(), varsets[i].begin(), varsets[i].end());
+  }
+  key.push_back(step_domains.size());
+  for (size_t i = 0; i < step_domains.size(); i++) {
+    key.insert(key.end(), step_domains[i].begin(), step_domains[i].end());
   }
 }
 
@@ -22,11 +22,19 @@
 #ifndef BINDINGS_H
 #define BINDINGS_H
 
+#include <atomic>
+#include <cstdint>
+#include <map>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "chain.h"
 #include "terms.h"
 
+#include "src/node-pool.h"
+#include "src/persistent-map.h"
+
 struct Literal;
 struct Equality;
 struct Inequality;
@@ -103,33 +111,26 @@ struct NameSet : public std::set<Object> {
 };
 
 
-/* ====================================================================== */
-/* TupleList */
-
-/*
- * A list of parameter tuples.
- */
-struct TupleList : public std::vector<const std::vector<Object>*> {};
-
 /* ====================================================================== */
 /* ActionDomain */
 
 /*
- * Domain for action parameters.
+ * Domain for action parameters.  The tuples of an action are stored
+ * once, column by column, and a domain is the set of indices of the
+ * tuples it contains.
  */
 struct ActionDomain {
   /* Register use of this object. */
   static void register_use(const ActionDomain* a) {
     if (a != 0) {
-      a->ref_count_++;
+      a->ref_count_.fetch_add(1, std::memory_order_relaxed);
     }
   }
 
   /* Unregister use of this object. */
   static void unregister_use(const ActionDomain* a) {
     if (a != 0) {
-      a->ref_count_--;
-      if (a->ref_count_ == 0) {
+      if (a->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
         delete a;
       }
     }
@@ -142,14 +143,16 @@ struct ActionDomain {
   ~ActionDomain();
 
   /* Number of tuples. */
-  size_t size() const { return tuples().size(); }
-
-  /* Returns the tuples of this action domain. */
-  const TupleList& tuples() const { return tuples_; }
+  size_t size() const { return size_; }
 
-  /* Adds a tuple to this domain. */
+  /* Adds a tuple to this domain, which must not have been restricted
+     yet. */
   void add(const std::vector<Object>& tuple);
 
+  /* Checks if this domain includes the given object in the given
+     column. */
+  bool includes(const Object& obj, size_t column) const;
+
   /* Returns the set of names from the given column. */
   const NameSet& projection(size_t column) const;
 
@@ -169,20 +172,40 @@ struct ActionDomain {
      or 0 if this would leave an empty domain. */
   const ActionDomain* exclude(const Object& obj, size_t column) const;
 
+  /* Appends to the given key the tuples of this domain. */
+  void key(std::vector<uint64_t>& key) const;
+
   /* Prints this object on the given stream. */
   void print(std::ostream& os) const;
 
 private:
+  /* The tuples of an action. */
+  struct TupleTable;
+
   /* A projection map. */
   struct ProjectionMap : public std::map<size_t, const NameSet*> {
   };
 
-  /* Possible parameter tuples. */
-  TupleList tuples_;
+  /* Returns the number of bytes held by this domain if it is a
+     restriction of another domain. */
+  long restricted_bytes() const;
+
+  /* Tuples that this domain selects from. */
+  TupleTable* table_;
+  /* Domain owning the tuple table, or 0 if this domain owns it. */
+  const ActionDomain* owner_;
+  /* Bits for the indices of the tuples in this domain. */
+  std::vector<uint64_t> tuples_;
+  /* Number of tuples in this domain. */
+  size_t size_;
   /* Projections. */
   mutable ProjectionMap projections_;
   /* Reference counter. */
-  mutable size_t ref_count_;
+  mutable std::atomic<size_t> ref_count_;
+
+  /* Constructs a domain with the given tuples of the given domain. */
+  ActionDomain(const ActionDomain& domain, const std::vector<uint64_t>& tuples,
+               size_t size);
 };
 
 
@@ -192,25 +215,45 @@ private:
 struct Varset;
 struct StepDomain;
 
+/* A variable of a step. */
+typedef std::pair<Variable, size_t> StepVariable;
+
+/* Hash function object for step variables. */
+struct StepVariableHash {
+  size_t operator()(const StepVariable& step_var) const;
+};
+
+/* Hash function object for objects. */
+struct ObjectHash {
+  size_t operator()(const Object& obj) const;
+};
+
+/* Index from variables to the varsets that codesignate them. */
+typedef PersistentMap<StepVariable, const Varset*, StepVariableHash>
+VariableIndex;
+
+/* Index from objects to the varsets that hold them. */
+typedef PersistentMap<Object, const Varset*, ObjectHash> ObjectIndex;
+
 /*
- * A collection of variable bindings.
+ * A collection of variable bindings.  Bindings come from the node
+ * pool, like the chains and index nodes that they are made of.
  */
-struct Bindings {
+struct Bindings : public PooledObject {
   /* Empty bindings. */
   static const Bindings EMPTY;
 
   /* Register use of this object. */
   static void register_use(const Bindings* b) {
     if (b != 0) {
-      b->ref_count_++;
+      b->ref_count_.fetch_add(1, std::memory_order_relaxed);
     }
   }
 
   /* Unregister use of this object. */
   static void unregister_use(const Bindings* b) {
     if (b != 0) {
-      b->ref_count_--;
-      if (b->ref_count_ == 0) {
+      if (b->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
         delete b;
       }
     }
@@ -277,6 +320,14 @@ struct Bindings {
   const Bindings* add(size_t step_id, const Action& step_action,
                       const PlanningGraph& pg, bool test_only = false) const;
 
+  /* Appends to the given key the codesignation, non-codesignation
+     and step domain constraints of this binding collection, with each
+     step id renamed to the id at that index of the given map, or left
+     unchanged if it is outside of the map.  Collections with the same
+     constraints after renaming append the same values. */
+  void key(std::vector<uint64_t>& key,
+           const std::vector<size_t>& step_ids) const;
+
   /* Prints this object on the given stream. */
   void print(std::ostream& os) const;
 
@@ -284,21 +335,24 @@ struct Bindings {
   void print_term(std::ostream& os, const Term& term, size_t step_id) const;
 
 private:
-  /* Varsets representing the transitive closure of the bindings. */
+  /* Varsets representing the transitive closure of the bindings.  A
+     varset replaces earlier ones by being pushed in front of them. */
   const Chain<Varset>* varsets_;
-  /* Highest step id of variable in varsets. */
-  size_t high_step_;
+  /* The varset in effect for each codesignated variable. */
+  VariableIndex variables_;
+  /* The varset in effect for each object. */
+  ObjectIndex objects_;
   /* Step domains. */
   const Chain<StepDomain>* step_domains_;
   /* Reference counter. */
-  mutable size_t ref_count_;
+  mutable std::atomic<size_t> ref_count_;
 
   /* Constructs an empty binding collection. */
   Bindings();
 
   /* Constructs a binding collection. */
-  Bindings(const Chain<Varset>* varsets, size_t high_step,
-           const Chain<StepDomain>* step_domains);
+  Bindings(const Chain<Varset>* varsets, const VariableIndex& variables,
+           const ObjectIndex& objects, const Chain<StepDomain>* step_domains);
 };
 
 
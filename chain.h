@@ -23,10 +23,11 @@
 #define CHAIN_H_
 
 #include "refcount.h"
+#include "src/node-pool.h"
 
-// Template chain class.
+// Template chain class.  Chain nodes are allocated from the node pool.
 template <typename T>
-class Chain : public RCObject {
+class Chain : public RCObject, public PooledObject {
  public:
   // The data at this location in the chain.
   T head;
@@ -18,6 +18,8 @@
 // Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 
 #include "expressions.h"
+#include <algorithm>
+#include <mutex>
 #include <stdexcept>
 
 
@@ -60,6 +62,9 @@ Fluent::FluentTable Fluent::fluents;
 /* Next id for ground fluents. */
 size_t Fluent::next_id = 1;
 
+/* Mutex protecting the table of fluents and the next id. */
+static std::mutex fluent_table_mutex;
+
 
 /* Comparison function. */
 bool Fluent::FluentLess::operator()(const Fluent* f1, const Fluent* f2) const {
@@ -89,23 +94,78 @@ const Fluent& Fluent::make(const Function& function,
     fluent->assign_id(ground);
     return *fluent;
   } else {
+    std::unique_lock<std::mutex> lock(fluent_table_mutex);
     std::pair<FluentTable::const_iterator, bool> result =
       fluents.insert(fluent);
     if (!result.second) {
+      const Fluent& old_fluent = **result.first;
+      lock.unlock();
       delete fluent;
-      return **result.first;
+      return old_fluent;
     } else {
       fluent->assign_id(ground);
+      /* The table holds a reference to each ground fluent, so a
+         fluent found in the table can never be deleted by another
+         thread. */
+      ref(fluent);
       return *fluent;
     }
   }
 }
 
+
+/* Releases the ground fluents held by the table of fluents. */
+void Fluent::clear() {
+  FluentTable old_fluents;
+  {
+    std::lock_guard<std::mutex> lock(fluent_table_mutex);
+    old_fluents.swap(fluents);
+  }
+  for (FluentTable::const_iterator fi = old_fluents.begin();
+       fi != old_fluents.end(); fi++) {
+    destructive_deref(*fi);
+  }
+}
+
+
+/* Releases the ground fluents that are referenced only by the table
+   of fluents, so that new ground fluents can reuse their ids. */
+void Fluent::release_unused() {
+  std::vector<const Fluent*> unused_fluents;
+  {
+    std::lock_guard<std::mutex> lock(fluent_table_mutex);
+    for (FluentTable::const_iterator fi = fluents.begin();
+         fi != fluents.end(); ) {
+      if ((*fi)->ref_count() == 1) {
+        unused_fluents.push_back(*fi);
+        fi = fluents.erase(fi);
+      } else {
+        fi++;
+      }
+    }
+  }
+  for (std::vector<const Fluent*>::const_iterator fi = unused_fluents.begin();
+       fi != unused_fluents.end(); fi++) {
+    destructive_deref(*fi);
+  }
+  std::lock_guard<std::mutex> lock(fluent_table_mutex);
+  size_t max_id = 0;
+  for (FluentTable::const_iterator fi = fluents.begin();
+       fi != fluents.end(); fi++) {
+    max_id = std::max(max_id, (*fi)->id());
+  }
+  next_id = max_id + 1;
+}
+
+
 /* Deletes this fluent. */
 Fluent::~Fluent() {
-  FluentTable::const_iterator fi = fluents.find(this);
-  if (*fi == this) {
-    fluents.erase(fi);
+  if (id() > 0) {
+    std::lock_guard<std::mutex> lock(fluent_table_mutex);
+    FluentTable::const_iterator fi = fluents.find(this);
+    if (fi != fluents.end() && *fi == this) {
+      fluents.erase(fi);
+    }
   }
 }
 
@@ -98,6 +98,14 @@ struct Fluent : public Expression {
   static const Fluent& make(const Function& function,
                             const std::vector<Term>& terms);
 
+  /* Releases the ground fluents held by the table of fluents. */
+  static void clear();
+
+  /* Releases the ground fluents that are referenced only by the table
+     of fluents, so that new ground fluents can reuse their ids.  Must
+     not be called while other threads use ground fluents. */
+  static void release_unused();
+
   /* Deletes this fluent. */
   virtual ~Fluent();
 
@@ -19,7 +19,9 @@
 
 #include "formulas.h"
 
+#include <algorithm>
 #include <iostream>
+#include <mutex>
 #include <stack>
 
 #include "bindings.h"
@@ -208,6 +210,9 @@ const Formula& Constant::negation() const {
 /* Next id for ground literals. */
 size_t Literal::next_id = 1;
 
+/* Mutex protecting the tables of ground literals and the next id. */
+static std::mutex literal_table_mutex;
+
 
 /* Assigns an id to this literal. */
 void Literal::assign_id(bool ground) {
@@ -219,6 +224,63 @@ void Literal::assign_id(bool ground) {
 }
 
 
+/* Releases the ground literals that are referenced only by the
+   tables of ground literals, so that new ground literals can reuse
+   their ids. */
+void Literal::release_unused() {
+  /* Negations are released first, since each holds a reference to
+     its atom. */
+  std::vector<const Negation*> unused_negations;
+  {
+    std::lock_guard<std::mutex> lock(literal_table_mutex);
+    for (Negation::NegationTable::const_iterator ni =
+             Negation::negations.begin();
+         ni != Negation::negations.end(); ) {
+      if ((*ni)->ref_count() == 1) {
+        unused_negations.push_back(*ni);
+        ni = Negation::negations.erase(ni);
+      } else {
+        ni++;
+      }
+    }
+  }
+  for (std::vector<const Negation*>::const_iterator ni =
+           unused_negations.begin();
+       ni != unused_negations.end(); ni++) {
+    unregister_use(*ni);
+  }
+  std::vector<const Atom*> unused_atoms;
+  {
+    std::lock_guard<std::mutex> lock(literal_table_mutex);
+    for (Atom::AtomTable::const_iterator ai = Atom::atoms.begin();
+         ai != Atom::atoms.end(); ) {
+      if ((*ai)->ref_count() == 1) {
+        unused_atoms.push_back(*ai);
+        ai = Atom::atoms.erase(ai);
+      } else {
+        ai++;
+      }
+    }
+  }
+  for (std::vector<const Atom*>::const_iterator ai = unused_atoms.begin();
+       ai != unused_atoms.end(); ai++) {
+    unregister_use(*ai);
+  }
+  std::lock_guard<std::mutex> lock(literal_table_mutex);
+  size_t max_id = 0;
+  for (Atom::AtomTable::const_iterator ai = Atom::atoms.begin();
+       ai != Atom::atoms.end(); ai++) {
+    max_id = std::max(max_id, (*ai)->id());
+  }
+  for (Negation::NegationTable::const_iterator ni =
+           Negation::negations.begin();
+       ni != Negation::negations.end(); ni++) {
+    max_id = std::max(max_id, (*ni)->id());
+  }
+  next_id = max_id + 1;
+}
+
+
 /* Returns a formula that separates the given effect from anything
    definitely asserted by this formula. */
 const Formula& Literal::separator(const Effect& effect,
@@ -290,34 +352,30 @@ static bool unifiable_atoms(const Atom& a1, const Atom& a2) {
 Atom::AtomTable Atom::atoms;
 
 
-/* Comparison function. */
-bool Atom::AtomLess::operator()(const Atom* a1, const Atom* a2) const {
-  if (a1->predicate() < a2->predicate()) {
-    return true;
-  } else if (a2->predicate() < a1->predicate()) {
-    return false;
-  } else {
-    for (size_t i = 0; i < a1->arity(); i++) {
-      if (a1->term(i) < a2->term(i)) {
-        return true;
-      } else if (a2->term(i) < a1->term(i)) {
-        return false;
-      }
-    }
-    return false;
+/* Hash function. */
+size_t Atom::AtomHash::operator()(const Atom* a) const {
+  size_t h = a->predicate().index();
+  for (size_t i = 0; i < a->arity(); i++) {
+    h = 31*h + std::hash<Term>()(a->term(i));
   }
+  return h;
+}
+
+
+/* Equality function. */
+bool Atom::AtomEqual::operator()(const Atom* a1, const Atom* a2) const {
+  return a1->predicate() == a2->predicate() && a1->terms_ == a2->terms_;
 }
 
 
 /* Returns an atomic state formula with the given predicate and terms. */
 const Atom& Atom::make(const Predicate& predicate,
                        const std::vector<Term>& terms) {
-  Atom* atom = new Atom(predicate);
+  Atom* atom = new Atom(predicate, terms);
   bool ground = true;
-  for (std::vector<Term>::const_iterator ti = terms.begin(); ti != terms.end();
-       ti++) {
-    atom->add_term(*ti);
-    if (ground && (*ti).variable()) {
+  for (std::vector<Term>::const_iterator ti = terms.begin();
+       ground && ti != terms.end(); ti++) {
+    if ((*ti).variable()) {
       ground = false;
     }
   }
@@ -325,22 +383,46 @@ const Atom& Atom::make(const Predicate& predicate,
     atom->assign_id(ground);
     return *atom;
   } else {
+    std::unique_lock<std::mutex> lock(literal_table_mutex);
     std::pair<AtomTable::const_iterator, bool> result = atoms.insert(atom);
     if (!result.second) {
+      const Atom& old_atom = **result.first;
+      lock.unlock();
       delete atom;
-      return **result.first;
+      return old_atom;
     } else {
       atom->assign_id(ground);
+      /* The table holds a reference to each ground atom, so an atom
+         found in the table can never be deleted by another thread. */
+      register_use(atom);
       return *atom;
     }
   }
 }
 
+
+/* Releases the ground atoms held by the table of atomic formulas. */
+void Atom::clear() {
+  AtomTable old_atoms;
+  {
+    std::lock_guard<std::mutex> lock(literal_table_mutex);
+    old_atoms.swap(atoms);
+  }
+  for (AtomTable::const_iterator ai = old_atoms.begin();
+       ai != old_atoms.end(); ai++) {
+    unregister_use(*ai);
+  }
+}
+
+
 /* Deletes this atomic formula. */
 Atom::~Atom() {
-  AtomTable::const_iterator ai = atoms.find(this);
-  if (*ai == this) {
-    atoms.erase(ai);
+  if (id() > 0) {
+    std::lock_guard<std::mutex> lock(literal_table_mutex);
+    AtomTable::const_iterator ai = atoms.find(this);
+    if (ai != atoms.end() && *ai == this) {
+      atoms.erase(ai);
+    }
   }
 }
 
@@ -452,10 +534,16 @@ const Literal& Atom::negation() const {
 Negation::NegationTable Negation::negations;
 
 
-/* Comparison function. */
-bool Negation::NegationLess::operator()(const Negation* n1,
-                                        const Negation* n2) const {
-  return &n1->atom() < &n2->atom();
+/* Hash function. */
+size_t Negation::NegationHash::operator()(const Negation* n) const {
+  return std::hash<const Atom*>()(&n->atom());
+}
+
+
+/* Equality function. */
+bool Negation::NegationEqual::operator()(const Negation* n1,
+                                         const Negation* n2) const {
+  return &n1->atom() == &n2->atom();
 }
 
 
@@ -467,19 +555,39 @@ const Negation& Negation::make(const Atom& atom) {
     negation->assign_id(ground);
     return *negation;
   } else {
+    std::unique_lock<std::mutex> lock(literal_table_mutex);
     std::pair<NegationTable::const_iterator, bool> result =
       negations.insert(negation);
     if (!result.second) {
+      const Negation& old_negation = **result.first;
+      lock.unlock();
       delete negation;
-      return **result.first;
+      return old_negation;
     } else {
       negation->assign_id(ground);
+      /* The table holds a reference to each ground negation, just
+         like the table of atoms. */
+      register_use(negation);
       return *negation;
     }
   }
 }
 
 
+/* Releases the ground negations held by the table of negated atoms. */
+void Negation::clear() {
+  NegationTable old_negations;
+  {
+    std::lock_guard<std::mutex> lock(literal_table_mutex);
+    old_negations.swap(negations);
+  }
+  for (NegationTable::const_iterator ni = old_negations.begin();
+       ni != old_negations.end(); ni++) {
+    unregister_use(*ni);
+  }
+}
+
+
 /* Constructs a negated atom. */
 Negation::Negation(const Atom& atom)
   : atom_(&atom) {
@@ -490,9 +598,12 @@ Negation::Negation(const Atom& atom)
 /* Deletes this negated atom. */
 Negation::~Negation() {
   unregister_use(atom_);
-  NegationTable::const_iterator ni = negations.find(this);
-  if (*ni == this) {
-    negations.erase(ni);
+  if (id() > 0) {
+    std::lock_guard<std::mutex> lock(literal_table_mutex);
+    NegationTable::const_iterator ni = negations.find(this);
+    if (ni != negations.end() && *ni == this) {
+      negations.erase(ni);
+    }
   }
 }
 
@@ -1505,6 +1616,10 @@ const Formula& Forall::instantiation(const std::map<Variable, Term>& subst,
 /* Returns the universal base of this formula. */
 const Formula& Forall::universal_base(const std::map<Variable, Term>& subst,
                                       const Problem& problem) const {
+  /* The cached base is built incrementally, so hold the lock for the
+     whole computation; nested quantifiers lock recursively. */
+  static std::recursive_mutex universal_base_mutex;
+  std::lock_guard<std::recursive_mutex> lock(universal_base_mutex);
   if (universal_base_ != NULL) {
     return *universal_base_;
   }
@@ -22,8 +22,10 @@
 #ifndef FORMULAS_H
 #define FORMULAS_H
 
+#include <atomic>
 #include <iostream>
 #include <set>
+#include <unordered_set>
 #include <vector>
 
 #include "predicates.h"
@@ -61,15 +63,14 @@ struct Formula {
   /* Register use of the given formula. */
   static void register_use(const Formula* f) {
     if (f != NULL) {
-      f->ref_count_++;
+      f->ref_count_.fetch_add(1, std::memory_order_relaxed);
     }
   }
 
   /* Unregister use of the given formula. */
   static void unregister_use(const Formula* f) {
     if (f != NULL) {
-      f->ref_count_--;
-      if (f->ref_count_ == 0) {
+      if (f->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
         delete f;
       }
     }
@@ -114,12 +115,17 @@ protected:
   /* Constructs a formula. */
   Formula();
 
+  /* Returns the number of registered uses of this formula. */
+  size_t ref_count() const {
+    return ref_count_.load(std::memory_order_acquire);
+  }
+
   /* Returns the negation of this formula. */
   virtual const Formula& negation() const = 0;
 
 private:
   /* Reference counter. */
-  mutable size_t ref_count_;
+  mutable std::atomic<size_t> ref_count_;
 
   friend const Formula& operator!(const Formula& f);
 };
@@ -230,7 +236,16 @@ struct Literal : public Formula {
   virtual const Literal& substitution(
       const std::map<Variable, Term>& subst) const = 0;
 
+  /* Releases the ground literals that are referenced only by the
+     tables of ground literals, so that new ground literals can reuse
+     their ids.  Must not be called while other threads use ground
+     literals. */
+  static void release_unused();
+
  protected:
+  /* Constructs a literal. */
+  Literal() : id_(0) {}
+
   /* Assigns an id to this literal. */
   void assign_id(bool ground);
 
@@ -268,6 +283,9 @@ struct Atom : public Literal {
   static const Atom& make(const Predicate& predicate,
                           const std::vector<Term>& terms);
 
+  /* Releases the ground atoms held by the table of atomic formulas. */
+  static void clear();
+
   /* Deletes this atomic formula. */
   virtual ~Atom();
 
@@ -308,15 +326,20 @@ protected:
   virtual const Literal& negation() const;
 
 private:
-  /* Less-than comparison function object for atoms. */
-  struct AtomLess
-    : public std::binary_function<const Atom*, const Atom*, bool> {
-    /* Comparison function. */
+  /* Hash function object for atoms. */
+  struct AtomHash {
+    /* Hash function. */
+    size_t operator()(const Atom* a) const;
+  };
+
+  /* Equality function object for atoms. */
+  struct AtomEqual {
+    /* Equality function. */
     bool operator()(const Atom* a1, const Atom* a2) const;
   };
 
   /* A table of atomic formulas. */
-  struct AtomTable : std::set<const Atom*, AtomLess> {
+  struct AtomTable : std::unordered_set<const Atom*, AtomHash, AtomEqual> {
   };
 
   /* Table of atomic formulas. */
@@ -327,11 +350,11 @@ private:
   /* Terms of this atom. */
   std::vector<Term> terms_;
 
-  /* Constructs an atomic formula with the given predicate. */
-  explicit Atom(const Predicate& predicate) : predicate_(predicate) {}
+  /* Constructs an atomic formula with the given predicate and terms. */
+  Atom(const Predicate& predicate, const std::vector<Term>& terms)
+    : predicate_(predicate), terms_(terms) {}
 
-  /* Adds a term to this atomic formula. */
-  void add_term(const Term& term) { terms_.push_back(term); }
+  friend struct Literal;
 };
 
 /*
@@ -354,6 +377,9 @@ struct Negation : public Literal {
   /* Returns a negation of the given atom. */
   static const Negation& make(const Atom& atom);
 
+  /* Releases the ground negations held by the table of negated atoms. */
+  static void clear();
+
   /* Deletes this negated atom. */
   virtual ~Negation();
 
@@ -395,15 +421,21 @@ protected:
   virtual const Literal& negation() const;
 
 private:
-  /* Less-than comparison function object for negated atoms. */
-  struct NegationLess
-    : public std::binary_function<const Negation*, const Negation*, bool> {
-    /* Comparison function. */
+  /* Hash function object for negated atoms. */
+  struct NegationHash {
+    /* Hash function. */
+    size_t operator()(const Negation* n) const;
+  };
+
+  /* Equality function object for negated atoms. */
+  struct NegationEqual {
+    /* Equality function. */
     bool operator()(const Negation* n1, const Negation* n2) const;
   };
 
   /* A table of negated atoms. */
-  struct NegationTable : std::set<const Negation*, NegationLess> {
+  struct NegationTable
+    : std::unordered_set<const Negation*, NegationHash, NegationEqual> {
   };
 
   /* Table of negated atoms. */
@@ -414,6 +446,8 @@ private:
 
   /* Constructs a negated atom. */
   explicit Negation(const Atom& atom);
+
+  friend struct Literal;
 };
 
 /*
@@ -875,15 +909,14 @@ struct Condition {
   /* Register use of the given condition. */
   static void register_use(const Condition* c) {
     if (c != NULL) {
-      c->ref_count_++;
+      c->ref_count_.fetch_add(1, std::memory_order_relaxed);
     }
   }
 
   /* Unregister use of the given condition. */
   static void unregister_use(const Condition* c) {
     if (c != NULL) {
-      c->ref_count_--;
-      if (c->ref_count_ == 0) {
+      if (c->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
         delete c;
       }
     }
@@ -939,7 +972,7 @@ private:
   /* End condition. */
   const Formula* at_end_;
   /* Reference counter. */
-  mutable size_t ref_count_;
+  mutable std::atomic<size_t> ref_count_;
 
   /* Constructs a Boolean condition. */
   Condition(bool b);
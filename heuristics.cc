@@ -21,10 +21,15 @@
 
 #include <string.h>
 #include <strings.h>
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <memory>
 #include <set>
+#include <sstream>
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "bindings.h"
 #include "chain.h"
@@ -37,6 +42,10 @@
 #include "problems.h"
 #include "terms.h"
 
+#include "src/action-cache.h"
+#include "src/timer.h"
+#include "src/worker-pool.h"
+
 /* Generates a random number in the interval [0,1). */
 static double rand01ex() {
   return rand()/(RAND_MAX + 1.0);
@@ -146,6 +155,139 @@ static void formula_value(HeuristicValue& h, HeuristicValue& hs,
 }
 
 
+/* Checks if the given ADD cost is a whole number small enough for
+   sums of such numbers to be exact in any order. */
+static bool exact_cost(float cost) {
+  return cost < 16777216.0f && cost == std::floor(cost);
+}
+
+
+/* Checks if the given open conditions have the same heuristic value
+   under the same bindings. */
+static bool same_value(const OpenCondition& oc1, const OpenCondition& oc2) {
+  return (oc1.step_id() == oc2.step_id()
+          && &oc1.condition() == &oc2.condition());
+}
+
+
+/* Adds the ADD cost and work of the given open condition to the given
+   sums, or subtracts them if sign is negative.  Returns false if the
+   result may not be exact. */
+static bool add_open_cond_value(float& add_cost, int& add_work,
+                                const OpenCondition& open_cond,
+                                const Plan& plan, const PlanningGraph& pg,
+                                int sign) {
+  HeuristicValue v, vs;
+  formula_value(v, vs, open_cond.condition(), open_cond.step_id(), plan, pg);
+  if (!exact_cost(v.add_cost())) {
+    return false;
+  } else if (sign < 0) {
+    if (v.add_work() == std::numeric_limits<int>::max()) {
+      return false;
+    }
+    add_cost -= v.add_cost();
+    add_work -= v.add_work();
+  } else {
+    add_cost += v.add_cost();
+    add_work = sum(add_work, v.add_work());
+  }
+  return true;
+}
+
+
+/* Computes the summed ADD cost and work of the open conditions of the
+   given plan, and records them with the plan.  If the sums are known
+   for the plan that the given plan was refined from, only the open
+   conditions that differ between the two plans are evaluated. */
+static void open_conds_add_value(float& add_cost, int& add_work,
+                                 const Plan& plan, const PlanningGraph& pg) {
+  const Chain<OpenCondition>* parent_open_conds;
+  size_t parent_num_open_conds;
+  if (plan.parent_add_value(add_cost, add_work, parent_open_conds,
+                            parent_num_open_conds)) {
+    /* The chains of open conditions share a tail.  The open conditions
+       before it in the parent plan are either copied or removed in
+       the child, and those before it in the child are either copies
+       or new. */
+    const Chain<OpenCondition>* pc = parent_open_conds;
+    const Chain<OpenCondition>* cc = plan.open_conds();
+    size_t pn = parent_num_open_conds;
+    size_t cn = plan.num_open_conds();
+    size_t parent_only = 0;
+    size_t child_only = 0;
+    for (; pc != NULL && pn > cn; pc = pc->tail, pn--) {
+      parent_only++;
+    }
+    for (; cc != NULL && cn > pn; cc = cc->tail, cn--) {
+      child_only++;
+    }
+    for (; pc != cc && pc != NULL && cc != NULL;
+         pc = pc->tail, cc = cc->tail) {
+      parent_only++;
+      child_only++;
+    }
+    for (; pc != cc && pc != NULL; pc = pc->tail) {
+      parent_only++;
+    }
+    for (; pc != cc && cc != NULL; cc = cc->tail) {
+      child_only++;
+    }
+    /* Copies keep their order, so they are matched in one pass, and
+       the open conditions of the child passed over are new. */
+    bool exact = true;
+    const Chain<OpenCondition>* next = plan.open_conds();
+    size_t next_index = 0;
+    pc = parent_open_conds;
+    for (size_t i = 0; exact && i < parent_only; i++, pc = pc->tail) {
+      cc = next;
+      size_t j = next_index;
+      while (j < child_only && !same_value(pc->head, cc->head)) {
+        cc = cc->tail;
+        j++;
+      }
+      if (j < child_only) {
+        for (; next != cc && exact; next = next->tail) {
+          exact = add_open_cond_value(add_cost, add_work, next->head,
+                                      plan, pg, 1);
+        }
+        next = cc->tail;
+        next_index = j + 1;
+      } else {
+        exact = add_open_cond_value(add_cost, add_work, pc->head,
+                                    plan, pg, -1);
+      }
+    }
+    for (; next_index < child_only && exact;
+         next = next->tail, next_index++) {
+      exact = add_open_cond_value(add_cost, add_work, next->head,
+                                  plan, pg, 1);
+    }
+    if (exact) {
+      plan.set_add_value(add_cost, add_work,
+                         (exact_cost(add_cost)
+                          && add_work < std::numeric_limits<int>::max()));
+      return;
+    }
+  }
+  add_cost = 0.0f;
+  add_work = 0;
+  bool exact = true;
+  for (const Chain<OpenCondition>* occ = plan.open_conds();
+       occ != NULL; occ = occ->tail) {
+    const OpenCondition& open_cond = occ->head;
+    HeuristicValue v, vs;
+    formula_value(v, vs, open_cond.condition(), open_cond.step_id(),
+                  plan, pg);
+    exact = exact && exact_cost(v.add_cost());
+    add_cost += v.add_cost();
+    add_work = sum(add_work, v.add_work());
+  }
+  plan.set_add_value(add_cost, add_work,
+                     (exact && exact_cost(add_cost)
+                      && add_work < std::numeric_limits<int>::max()));
+}
+
+
 /* ====================================================================== */
 /* GroundActionSet */
 
@@ -288,6 +430,39 @@ std::ostream& operator<<(std::ostream& os, const HeuristicValue& v) {
 }
 
 
+/* ====================================================================== */
+/* ActionEffectMap */
+
+/* Orders action/effect pairs by action. */
+struct ActionLess {
+  bool operator()(const ActionEffectMap::value_type& ae,
+                  const Action* action) const {
+    return ae.first < action;
+  }
+
+  bool operator()(const Action* action,
+                  const ActionEffectMap::value_type& ae) const {
+    return action < ae.first;
+  }
+};
+
+
+/* Returns the range of action/effect pairs for the given action. */
+std::pair<ActionEffectMap::const_iterator, ActionEffectMap::const_iterator>
+ActionEffectMap::equal_range(const Action* action) const {
+  return std::equal_range(pairs_.begin(), pairs_.end(), action, ActionLess());
+}
+
+
+/* Adds the given action/effect pair to this map, after any pairs
+   already present for the same action. */
+void ActionEffectMap::insert(const value_type& ae) {
+  pairs_.insert(std::upper_bound(pairs_.begin(), pairs_.end(), ae.first,
+                                 ActionLess()),
+                ae);
+}
+
+
 /* ====================================================================== */
 /* Heuristic evaluation functions for formulas. */
 
@@ -404,6 +579,71 @@ void TimedLiteral::heuristic_value(HeuristicValue& h, HeuristicValue& hs,
 /* ====================================================================== */
 /* PlanningGraph */
 
+/* Fills the given action list with the ground actions recorded in the
+   action cache, and returns true on success.  Returns false, leaving
+   the list empty, if the cache holds no actions for this problem. */
+static bool read_cached_actions(std::vector<const GroundAction*>& actions,
+                                const Problem& problem,
+                                const Parameters& params) {
+  std::vector<CachedAction> cached_actions;
+  if (!ReadActionCache(params.action_cache, params.action_cache_key,
+                       &cached_actions)) {
+    return false;
+  }
+  for (std::vector<CachedAction>::const_iterator ai = cached_actions.begin();
+       ai != cached_actions.end(); ai++) {
+    const ActionSchema* schema = problem.domain().find_action((*ai).schema);
+    const GroundAction* action = NULL;
+    if (schema != NULL) {
+      std::vector<Object> arguments;
+      for (size_t i = 0; i < (*ai).arguments.size(); i++) {
+        const Object* o = problem.terms().find_object((*ai).arguments[i]);
+        if (o == NULL) {
+          break;
+        }
+        arguments.push_back(*o);
+      }
+      if (arguments.size() == (*ai).arguments.size()) {
+        action = schema->instantiation(arguments, problem);
+      }
+    }
+    if (action == NULL) {
+      /* The cache does not match the problem after all. */
+      for (size_t i = 0; i < actions.size(); i++) {
+        delete actions[i];
+      }
+      actions.clear();
+      return false;
+    }
+    actions.push_back(action);
+  }
+  return true;
+}
+
+
+/* Records the given actions in the action cache. */
+static void write_cached_actions(
+    const std::vector<const GroundAction*>& actions,
+    const Parameters& params) {
+  std::vector<CachedAction> cached_actions(actions.size());
+  for (size_t i = 0; i < actions.size(); i++) {
+    const GroundAction& action = *actions[i];
+    cached_actions[i].schema = action.name();
+    for (std::vector<Object>::const_iterator oi = action.arguments().begin();
+         oi != action.arguments().end(); oi++) {
+      std::ostringstream name;
+      name << *oi;
+      cached_actions[i].arguments.push_back(name.str());
+    }
+  }
+  if (!WriteActionCache(params.action_cache, params.action_cache_key,
+                        cached_actions)) {
+    std::cerr << PACKAGE ": cannot write action cache "
+              << params.action_cache << std::endl;
+  }
+}
+
+
 /* Constructs a planning graph. */
 PlanningGraph::PlanningGraph(const Problem& problem, const Parameters& params)
   : problem_(&problem) {
@@ -411,9 +651,30 @@ PlanningGraph::PlanningGraph(const Problem& problem, const Parameters& params)
    * Find all consistent action instantiations.
    */
   std::vector<const GroundAction*> actions;
-  problem.instantiated_actions(actions);
+  /* Worker threads for grounding and building levels, or NULL if
+     single threaded. */
+  std::unique_ptr<WorkerPool> pool;
+  if (params.grounding_threads > 1) {
+    pool.reset(new WorkerPool(params.grounding_threads));
+  }
+  Timer<> timer;
+  /* The action cache holds only the useful actions, which is not
+     enough to find duration factors for relative action costs. */
+  const bool use_cache = (!params.action_cache.empty()
+                          && params.action_cost != Parameters::RELATIVE);
+  const bool cached = (use_cache
+                       && read_cached_actions(actions, problem, params));
+  if (!cached) {
+    problem.instantiated_actions(actions, pool.get());
+  }
   if (verbosity > 0) {
-    std::cerr << std::endl << "Instantiated actions: " << actions.size()
+    const auto elapsed_millis =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          timer.ElapsedTime());
+    std::cerr << std::endl
+              << (cached ? "Cached actions: " : "Instantiated actions: ")
+              << actions.size() << std::endl
+              << "Grounding time: " << elapsed_millis.count() << " ms"
               << std::endl;
   }
   /*
@@ -476,11 +737,13 @@ PlanningGraph::PlanningGraph(const Problem& problem, const Parameters& params)
        ei != ia.effects().end(); ei++) {
     const Atom& atom = dynamic_cast<const Atom&>((*ei)->literal());
     achievers_[&atom].insert(std::make_pair(&ia, *ei));
+    if (atom_values_.find(atom) != NULL) {
+      continue;
+    }
     if (PredicateTable::static_predicate(atom.predicate())) {
-      atom_values_.insert(std::make_pair(&atom, HeuristicValue::ZERO));
+      atom_values_.set(atom, HeuristicValue::ZERO);
     } else {
-      atom_values_.insert(std::make_pair(&atom,
-                                         HeuristicValue::ZERO_COST_UNIT_WORK));
+      atom_values_.set(atom, HeuristicValue::ZERO_COST_UNIT_WORK);
     }
   }
   for (TimedActionTable::const_iterator ai = problem.timed_actions().begin();
@@ -499,16 +762,14 @@ PlanningGraph::PlanningGraph(const Problem& problem, const Parameters& params)
       }
       const Atom* atom = dynamic_cast<const Atom*>(&literal);
       if (atom != NULL) {
-        if (atom_values_.find(atom) == atom_values_.end()) {
-          atom_values_.insert(std::make_pair(atom,
-                                             HeuristicValue(d, 1, time)));
+        if (atom_values_.find(*atom) == NULL) {
+          atom_values_.set(*atom, HeuristicValue(d, 1, time));
         }
       } else {
         const Negation& negation = dynamic_cast<const Negation&>(literal);
-        if (negation_values_.find(&negation.atom()) == negation_values_.end()
+        if (negation_values_.find(negation.atom()) == NULL
             && heuristic_value(negation.atom(), 0).zero()) {
-          negation_values_.insert(std::make_pair(&negation.atom(),
-                                                 HeuristicValue(d, 1, time)));
+          negation_values_.set(negation.atom(), HeuristicValue(d, 1, time));
         }
       }
     }
@@ -526,25 +787,87 @@ PlanningGraph::PlanningGraph(const Problem& problem, const Parameters& params)
    * create action domain constraints only for actions that are both
    * applicable and useful.
    */
-  GroundActionSet applicable_actions;
-  GroundActionSet useful_actions;
+  std::vector<bool> applicable_actions(actions.size(), false);
+  std::vector<bool> useful_actions(actions.size(), false);
+  size_t num_applicable = 0;
+  size_t num_useful = 0;
+  /*
+   * Values of action preconditions and effects at the current level.
+   * They only depend on the literal values of earlier levels, so they
+   * are computed for all actions first, in parallel if there are
+   * worker threads, and then merged into the next level in action
+   * order.  The value of an effect that is not achievable at the
+   * current level is infinite.
+   */
+  std::vector<HeuristicValue> pre_values(actions.size());
+  std::vector<HeuristicValue> start_values(actions.size());
+  std::vector<size_t> first_effect(actions.size() + 1, 0);
+  for (size_t i = 0; i < actions.size(); i++) {
+    first_effect[i + 1] = first_effect[i] + actions[i]->effects().size();
+  }
+  std::vector<HeuristicValue> effect_values(first_effect.back());
+  auto evaluate_action = [&](size_t i) {
+    const GroundAction& action = *actions[i];
+    HeuristicValue& pre_value = pre_values[i];
+    HeuristicValue& start_value = start_values[i];
+    action.condition().heuristic_value(pre_value, start_value, *this, 0);
+    if (start_value.infinite()) {
+      return;
+    }
+    for (size_t j = 0; j < action.effects().size(); j++) {
+      const Effect& effect = *action.effects()[j];
+      HeuristicValue& cond_value = effect_values[first_effect[i] + j];
+      cond_value = HeuristicValue::INFINITE;
+      if (effect.when() == Effect::AT_END && pre_value.infinite()) {
+        continue;
+      }
+      HeuristicValue cond_value_start;
+      effect.condition().heuristic_value(cond_value, cond_value_start,
+                                         *this, 0);
+      if (cond_value.infinite() || effect.link_condition().contradiction()) {
+        cond_value = HeuristicValue::INFINITE;
+        continue;
+      }
+      /* Effect condition is achievable at this level. */
+      if (effect.when() == Effect::AT_START) {
+        cond_value += start_value;
+      } else {
+        cond_value += pre_value;
+      }
+      const Value* min_v = dynamic_cast<const Value*>(&action.min_duration());
+      if (min_v == NULL) {
+        throw std::runtime_error("non-constant minimum duration");
+      }
+      cond_value.increase_makespan(Orderings::threshold + min_v->value());
+      float d = ((params.action_cost == Parameters::UNIT_COST)
+                 ? 1.0f : Orderings::threshold + min_v->value());
+      std::map<const Literal*, float>::const_iterator di =
+        duration_factor.find(&effect.literal());
+      if (di != duration_factor.end()) {
+        d /= (*di).second;
+      }
+      cond_value.increase_cost(d);
+    }
+  };
   do {
     if (verbosity > 3) {
       /*
        * Print literal values at this level.
        */
       std::cerr << "Literal values at level " << level << ":" << std::endl;
-      for (AtomValueMap::const_iterator vi = atom_values_.begin();
-           vi != atom_values_.end(); vi++) {
-        std::cerr << "  ";
-        (*vi).first->print(std::cerr, 0, Bindings::EMPTY);
-        std::cerr << " -- " << (*vi).second << std::endl;
+      for (size_t i = 0; i < atom_values_.size(); i++) {
+        if (atom_values_.atom(i) != NULL) {
+          std::cerr << "  ";
+          atom_values_.atom(i)->print(std::cerr, 0, Bindings::EMPTY);
+          std::cerr << " -- " << atom_values_.value(i) << std::endl;
+        }
       }
-      for (AtomValueMap::const_iterator vi = negation_values_.begin();
-           vi != negation_values_.end(); vi++) {
-        std::cerr << "  (not ";
-        (*vi).first->print(std::cerr, 0, Bindings::EMPTY);
-        std::cerr << ") -- " << (*vi).second << std::endl;
+      for (size_t i = 0; i < negation_values_.size(); i++) {
+        if (negation_values_.atom(i) != NULL) {
+          std::cerr << "  (not ";
+          negation_values_.atom(i)->print(std::cerr, 0, Bindings::EMPTY);
+          std::cerr << ") -- " << negation_values_.value(i) << std::endl;
+        }
       }
     }
     level++;
@@ -556,129 +879,105 @@ PlanningGraph::PlanningGraph(const Problem& problem, const Parameters& params)
      */
     AtomValueMap new_atom_values;
     AtomValueMap new_negation_values;
-    for (std::vector<const GroundAction*>::const_iterator ai = actions.begin();
-         ai != actions.end(); ai++) {
-      const GroundAction& action = **ai;
-      HeuristicValue pre_value;
-      HeuristicValue start_value;
-      action.condition().heuristic_value(pre_value, start_value, *this, 0);
-      if (!start_value.infinite()) {
-        /* Precondition is achievable at this level. */
-        if (!pre_value.infinite()
-            && applicable_actions.find(&action) == applicable_actions.end()) {
-          /* First time this action is applicable. */
-          applicable_actions.insert(&action);
+    if (pool != nullptr) {
+      pool->ParallelFor(actions.size(), evaluate_action);
+    } else {
+      for (size_t i = 0; i < actions.size(); i++) {
+        evaluate_action(i);
+      }
+    }
+    for (size_t i = 0; i < actions.size(); i++) {
+      const GroundAction& action = *actions[i];
+      const HeuristicValue& pre_value = pre_values[i];
+      if (start_values[i].infinite()) {
+        continue;
+      }
+      /* Precondition is achievable at this level. */
+      if (!pre_value.infinite() && !applicable_actions[i]) {
+        /* First time this action is applicable. */
+        applicable_actions[i] = true;
+        num_applicable++;
+      }
+      for (size_t j = 0; j < action.effects().size(); j++) {
+        const Effect& effect = *action.effects()[j];
+        const HeuristicValue& cond_value = effect_values[first_effect[i] + j];
+        if (cond_value.infinite()) {
+          continue;
         }
-        for (EffectList::const_iterator ei = action.effects().begin();
-             ei != action.effects().end(); ei++) {
-          const Effect& effect = **ei;
-          if (effect.when() == Effect::AT_END && pre_value.infinite()) {
-            continue;
+
+        /*
+         * Update heuristic values of literal added by effect.
+         */
+        const Literal& literal = effect.literal();
+        if (!find(achievers_, literal, action, effect)) {
+          if (!pre_value.infinite()) {
+            achievers_[&literal].insert(std::make_pair(&action, &effect));
           }
-          HeuristicValue cond_value, cond_value_start;
-          effect.condition().heuristic_value(cond_value, cond_value_start,
-                                             *this, 0);
-          if (!cond_value.infinite()
-              && !effect.link_condition().contradiction()) {
-            /* Effect condition is achievable at this level. */
-            if (effect.when() == Effect::AT_START) {
-              cond_value += start_value;
-            } else {
-              cond_value += pre_value;
-            }
-            const Value* min_v =
-              dynamic_cast<const Value*>(&action.min_duration());
-            if (min_v == NULL) {
-              throw std::runtime_error("non-constant minimum duration");
-            }
-            cond_value.increase_makespan(Orderings::threshold
-                                         + min_v->value());
-
-            /*
-             * Update heuristic values of literal added by effect.
-             */
-            const Literal& literal = effect.literal();
-            float d = ((params.action_cost == Parameters::UNIT_COST)
-                       ? 1.0f : Orderings::threshold + min_v->value());
-            std::map<const Literal*, float>::const_iterator di =
-              duration_factor.find(&literal);
-            if (di != duration_factor.end()) {
-              d /= (*di).second;
-            }
-            cond_value.increase_cost(d);
-            if (!find(achievers_, literal, action, effect)) {
-              if (!pre_value.infinite()) {
-                achievers_[&literal].insert(std::make_pair(&action, &effect));
-              }
-              if (useful_actions.find(&action) == useful_actions.end()) {
-                useful_actions.insert(&action);
-              }
-              if (verbosity > 4) {
-                std::cerr << "  ";
-                action.print(std::cerr, 0, Bindings::EMPTY);
-                std::cerr << " achieves ";
-                literal.print(std::cerr, 0, Bindings::EMPTY);
-                std::cerr << " with ";
-                effect.print(std::cerr);
-                std::cerr << ' ' << cond_value << std::endl;
-              }
-            }
-            const Atom* atom = dynamic_cast<const Atom*>(&literal);
-            if (atom != NULL) {
-              AtomValueMap::const_iterator vi = new_atom_values.find(atom);
-              if (vi == new_atom_values.end()) {
-                vi = atom_values_.find(atom);
-                if (vi == atom_values_.end()) {
-                  /* First level this atom is achieved. */
-                  HeuristicValue new_value = cond_value;
-                  new_value.increment_work();
-                  new_atom_values.insert(std::make_pair(atom, new_value));
-                  changed = true;
-                  continue;
-                }
-              }
-              /* This atom has been achieved earlier. */
-              HeuristicValue old_value = (*vi).second;
-              HeuristicValue new_value = cond_value;
-              new_value.increment_work();
-              new_value = min(new_value, old_value);
-              if (new_value != old_value) {
-                new_atom_values[atom] = new_value;
-                changed = true;
-              }
-            } else {
-              const Negation& negation =
-                dynamic_cast<const Negation&>(literal);
-              AtomValueMap::const_iterator vi =
-                new_negation_values.find(&negation.atom());
-              if (vi == new_negation_values.end()) {
-                vi = negation_values_.find(&negation.atom());
-                if (vi == negation_values_.end()) {
-                  if (heuristic_value(negation.atom(), 0).zero()) {
-                    /* First level this negated atom is achieved. */
-                    HeuristicValue new_value = cond_value;
-                    new_value.increment_work();
-                    new_negation_values.insert(std::make_pair(&negation.atom(),
-                                                              new_value));
-                    changed = true;
-                    continue;
-                  } else {
-                    /* Closed world assumption. */
-                    continue;
-                  }
-                }
-              }
-              /* This negated atom has been achieved earlier. */
-              HeuristicValue old_value = (*vi).second;
+          if (!useful_actions[i]) {
+            useful_actions[i] = true;
+            num_useful++;
+          }
+          if (verbosity > 4) {
+            std::cerr << "  ";
+            action.print(std::cerr, 0, Bindings::EMPTY);
+            std::cerr << " achieves ";
+            literal.print(std::cerr, 0, Bindings::EMPTY);
+            std::cerr << " with ";
+            effect.print(std::cerr);
+            std::cerr << ' ' << cond_value << std::endl;
+          }
+        }
+        const Atom* atom = dynamic_cast<const Atom*>(&literal);
+        if (atom != NULL) {
+          const HeuristicValue* vi = new_atom_values.find(*atom);
+          if (vi == NULL) {
+            vi = atom_values_.find(*atom);
+            if (vi == NULL) {
+              /* First level this atom is achieved. */
               HeuristicValue new_value = cond_value;
               new_value.increment_work();
-              new_value = min(new_value, old_value);
-              if (new_value != old_value) {
-                new_negation_values[&negation.atom()] = new_value;
+              new_atom_values.set(*atom, new_value);
+              changed = true;
+              continue;
+            }
+          }
+          /* This atom has been achieved earlier. */
+          HeuristicValue old_value = *vi;
+          HeuristicValue new_value = cond_value;
+          new_value.increment_work();
+          new_value = min(new_value, old_value);
+          if (new_value != old_value) {
+            new_atom_values.set(*atom, new_value);
+            changed = true;
+          }
+        } else {
+          const Negation& negation = dynamic_cast<const Negation&>(literal);
+          const HeuristicValue* vi = new_negation_values.find(negation.atom());
+          if (vi == NULL) {
+            vi = negation_values_.find(negation.atom());
+            if (vi == NULL) {
+              if (heuristic_value(negation.atom(), 0).zero()) {
+                /* First level this negated atom is achieved. */
+                HeuristicValue new_value = cond_value;
+                new_value.increment_work();
+                new_negation_values.set(negation.atom(), new_value);
                 changed = true;
+                continue;
+              } else {
+                /* Closed world assumption. */
+                continue;
               }
             }
           }
+          /* This negated atom has been achieved earlier. */
+          HeuristicValue old_value = *vi;
+          HeuristicValue new_value = cond_value;
+          new_value.increment_work();
+          new_value = min(new_value, old_value);
+          if (new_value != old_value) {
+            new_negation_values.set(negation.atom(), new_value);
+            changed = true;
+          }
         }
       }
     }
@@ -686,48 +985,52 @@ PlanningGraph::PlanningGraph(const Problem& problem, const Parameters& params)
     /*
      * Add achieved atoms to previously achieved atoms.
      */
-    for (AtomValueMap::const_iterator vi = new_atom_values.begin();
-         vi != new_atom_values.end(); vi++) {
-      atom_values_[(*vi).first] = (*vi).second;
+    for (size_t i = 0; i < new_atom_values.size(); i++) {
+      if (new_atom_values.atom(i) != NULL) {
+        atom_values_.set(*new_atom_values.atom(i), new_atom_values.value(i));
+      }
     }
     /*
      * Add achieved negated atoms to previously achieved negated atoms.
      */
-    for (AtomValueMap::const_iterator vi = new_negation_values.begin();
-         vi != new_negation_values.end(); vi++) {
-      negation_values_[(*vi).first] = (*vi).second;
+    for (size_t i = 0; i < new_negation_values.size(); i++) {
+      if (new_negation_values.atom(i) != NULL) {
+        negation_values_.set(*new_negation_values.atom(i),
+                             new_negation_values.value(i));
+      }
     }
   } while (changed);
 
   /*
    * Map predicates to achievable ground atoms.
    */
-  for (AtomValueMap::const_iterator vi = atom_values_.begin();
-       vi != atom_values_.end(); vi++) {
-    const Atom& atom = *(*vi).first;
-    predicate_atoms_.insert(std::make_pair(atom.predicate(), &atom));
+  for (size_t i = 0; i < atom_values_.size(); i++) {
+    const Atom* atom = atom_values_.atom(i);
+    if (atom != NULL) {
+      predicate_atoms_.insert(std::make_pair(atom->predicate(), atom));
+    }
   }
 
   /*
    * Map predicates to achievable negated ground atoms.
    */
-  for (AtomValueMap::const_iterator vi = negation_values_.begin();
-       vi != negation_values_.end(); vi++) {
-    const Atom& atom = *(*vi).first;
-    predicate_negations_.insert(std::make_pair(atom.predicate(), &atom));
+  for (size_t i = 0; i < negation_values_.size(); i++) {
+    const Atom* atom = negation_values_.atom(i);
+    if (atom != NULL) {
+      predicate_negations_.insert(std::make_pair(atom->predicate(), atom));
+    }
   }
 
   /*
    * Collect actions that are both applicable and useful.  Create
    * actions domains constraints for these actions, if called for.
    */
-  GroundActionSet good_actions;
+  std::vector<const GroundAction*> good_actions;
   if (verbosity > 1 || params.domain_constraints) {
-    for (GroundActionSet::const_iterator ai = applicable_actions.begin();
-         ai != applicable_actions.end(); ai++) {
-      const GroundAction& action = **ai;
-      if (useful_actions.find(&action) != useful_actions.end()) {
-        good_actions.insert(&action);
+    for (size_t i = 0; i < actions.size(); i++) {
+      const GroundAction& action = *actions[i];
+      if (applicable_actions[i] && useful_actions[i]) {
+        good_actions.push_back(&action);
         if (params.domain_constraints && !action.arguments().empty()) {
           ActionDomainMap::const_iterator di =
             action_domains_.find(action.name());
@@ -744,22 +1047,35 @@ PlanningGraph::PlanningGraph(const Problem& problem, const Parameters& params)
   }
 
   if (verbosity > 0) {
-    std::cerr << "Applicable actions: " << applicable_actions.size()
-              << std::endl
-              << "Useful actions: " << useful_actions.size() << std::endl;
+    std::cerr << "Applicable actions: " << num_applicable << std::endl
+              << "Useful actions: " << num_useful << std::endl;
     if (verbosity > 1) {
       std::cerr << "Good actions: " << good_actions.size() << std::endl;
     }
   }
 
 
+  /*
+   * Record the useful actions, in order, so that later runs on the
+   * same problem can skip grounding and the actions that are not
+   * useful.  Only useful actions affect the planning graph.
+   */
+  if (use_cache && !cached) {
+    std::vector<const GroundAction*> useful;
+    for (size_t i = 0; i < actions.size(); i++) {
+      if (useful_actions[i]) {
+        useful.push_back(actions[i]);
+      }
+    }
+    write_cached_actions(useful, params);
+  }
+
   /*
    * Delete all actions that are not useful.
    */
-  for (std::vector<const GroundAction*>::const_iterator ai = actions.begin();
-       ai != actions.end(); ai++) {
-    if (useful_actions.find(*ai) == useful_actions.end()) {
-      delete *ai;
+  for (size_t i = 0; i < actions.size(); i++) {
+    if (!useful_actions[i]) {
+      delete actions[i];
     }
   }
 
@@ -767,7 +1083,8 @@ PlanningGraph::PlanningGraph(const Problem& problem, const Parameters& params)
     /*
      * Print good actions.
      */
-    for (GroundActionSet::const_iterator ai = good_actions.begin();
+    for (std::vector<const GroundAction*>::const_iterator ai =
+           good_actions.begin();
          ai != good_actions.end(); ai++) {
       std::cerr << "  ";
       (*ai)->print(std::cerr, 0, Bindings::EMPTY);
@@ -777,17 +1094,19 @@ PlanningGraph::PlanningGraph(const Problem& problem, const Parameters& params)
      * Print literal values.
      */
     std::cerr << "Achievable literals:" << std::endl;
-    for (AtomValueMap::const_iterator vi = atom_values_.begin();
-         vi != atom_values_.end(); vi++) {
-      std::cerr << "  ";
-      (*vi).first->print(std::cerr, 0, Bindings::EMPTY);
-      std::cerr << " -- " << (*vi).second << std::endl;
+    for (size_t i = 0; i < atom_values_.size(); i++) {
+      if (atom_values_.atom(i) != NULL) {
+        std::cerr << "  ";
+        atom_values_.atom(i)->print(std::cerr, 0, Bindings::EMPTY);
+        std::cerr << " -- " << atom_values_.value(i) << std::endl;
+      }
     }
-    for (AtomValueMap::const_iterator vi = negation_values_.begin();
-         vi != negation_values_.end(); vi++) {
-      std::cerr << "  (not ";
-      (*vi).first->print(std::cerr, 0, Bindings::EMPTY);
-      std::cerr << ") -- " << (*vi).second << std::endl;
+    for (size_t i = 0; i < negation_values_.size(); i++) {
+      if (negation_values_.atom(i) != NULL) {
+        std::cerr << "  (not ";
+        negation_values_.atom(i)->print(std::cerr, 0, Bindings::EMPTY);
+        std::cerr << ") -- " << negation_values_.value(i) << std::endl;
+      }
     }
   }
 }
@@ -821,9 +1140,8 @@ HeuristicValue PlanningGraph::heuristic_value(const Atom& atom, size_t step_id,
                                               const Bindings* bindings) const {
   if (bindings == NULL) {
     /* Assume ground atom. */
-    AtomValueMap::const_iterator vi = atom_values_.find(&atom);
-    return ((vi != atom_values_.end())
-            ? (*vi).second : HeuristicValue::INFINITE);
+    const HeuristicValue* v = atom_values_.find(atom);
+    return (v != NULL) ? *v : HeuristicValue::INFINITE;
   } else {
     /* Take minimum value of ground atoms that unify. */
     HeuristicValue value = HeuristicValue::INFINITE;
@@ -852,12 +1170,12 @@ HeuristicValue PlanningGraph::heuristic_value(const Negation& negation,
                                               const Bindings* bindings) const {
   if (bindings == NULL) {
     /* Assume ground negated atom. */
-    AtomValueMap::const_iterator vi = negation_values_.find(&negation.atom());
-    if (vi != negation_values_.end()) {
-      return (*vi).second;
+    const HeuristicValue* v = negation_values_.find(negation.atom());
+    if (v != NULL) {
+      return *v;
     } else {
-      vi = atom_values_.find(&negation.atom());
-      return ((vi == atom_values_.end() || !(*vi).second.zero())
+      v = atom_values_.find(negation.atom());
+      return ((v == NULL || !v->zero())
               ? HeuristicValue::ZERO_COST_UNIT_WORK
               : HeuristicValue::INFINITE);
     }
@@ -931,6 +1249,12 @@ InvalidHeuristic::InvalidHeuristic(const std::string& name)
   : std::runtime_error("invalid heuristic `" + name + "'") {}
 
 
+/* Constructs an invalid heuristic exception with an explanation. */
+InvalidHeuristic::InvalidHeuristic(const std::string& name,
+                                   const std::string& reason)
+  : std::runtime_error("invalid heuristic `" + name + "': " + reason) {}
+
+
 /* ====================================================================== */
 /* Heuristic */
 
@@ -987,6 +1311,10 @@ Heuristic& Heuristic::operator=(const std::string& name) {
     } else {
       throw InvalidHeuristic(name);
     }
+    if (h_.size() > MAX_RANKS) {
+      throw InvalidHeuristic(name, "more than " + std::to_string(MAX_RANKS)
+                             + " components");
+    }
     pos = next_pos;
     if (name[pos] == '/') {
       pos++;
@@ -1006,7 +1334,7 @@ bool Heuristic::needs_planning_graph() const {
 
 
 /* Fills the provided vector with the ranks for the given plan. */
-void Heuristic::plan_rank(std::vector<float>& rank, const Plan& plan,
+void Heuristic::plan_rank(float* rank, const Plan& plan,
                           float weight, const Domain& domain,
                           const PlanningGraph* planning_graph) const {
   bool add_done = false;
@@ -1015,64 +1343,55 @@ void Heuristic::plan_rank(std::vector<float>& rank, const Plan& plan,
   bool addr_done = false;
   float addr_cost = 0.0f;
   int addr_work = 0;
-  for (std::vector<HVal>::const_iterator hi = h_.begin();
-       hi != h_.end(); hi++) {
-    HVal h = *hi;
+  for (size_t i = 0; i < h_.size(); i++) {
+    HVal h = h_[i];
     switch (h) {
     case LIFO:
-      rank.push_back(-1.0*plan.serial_no());
+      rank[i] = -1.0*plan.serial_no();
       break;
     case FIFO:
-      rank.push_back(plan.serial_no());
+      rank[i] = plan.serial_no();
       break;
     case OC:
-      rank.push_back(plan.num_open_conds());
+      rank[i] = plan.num_open_conds();
       break;
     case UC:
-      rank.push_back(plan.num_unsafes());
+      rank[i] = plan.num_unsafes();
       break;
     case BUC:
-      rank.push_back((plan.num_unsafes() > 0) ? 1 : 0);
+      rank[i] = (plan.num_unsafes() > 0) ? 1 : 0;
       break;
     case S_PLUS_OC:
-      rank.push_back(plan.num_steps() + weight*plan.num_open_conds());
+      rank[i] = plan.num_steps() + weight*plan.num_open_conds();
       break;
     case UCPOP:
-      rank.push_back(plan.num_steps()
-                     + weight*(plan.num_open_conds() + plan.num_unsafes()));
+      rank[i] = plan.num_steps()
+        + weight*(plan.num_open_conds() + plan.num_unsafes());
       break;
     case ADD:
     case ADD_COST:
     case ADD_WORK:
       if (!add_done) {
         add_done = true;
-        for (const Chain<OpenCondition>* occ = plan.open_conds();
-             occ != NULL; occ = occ->tail) {
-          const OpenCondition& open_cond = occ->head;
-          HeuristicValue v, vs;
-          formula_value(v, vs, open_cond.condition(), open_cond.step_id(),
-                        plan, *planning_graph);
-          add_cost += v.add_cost();
-          add_work = sum(add_work, v.add_work());
-        }
+        open_conds_add_value(add_cost, add_work, plan, *planning_graph);
       }
       if (h == ADD) {
         if (add_cost < std::numeric_limits<int>::max()) {
-          rank.push_back(plan.num_steps() + weight*add_cost);
+          rank[i] = plan.num_steps() + weight*add_cost;
         } else {
-          rank.push_back(std::numeric_limits<float>::infinity());
+          rank[i] = std::numeric_limits<float>::infinity();
         }
       } else if (h == ADD_COST) {
         if (add_cost < std::numeric_limits<int>::max()) {
-          rank.push_back(add_cost);
+          rank[i] = add_cost;
         } else {
-          rank.push_back(std::numeric_limits<float>::infinity());
+          rank[i] = std::numeric_limits<float>::infinity();
         }
       } else {
         if (add_work < std::numeric_limits<int>::max()) {
-          rank.push_back(add_work);
+          rank[i] = add_work;
         } else {
-          rank.push_back(std::numeric_limits<float>::infinity());
+          rank[i] = std::numeric_limits<float>::infinity();
         }
       }
       break;
@@ -1093,21 +1412,21 @@ void Heuristic::plan_rank(std::vector<float>& rank, const Plan& plan,
       }
       if (h == ADDR) {
         if (addr_cost < std::numeric_limits<int>::max()) {
-          rank.push_back(plan.num_steps() + weight*addr_cost);
+          rank[i] = plan.num_steps() + weight*addr_cost;
         } else {
-          rank.push_back(std::numeric_limits<float>::infinity());
+          rank[i] = std::numeric_limits<float>::infinity();
         }
       } else if (h == ADDR_COST) {
         if (addr_cost < std::numeric_limits<int>::max()) {
-          rank.push_back(addr_cost);
+          rank[i] = addr_cost;
         } else {
-          rank.push_back(std::numeric_limits<float>::infinity());
+          rank[i] = std::numeric_limits<float>::infinity();
         }
       } else {
         if (addr_work < std::numeric_limits<int>::max()) {
-          rank.push_back(addr_work);
+          rank[i] = addr_work;
         } else {
-          rank.push_back(std::numeric_limits<float>::infinity());
+          rank[i] = std::numeric_limits<float>::infinity();
         }
       }
       break;
@@ -1142,7 +1461,7 @@ void Heuristic::plan_rank(std::vector<float>& rank, const Plan& plan,
                                           weight*v.makespan()));
         }
       }
-      rank.push_back(plan.orderings().makespan(min_times));
+      rank[i] = plan.orderings().makespan(min_times);
       break;
     }
   }
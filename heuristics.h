@@ -23,6 +23,9 @@
 #define HEURISTICS_H
 
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "domains.h"
 #include "formulas.h"
@@ -43,9 +46,33 @@ struct Parameters;
 /* ActionEffectMap */
 
 /*
- * Mapping from actions to effects.
+ * Mapping from actions to effects, stored as a flat array of
+ * action/effect pairs ordered by action.
  */
-struct ActionEffectMap : public std::multimap<const Action*, const Effect*> {
+struct ActionEffectMap {
+  typedef std::pair<const Action*, const Effect*> value_type;
+  typedef std::vector<value_type>::const_iterator const_iterator;
+
+  /* Returns an iterator pointing to the first action/effect pair. */
+  const_iterator begin() const { return pairs_.begin(); }
+
+  /* Returns an iterator pointing beyond the last action/effect pair. */
+  const_iterator end() const { return pairs_.end(); }
+
+  /* Checks if this map is empty. */
+  bool empty() const { return pairs_.empty(); }
+
+  /* Returns the range of action/effect pairs for the given action. */
+  std::pair<const_iterator, const_iterator>
+  equal_range(const Action* action) const;
+
+  /* Adds the given action/effect pair to this map, after any pairs
+     already present for the same action. */
+  void insert(const value_type& ae);
+
+private:
+  /* Action/effect pairs ordered by action. */
+  std::vector<value_type> pairs_;
 };
 
 
@@ -165,13 +192,47 @@ struct PlanningGraph {
   const ActionDomain* action_domain(const std::string& name) const;
 
 private:
-  /* Atom value map. */
-  struct AtomValueMap : public std::map<const Atom*, HeuristicValue> {
+  /* Atom value map, indexed by atom id. */
+  struct AtomValueMap {
+    /* Returns one more than the largest atom id in this map. */
+    size_t size() const { return atoms_.size(); }
+
+    /* Returns the atom with the given id, or NULL if there is no value
+       for the atom. */
+    const Atom* atom(size_t id) const { return atoms_[id]; }
+
+    /* Returns the value of the atom with the given id. */
+    const HeuristicValue& value(size_t id) const { return values_[id]; }
+
+    /* Returns the value of the given atom, or NULL if there is no value
+       for the atom. */
+    const HeuristicValue* find(const Atom& atom) const {
+      size_t id = atom.id();
+      return ((id < atoms_.size() && atoms_[id] != NULL)
+              ? &values_[id] : NULL);
+    }
+
+    /* Sets the value of the given atom. */
+    void set(const Atom& atom, const HeuristicValue& value) {
+      size_t id = atom.id();
+      if (id >= atoms_.size()) {
+        atoms_.resize(id + 1, NULL);
+        values_.resize(id + 1);
+      }
+      atoms_[id] = &atom;
+      values_[id] = value;
+    }
+
+  private:
+    /* Atoms with values. */
+    std::vector<const Atom*> atoms_;
+    /* Atom values. */
+    std::vector<HeuristicValue> values_;
   };
 
   /* Mapping of literals to actions. */
   struct LiteralAchieverMap
-    : public std::map<const Literal*, ActionEffectMap> {
+    : public std::unordered_map<const Literal*, ActionEffectMap> {
   };
 
   /* Mapping of predicate names to ground atoms. */
@@ -212,6 +273,9 @@ private:
 struct InvalidHeuristic : public std::runtime_error {
   /* Constructs an invalid heuristic exception. */
   InvalidHeuristic(const std::string& name);
+
+  /* Constructs an invalid heuristic exception with an explanation. */
+  InvalidHeuristic(const std::string& name, const std::string& reason);
 };
 
 
@@ -235,6 +299,12 @@ struct InvalidHeuristic : public std::runtime_error {
  * MAKESPAN gives priority to plans with low makespan.
  */
 struct Heuristic {
+  /* Maximum number of heuristics that can be combined. */
+  static const size_t MAX_RANKS = 255;
+  /* Number of ranks a plan stores inline; plans ranked by longer
+     heuristics keep their ranks in a separate array. */
+  static const size_t INLINE_RANKS = 4;
+
   /* Constructs a heuristic from a name. */
   Heuristic(const std::string& name = "UCPOP");
 
@@ -244,8 +314,12 @@ struct Heuristic {
   /* Checks if this heuristic needs a planning graph. */
   bool needs_planning_graph() const;
 
-  /* Fills the provided vector with the ranks for the given plan. */
-  void plan_rank(std::vector<float>& rank, const Plan& plan,
+  /* Returns the number of ranks this heuristic assigns to a plan. */
+  size_t size() const { return h_.size(); }
+
+  /* Fills the provided array, which must have room for size()
+     values, with the ranks for the given plan. */
+  void plan_rank(float* rank, const Plan& plan,
                  float weight, const Domain& domain,
                  const PlanningGraph* planning_graph) const;
 
@@ -20,6 +20,9 @@
 #include "orderings.h"
 
 #include <limits.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
 #include <limits>
 
 #include "debug.h"
@@ -100,42 +103,120 @@ StepTime start_time(FormulaTime ft) {
 
 
 /* ====================================================================== */
-/* BoolVector */
+/* BitVector */
 
 /*
- * A collectible bool vector.
+ * A collectible bit vector stored in 64-bit words.  Bits past the end
+ * of the vector are false.
  */
-struct BoolVector : public std::vector<bool> {
+struct BitVector {
   /* Register use of the given vector. */
-  static void register_use(const BoolVector* v) {
+  static void register_use(const BitVector* v) {
     if (v != NULL) {
-      v->ref_count_++;
+      v->ref_count_.fetch_add(1, std::memory_order_relaxed);
     }
   }
 
   /* Unregister use of the given vector. */
-  static void unregister_use(const BoolVector* v) {
+  static void unregister_use(const BitVector* v) {
     if (v != NULL) {
-      v->ref_count_--;
-      if (v->ref_count_ == 0) {
+      if (v->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
         delete v;
       }
     }
   }
 
-  /* Constructs a vector with n copies of b. */
-  BoolVector(size_t n, bool b)
-    : std::vector<bool>(n, b), ref_count_(0) {
+  /* Constructs an empty vector. */
+  BitVector()
+    : ref_count_(0) {
+    NodePool::Charge(bytes());
   }
 
   /* Constructs a copy of the given vector. */
-  BoolVector(const BoolVector& v)
-    : std::vector<bool>(v), ref_count_(0) {
+  BitVector(const BitVector& v)
+    : words_(v.words_), ref_count_(0) {
+    NodePool::Charge(bytes());
+  }
+
+  /* Deletes this vector. */
+  ~BitVector() {
+    NodePool::Charge(-bytes());
+  }
+
+  /* Returns the value of the given bit. */
+  bool test(size_t i) const {
+    size_t w = i/64;
+    return w < words_.size() && ((words_[w] >> (i%64)) & 1) != 0;
   }
 
+  /* Sets the given bit. */
+  void set(size_t i) {
+    size_t w = i/64;
+    if (w >= words_.size()) {
+      resize(w + 1);
+    }
+    words_[w] |= uint64_t(1) << (i%64);
+  }
+
+  /* Clears the given bit. */
+  void reset(size_t i) {
+    size_t w = i/64;
+    if (w < words_.size()) {
+      words_[w] &= ~(uint64_t(1) << (i%64));
+    }
+  }
+
+  /* Sets all bits that are set in the given vector. */
+  void set_union(const BitVector& v) {
+    size_t n = v.words_.size();
+    if (n > words_.size()) {
+      resize(n);
+    }
+    uint64_t* w = words_.data();
+    const uint64_t* vw = v.words_.data();
+    for (size_t i = 0; i < n; i++) {
+      w[i] |= vw[i];
+    }
+  }
+
+  /* Returns the index of the first set bit at or after the given
+     index, or the number of bits in the vector if there is none. */
+  size_t next(size_t i) const {
+    size_t w = i/64;
+    if (w >= words_.size()) {
+      return 64*words_.size();
+    }
+    uint64_t word = words_[w] & (~uint64_t(0) << (i%64));
+    while (word == 0) {
+      w++;
+      if (w == words_.size()) {
+        return 64*w;
+      }
+      word = words_[w];
+    }
+    return 64*w + __builtin_ctzll(word);
+  }
+
+  /* Returns the number of bits in the vector. */
+  size_t size() const { return 64*words_.size(); }
+
 private:
+  /* The bits of this vector, 64 per word. */
+  std::vector<uint64_t> words_;
+
+  /* Returns the number of bytes held by this vector. */
+  long bytes() const {
+    return sizeof *this + sizeof(uint64_t)*words_.capacity();
+  }
+
+  /* Grows this vector to the given number of words. */
+  void resize(size_t n) {
+    long old_bytes = bytes();
+    words_.resize(n, 0);
+    NodePool::Charge(bytes() - old_bytes);
+  }
   /* Reference counter. */
-  mutable size_t ref_count_;
+  mutable std::atomic<size_t> ref_count_;
 };
 
 
@@ -149,15 +230,14 @@ struct IntVector : public std::vector<int> {
   /* Register use of the given vector. */
   static void register_use(const IntVector* v) {
     if (v != NULL) {
-      v->ref_count_++;
+      v->ref_count_.fetch_add(1, std::memory_order_relaxed);
     }
   }
 
   /* Unregister use of the given vector. */
   static void unregister_use(const IntVector* v) {
     if (v != NULL) {
-      v->ref_count_--;
-      if (v->ref_count_ == 0) {
+      if (v->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
         delete v;
       }
     }
@@ -166,16 +246,26 @@ struct IntVector : public std::vector<int> {
   /* Constructs a vector with n copies of b. */
   IntVector(size_t n, int f)
     : std::vector<int>(n, f), ref_count_(0) {
+    NodePool::Charge(bytes());
   }
 
   /* Constructs a copy of the given vector. */
   IntVector(const IntVector& v)
     : std::vector<int>(v), ref_count_(0) {
+    NodePool::Charge(bytes());
+  }
+
+  /* Deletes this vector. */
+  ~IntVector() {
+    NodePool::Charge(-bytes());
   }
 
 private:
+  /* Returns the number of bytes held by this vector. */
+  long bytes() const { return sizeof *this + sizeof(int)*capacity(); }
+
   /* Reference counter. */
-  mutable size_t ref_count_;
+  mutable std::atomic<size_t> ref_count_;
 };
 
 
@@ -220,20 +310,30 @@ BinaryOrderings::BinaryOrderings() {}
 
 /* Constructs a copy of this ordering collection. */
 BinaryOrderings::BinaryOrderings(const BinaryOrderings& o)
-  : Orderings(o), before_(o.before_) {
-  size_t n = before_.size();
+  : Orderings(o), after_(o.after_), before_(o.before_) {
+  size_t n = after_.size();
   for (size_t i = 0; i < n; i++) {
-    BoolVector::register_use(before_[i]);
+    BitVector::register_use(after_[i]);
+    BitVector::register_use(before_[i]);
   }
+  NodePool::Charge(row_bytes());
 }
 
 
 /* Deletes this ordering collection. */
 BinaryOrderings::~BinaryOrderings() {
-  size_t n = before_.size();
+  size_t n = after_.size();
   for (size_t i = 0; i < n; i++) {
-    BoolVector::unregister_use(before_[i]);
+    BitVector::unregister_use(after_[i]);
+    BitVector::unregister_use(before_[i]);
   }
+  NodePool::Charge(-row_bytes());
+}
+
+
+/* Returns the number of bytes held by the row vectors. */
+long BinaryOrderings::row_bytes() const {
+  return sizeof(const BitVector*)*(after_.capacity() + before_.capacity());
 }
 
 
@@ -306,7 +406,7 @@ BinaryOrderings::refine(const Ordering& new_ordering) const {
                              new_ordering.after_id(),
                              new_ordering.after_time())) {
     BinaryOrderings& orderings = *new BinaryOrderings(*this);
-    std::map<size_t, BoolVector*> own_data;
+    std::vector<BitVector*> own_data(2*after_.size(), NULL);
     orderings.fill_transitive(own_data, new_ordering);
     return &orderings;
   } else {
@@ -322,15 +422,15 @@ BinaryOrderings::refine(const Ordering& new_ordering,
                         const Bindings* bindings) const {
   if (new_step.id() != 0 && new_step.id() != Plan::GOAL_ID) {
     BinaryOrderings& orderings = *new BinaryOrderings(*this);
-    std::map<size_t, BoolVector*> own_data;
-    if (new_step.id() > before_.size() + 1) {
-      if (new_step.id() > 1) {
-        BoolVector* bv = new BoolVector(2*new_step.id() - 2, false);
-        own_data.insert(std::make_pair(orderings.before_.size(), bv));
-        orderings.before_.push_back(bv);
-        BoolVector::register_use(bv);
-      }
+    if (new_step.id() > after_.size()) {
+      /* The rows of a new step are empty until something is ordered
+         with respect to it. */
+      long old_bytes = orderings.row_bytes();
+      orderings.after_.resize(new_step.id(), NULL);
+      orderings.before_.resize(new_step.id(), NULL);
+      NodePool::Charge(orderings.row_bytes() - old_bytes);
     }
+    std::vector<BitVector*> own_data(2*orderings.after_.size(), NULL);
     if (new_ordering.before_id() != 0
         && new_ordering.after_id() != Plan::GOAL_ID) {
       orderings.fill_transitive(own_data, new_ordering);
@@ -347,7 +447,7 @@ BinaryOrderings::refine(const Ordering& new_ordering,
 float BinaryOrderings::schedule(std::map<size_t, float>& start_times,
                                 std::map<size_t, float>& end_times) const {
   float max_dist = 0.0f;
-  size_t n = before_.size() + 1;
+  size_t n = after_.size();
   for (size_t i = 1; i <= n; i++) {
     float ed = schedule(start_times, end_times, i);
     if (ed > max_dist) {
@@ -364,7 +464,7 @@ BinaryOrderings::makespan(const std::map<std::pair<size_t,
                           StepTime::StepPoint>, float>& min_times) const {
   std::map<size_t, float> start_times, end_times;
   float max_dist = 0.0f;
-  size_t n = before_.size() + 1;
+  size_t n = after_.size();
   for (size_t i = 1; i <= n; i++) {
     float ed = schedule(start_times, end_times, i, min_times);
     if (ed > max_dist) {
@@ -391,9 +491,9 @@ float BinaryOrderings::schedule(std::map<size_t, float>& start_times,
     return (*d).second;
   } else {
     float sd = 1.0f;
-    size_t n = before_.size() + 1;
-    for (size_t j = 1; j <= n; j++) {
-      if (step_id != j && before(j, step_id)) {
+    const BitVector* bv = before_[step_id - 1];
+    if (bv != NULL) {
+      for (size_t j = bv->next(0); j < bv->size(); j = bv->next(j + 1)) {
         float ed = 1.0f + schedule(start_times, end_times, j);
         if (ed > sd) {
           sd = ed;
@@ -418,9 +518,9 @@ BinaryOrderings::schedule(std::map<size_t, float>& start_times,
     return (*d).second;
   } else {
     float sd = threshold;
-    size_t n = before_.size() + 1;
-    for (size_t j = 1; j <= n; j++) {
-      if (step_id != j && before(j, step_id)) {
+    const BitVector* bv = before_[step_id - 1];
+    if (bv != NULL) {
+      for (size_t j = bv->next(0); j < bv->size(); j = bv->next(j + 1)) {
         float ed = threshold + schedule(start_times, end_times, j, min_times);
         if (ed > sd) {
           sd = ed;
@@ -446,74 +546,108 @@ BinaryOrderings::schedule(std::map<size_t, float>& start_times,
 
 /* Returns true iff the first step is ordered before the second step. */
 bool BinaryOrderings::before(size_t id1, size_t id2) const {
-  if (id1 == id2) {
+  if (id1 > after_.size()) {
     return false;
-  } else if (id1 < id2) {
-    return (*before_[id2 - 2])[id1 - 1];
-  } else {
-    return (*before_[id1 - 2])[2*id1 - 2 - id2];
   }
+  const BitVector* bv = after_[id1 - 1];
+  return bv != NULL && bv->test(id2);
 }
 
 
-/* Orders the first step before the second step. */
-void
-BinaryOrderings::set_before(std::map<size_t, BoolVector*>& own_data,
-                            size_t id1, size_t id2) {
-  if (id1 != id2) {
-    size_t i = std::max(id1, id2) - 2;
-    BoolVector* bv;
-    std::map<size_t, BoolVector*>::const_iterator vi = own_data.find(i);
-    if (vi != own_data.end()) {
-      bv = (*vi).second;
-    } else {
-      const BoolVector* old_bv = before_[i];
-      bv = new BoolVector(*old_bv);
-      BoolVector::register_use(bv);
-      BoolVector::unregister_use(old_bv);
-      before_[i] = bv;
-      own_data.insert(std::make_pair(i, bv));
-    }
-    if (id1 < id2) {
-      (*bv)[id1 - 1] = true;
-    } else {
-      (*bv)[2*id1 - 2 - id2] = true;
-    }
+/* Returns a row of the given matrix that this ordering collection
+   can modify, copying the row if it is shared. */
+BitVector*
+BinaryOrderings::own_row(std::vector<BitVector*>& own_data,
+                         std::vector<const BitVector*>& rows,
+                         size_t offset, size_t id) {
+  BitVector*& bv = own_data[offset + id - 1];
+  if (bv == NULL) {
+    const BitVector* old_bv = rows[id - 1];
+    bv = (old_bv != NULL) ? new BitVector(*old_bv) : new BitVector();
+    BitVector::register_use(bv);
+    BitVector::unregister_use(old_bv);
+    rows[id - 1] = bv;
   }
+  return bv;
 }
 
 
 /* Updates the transitive closure given a new ordering constraint. */
-void BinaryOrderings::fill_transitive(std::map<size_t, BoolVector*>& own_data,
+void BinaryOrderings::fill_transitive(std::vector<BitVector*>& own_data,
                                       const Ordering& ordering) {
   size_t i = ordering.before_id();
   size_t j = ordering.after_id();
   if (!before(i, j)) {
     /*
      * All steps ordered before i (and i itself) must be ordered
-     * before j and all steps ordered after j.
+     * before j and all steps ordered after j.  Each affected row is
+     * updated with a single union of whole words.
      */
-    size_t n = before_.size() + 1;
-    for (size_t k = 1; k <= n; k++) {
-      if ((k == i || before(k, i)) && !before(k, j)) {
-        for (size_t l = 1; l <= n; l++) {
-          if ((j == l || before(j, l)) && !before(k, l)) {
-            set_before(own_data, k, l);
-          }
-        }
+    BitVector preds = (before_[i - 1] != NULL) ? BitVector(*before_[i - 1])
+                                                 : BitVector();
+    preds.set(i);
+    BitVector succs = (after_[j - 1] != NULL) ? BitVector(*after_[j - 1])
+                                              : BitVector();
+    succs.set(j);
+    size_t n = after_.size();
+    for (size_t k = preds.next(0); k < preds.size(); k = preds.next(k + 1)) {
+      BitVector& row = *own_row(own_data, after_, 0, k);
+      row.set_union(succs);
+      row.reset(k);
+    }
+    for (size_t l = succs.next(0); l < succs.size(); l = succs.next(l + 1)) {
+      BitVector& row = *own_row(own_data, before_, n, l);
+      row.set_union(preds);
+      row.reset(l);
+    }
+  }
+}
+
+
+/* Returns the ids of the steps 1 to n, where n + 1 is the size of
+   the given map, in the order of their renamed ids. */
+static std::vector<size_t> renamed_order(const std::vector<size_t>& step_ids) {
+  std::vector<size_t> ids(step_ids.size());
+  for (size_t id = 1; id < step_ids.size(); id++) {
+    ids[step_ids[id]] = id;
+  }
+  return ids;
+}
+
+
+/* Appends to the given key the constraints of this ordering
+   collection, with step ids renamed by the given map. */
+void BinaryOrderings::key(std::vector<uint64_t>& key,
+                          const std::vector<size_t>& step_ids) const {
+  std::vector<size_t> ids = renamed_order(step_ids);
+  uint64_t bits = 0;
+  size_t num_bits = 0;
+  for (size_t i = 1; i < ids.size(); i++) {
+    for (size_t j = 1; j < ids.size(); j++) {
+      if (before(ids[i], ids[j])) {
+        bits |= uint64_t{1} << num_bits;
+      }
+      if (++num_bits == 64) {
+        key.push_back(bits);
+        bits = 0;
+        num_bits = 0;
       }
     }
   }
+  if (num_bits > 0) {
+    key.push_back(bits);
+  }
 }
 
 
 /* Prints this ordering collection on the given stream. */
 void BinaryOrderings::print(std::ostream& os) const {
   os << "{";
-  size_t n = before_.size() + 1;
+  size_t n = after_.size();
   for (size_t i = 1; i <= n; i++) {
-    for (size_t j = 1; j <= n; j++) {
-      if (before(i, j)) {
+    const BitVector* bv = after_[i - 1];
+    if (bv != NULL) {
+      for (size_t j = bv->next(0); j < bv->size(); j = bv->next(j + 1)) {
         os << ' ' << i << '<' << j;
       }
     }
@@ -538,6 +672,7 @@ TemporalOrderings::TemporalOrderings(const TemporalOrderings& o)
     IntVector::register_use(distance_[i]);
   }
   RCObject::ref(goal_achievers_);
+  NodePool::Charge(row_bytes());
 }
 
 
@@ -548,6 +683,22 @@ TemporalOrderings::~TemporalOrderings() {
     IntVector::unregister_use(distance_[i]);
   }
   RCObject::destructive_deref(goal_achievers_);
+  NodePool::Charge(-row_bytes());
+}
+
+
+/* Returns the number of bytes held by the row vector. */
+long TemporalOrderings::row_bytes() const {
+  return sizeof(const IntVector*)*distance_.capacity();
+}
+
+
+/* Appends the given row to the distance matrix. */
+void TemporalOrderings::add_row(IntVector* fv) {
+  long old_bytes = row_bytes();
+  distance_.push_back(fv);
+  IntVector::register_use(fv);
+  NodePool::Charge(row_bytes() - old_bytes);
 }
 
 
@@ -653,7 +804,7 @@ const TemporalOrderings* TemporalOrderings::refine(size_t step_id,
       return NULL;
     } else {
       TemporalOrderings& orderings = *new TemporalOrderings(*this);
-      std::map<size_t, IntVector*> own_data;
+      std::vector<IntVector*> own_data;
       if (orderings.fill_transitive(own_data, 0, i, start)
           && orderings.fill_transitive(own_data, 0, j, end)) {
         return &orderings;
@@ -685,8 +836,7 @@ TemporalOrderings::refine(float time, const Step& new_step) const {
       (*fv)[4*new_step.id() - 2*id - 2] = -t;
       (*fv)[4*new_step.id() - 2*id - 3] = -t;
     }
-    orderings.distance_.push_back(fv);
-    IntVector::register_use(fv);
+    orderings.add_row(fv);
     fv = new IntVector(4*new_step.id(), std::numeric_limits<int>::max());
     /* Time for end of new step. */
     (*fv)[0] = itime;
@@ -698,8 +848,7 @@ TemporalOrderings::refine(float time, const Step& new_step) const {
       (*fv)[4*new_step.id() - 2*id - 1] = -t;
     }
     (*fv)[2*new_step.id() - 1] = (*fv)[2*new_step.id()] = 0;
-    orderings.distance_.push_back(fv);
-    IntVector::register_use(fv);
+    orderings.add_row(fv);
     return &orderings;
   } else {
     return this;
@@ -717,7 +866,7 @@ TemporalOrderings::refine(const Ordering& new_ordering) const {
                              new_ordering.after_id(),
                              new_ordering.after_time())) {
     TemporalOrderings& orderings = *new TemporalOrderings(*this);
-    std::map<size_t, IntVector*> own_data;
+    std::vector<IntVector*> own_data;
     size_t i = time_node(new_ordering.before_id(), new_ordering.before_time());
     size_t j = time_node(new_ordering.after_id(), new_ordering.after_time());
     int dist;
@@ -745,7 +894,7 @@ TemporalOrderings::refine(const Ordering& new_ordering,
                           const Bindings* bindings) const {
   if (new_step.id() != 0 && new_step.id() != Plan::GOAL_ID) {
     TemporalOrderings& orderings = *new TemporalOrderings(*this);
-    std::map<size_t, IntVector*> own_data;
+    std::vector<IntVector*> own_data;
     if (new_step.id() > distance_.size()/2) {
       const Value* min_v =
         dynamic_cast<const Value*>(&new_step.action().min_duration());
@@ -776,9 +925,9 @@ TemporalOrderings::refine(const Ordering& new_ordering,
       IntVector* fv = new IntVector(4*new_step.id() - 2, std::numeric_limits<int>::max());
       /* Earliest time for start of new step. */
       (*fv)[4*new_step.id() - 3] = -int(start_time/threshold + 0.5);
-      own_data.insert(std::make_pair(orderings.distance_.size(), fv));
-      orderings.distance_.push_back(fv);
-      IntVector::register_use(fv);
+      orderings.add_row(fv);
+      own_data.resize(orderings.distance_.size(), NULL);
+      own_data.back() = fv;
       fv = new IntVector(4*new_step.id(), std::numeric_limits<int>::max());
       /* Earliest time for end of new step. */
       (*fv)[4*new_step.id() - 1] = -int(end_time/threshold + 0.5);
@@ -786,9 +935,9 @@ TemporalOrderings::refine(const Ordering& new_ordering,
         (*fv)[2*new_step.id() - 1] = int(max_v->value()/threshold + 0.5);
       }
       (*fv)[2*new_step.id()] = -int(min_v->value()/threshold + 0.5);
-      own_data.insert(std::make_pair(orderings.distance_.size(), fv));
-      orderings.distance_.push_back(fv);
-      IntVector::register_use(fv);
+      orderings.add_row(fv);
+      own_data.resize(orderings.distance_.size(), NULL);
+      own_data.back() = fv;
     }
     if (new_ordering.before_id() != 0) {
       if (new_ordering.after_id() != Plan::GOAL_ID) {
@@ -860,6 +1009,38 @@ TemporalOrderings::makespan(const std::map<std::pair<size_t,
 }
 
 
+/* Appends to the given key the constraints of this ordering
+   collection, with step ids renamed by the given map. */
+void TemporalOrderings::key(std::vector<uint64_t>& key,
+                            const std::vector<size_t>& step_ids) const {
+  std::vector<size_t> ids = renamed_order(step_ids);
+  std::vector<size_t> nodes(1, 0);
+  for (size_t i = 1; i < ids.size(); i++) {
+    nodes.push_back(time_node(ids[i], StepTime::AT_START));
+    nodes.push_back(time_node(ids[i], StepTime::AT_END));
+  }
+  for (size_t i = 0; i < nodes.size(); i++) {
+    for (size_t j = 0; j < nodes.size(); j++) {
+      if (i == j) {
+        continue;
+      } else if (std::max(nodes[i], nodes[j]) > distance_.size()) {
+        /* The step has not been added to this collection. */
+        key.push_back(std::numeric_limits<uint64_t>::max());
+      } else {
+        key.push_back(static_cast<uint32_t>(distance(nodes[i], nodes[j])));
+      }
+    }
+  }
+  std::vector<uint64_t> goal_achievers;
+  for (const Chain<size_t>* gc = goal_achievers_; gc != NULL; gc = gc->tail) {
+    goal_achievers.push_back(step_ids[gc->head]);
+  }
+  std::sort(goal_achievers.begin(), goal_achievers.end());
+  key.push_back(goal_achievers.size());
+  key.insert(key.end(), goal_achievers.begin(), goal_achievers.end());
+}
+
+
 /* Returns the maximum distance from the first and the second time node. */
 int TemporalOrderings::distance(size_t t1, size_t t2) const {
   if (t1 == t2) {
@@ -873,21 +1054,20 @@ int TemporalOrderings::distance(size_t t1, size_t t2) const {
 
 
 /* Sets the maximum distance from the first and the second time node. */
-void TemporalOrderings::set_distance(std::map<size_t, IntVector*>& own_data,
+void TemporalOrderings::set_distance(std::vector<IntVector*>& own_data,
                                      size_t t1, size_t t2, int d) {
   if (t1 != t2) {
     size_t i = std::max(t1, t2) - 1;
-    IntVector* fv;
-    std::map<size_t, IntVector*>::const_iterator vi = own_data.find(i);
-    if (vi != own_data.end()) {
-      fv = (*vi).second;
-    } else {
+    if (i >= own_data.size()) {
+      own_data.resize(distance_.size(), NULL);
+    }
+    IntVector*& fv = own_data[i];
+    if (fv == NULL) {
       const IntVector* old_fv = distance_[i];
       fv = new IntVector(*old_fv);
       IntVector::register_use(fv);
       IntVector::unregister_use(old_fv);
       distance_[i] = fv;
-      own_data.insert(std::make_pair(i, fv));
     }
     if (t1 < t2) {
       (*fv)[t1] = d;
@@ -900,26 +1080,42 @@ void TemporalOrderings::set_distance(std::map<size_t, IntVector*>& own_data,
 
 /* Updates the transitive closure given a new ordering constraint. */
 bool
-TemporalOrderings::fill_transitive(std::map<size_t, IntVector*>& own_data,
+TemporalOrderings::fill_transitive(std::vector<IntVector*>& own_data,
                                    size_t i, size_t j, int dist) {
   if (distance(j, i) > -dist) {
     /*
      * Update the temporal constraints.
      *
+     * A distance d_lk can only shrink through the new edge if it
+     * shrinks d_jk and d_li as well, so only the nodes k that get
+     * closer to j and the nodes l that get closer to i are visited.
+     *
      * Make sure that -d_ij <= d_ji always holds.
      */
+    const int inf = std::numeric_limits<int>::max();
     size_t n = distance_.size();
+    std::vector<std::pair<size_t, int> > targets;
+    std::vector<std::pair<size_t, int> > sources;
     for (size_t k = 0; k <= n; k++) {
       int d_ik = distance(i, k);
-      if (d_ik < std::numeric_limits<int>::max() && distance(j, k) > d_ik - dist) {
-        for (size_t l = 0; l <= n; l++) {
-          int d_lj = distance(l, j);
-          int new_d = d_ik + d_lj - dist;
-          if (d_lj < std::numeric_limits<int>::max() && distance(l, k) > new_d) {
-            set_distance(own_data, l, k, new_d);
-            if (-distance(k, l) > new_d) {
-              return false;
-            }
+      if (d_ik < inf && distance(j, k) > d_ik - dist) {
+        targets.push_back(std::make_pair(k, d_ik));
+      }
+      int d_kj = distance(k, j);
+      if (d_kj < inf && distance(k, i) > d_kj - dist) {
+        sources.push_back(std::make_pair(k, d_kj));
+      }
+    }
+    for (size_t ki = 0; ki < targets.size(); ki++) {
+      size_t k = targets[ki].first;
+      int d_ik = targets[ki].second;
+      for (size_t li = 0; li < sources.size(); li++) {
+        size_t l = sources[li].first;
+        int new_d = d_ik + sources[li].second - dist;
+        if (distance(l, k) > new_d) {
+          set_distance(own_data, l, k, new_d);
+          if (-distance(k, l) > new_d) {
+            return false;
           }
         }
       }
@@ -22,11 +22,14 @@
 #ifndef ORDERINGS_H
 #define ORDERINGS_H
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <vector>
 
 #include "chain.h"
 #include "formulas.h"
+#include "src/node-pool.h"
 
 struct Effect;
 struct Step;
@@ -121,24 +124,25 @@ private:
 /* Orderings */
 
 /*
- * Collection of ordering constraints.
+ * Collection of ordering constraints.  Ordering collections come from
+ * the node pool, and the memory of their rows counts as in use in the
+ * arena of the search that creates them.
  */
-struct Orderings {
+struct Orderings : public PooledObject {
   /* Minimum distance between two ordered steps. */
   static float threshold;
 
   /* Register use of this object. */
   static void register_use(const Orderings* o) {
     if (o != NULL) {
-      o->ref_count_++;
+      o->ref_count_.fetch_add(1, std::memory_order_relaxed);
     }
   }
 
   /* Unregister use of this object. */
   static void unregister_use(const Orderings* o) {
     if (o != NULL) {
-      o->ref_count_--;
-      if (o->ref_count_ == 0) {
+      if (o->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
         delete o;
       }
     }
@@ -187,6 +191,13 @@ struct Orderings {
   virtual float makespan(const std::map<std::pair<size_t,
                          StepTime::StepPoint>, float>& min_times) const = 0;
 
+  /* Appends to the given key the constraints of this ordering
+     collection, with each step id renamed to the id at that index of
+     the given map.  Collections with the same constraints after
+     renaming append the same values. */
+  virtual void key(std::vector<uint64_t>& key,
+                   const std::vector<size_t>& step_ids) const = 0;
+
 protected:
   /* Constructs an empty ordering collection. */
   Orderings();
@@ -199,7 +210,7 @@ protected:
 
 private:
   /* Reference counter. */
-  mutable size_t ref_count_;
+  mutable std::atomic<size_t> ref_count_;
 
   friend std::ostream& operator<<(std::ostream& os, const Orderings& o);
 };
@@ -211,7 +222,7 @@ std::ostream& operator<<(std::ostream& os, const Orderings& o);
 /* ====================================================================== */
 /* BinaryOrderings */
 
-struct BoolVector;
+struct BitVector;
 
 /*
  * Collection of binary ordering constraints.
@@ -263,18 +274,31 @@ struct BinaryOrderings : public Orderings {
   virtual float makespan(const std::map<std::pair<size_t,
                          StepTime::StepPoint>, float>& min_times) const;
 
+  /* Appends to the given key the constraints of this ordering
+     collection, with step ids renamed by the given map. */
+  virtual void key(std::vector<uint64_t>& key,
+                   const std::vector<size_t>& step_ids) const;
+
 protected:
   /* Prints this object on the given stream. */
   virtual void print(std::ostream& os) const;
 
 private:
   /* Matrix representing the transitive closure of the ordering
-     constraints. */
-  std::vector<const BoolVector*> before_;
+     constraints; row i-1 has bit j set iff step i is ordered before
+     step j.  Rows are shared between ordering collections until
+     modified, and a NULL row is empty. */
+  std::vector<const BitVector*> after_;
+  /* Transpose of the above matrix; row j-1 has bit i set iff step i
+     is ordered before step j. */
+  std::vector<const BitVector*> before_;
 
   /* Constructs a copy of this ordering collection. */
   BinaryOrderings(const BinaryOrderings& o);
 
+  /* Returns the number of bytes held by the row vectors. */
+  long row_bytes() const;
+
   /* Schedules the given instruction with the given constraints. */
   float schedule(std::map<size_t, float>& start_times,
                  std::map<size_t, float>& end_times, size_t step_id) const;
@@ -288,12 +312,14 @@ private:
   /* Returns true iff the first step is ordered before the second step. */
   bool before(size_t id1, size_t id2) const;
 
-  /* Orders the first step before the second step. */
-  void set_before(std::map<size_t, BoolVector*>& own_data,
-                  size_t id1, size_t id2);
+  /* Returns a row of the given matrix that this ordering collection
+     can modify, copying the row if it is shared. */
+  static BitVector* own_row(std::vector<BitVector*>& own_data,
+                            std::vector<const BitVector*>& rows,
+                            size_t offset, size_t id);
 
   /* Updates the transitive closure given a new ordering constraint. */
-  void fill_transitive(std::map<size_t, BoolVector*>& own_data,
+  void fill_transitive(std::vector<BitVector*>& own_data,
                        const Ordering& ordering);
 };
 
@@ -360,6 +386,11 @@ struct TemporalOrderings : public Orderings {
   virtual float makespan(const std::map<std::pair<size_t,
                          StepTime::StepPoint>, float>& min_times) const;
 
+  /* Appends to the given key the constraints of this ordering
+     collection, with step ids renamed by the given map. */
+  virtual void key(std::vector<uint64_t>& key,
+                   const std::vector<size_t>& step_ids) const;
+
 protected:
   /* Prints this opbject on the given stream. */
   virtual void print(std::ostream& os) const;
@@ -373,6 +404,12 @@ private:
   /* Constructs a copy of this ordering collection. */
   TemporalOrderings(const TemporalOrderings& o);
 
+  /* Returns the number of bytes held by the row vector. */
+  long row_bytes() const;
+
+  /* Appends the given row to the distance matrix. */
+  void add_row(IntVector* fv);
+
   /* Returns the time node for the given step. */
   size_t time_node(size_t id, StepTime t) const {
     return (t.point == StepTime::START) ? 2*id - 1: 2*id;
@@ -382,11 +419,11 @@ private:
   int distance(size_t t1, size_t t2) const;
 
   /* Sets the maximum distance from the first and the second time node. */
-  void set_distance(std::map<size_t, IntVector*>& own_data,
+  void set_distance(std::vector<IntVector*>& own_data,
                     size_t t1, size_t t2, int d);
 
   /* Updates the transitive closure given a new ordering constraint. */
-  bool fill_transitive(std::map<size_t, IntVector*>& own_data,
+  bool fill_transitive(std::vector<IntVector*>& own_data,
                        size_t i, size_t j, int dist);
 };
 
@@ -51,7 +51,15 @@ Parameters::Parameters()
       random_open_conditions(false),
       ground_actions(false),
       domain_constraints(false),
-      keep_static_preconditions(true) {
+      keep_static_preconditions(true),
+      search_threads(1),
+      grounding_threads(1),
+      portfolio(false),
+      prune_duplicates(false),
+      deferred_evaluation(false),
+      anytime(false),
+      action_cache_key(0),
+      memory_limit(std::numeric_limits<size_t>::max()) {
   flaw_orders.push_back(FlawSelectionOrder("UCPOP")),
   search_limits.push_back(std::numeric_limits<unsigned int>::max());
 }
@@ -23,6 +23,7 @@
 #define PARAMETERS_H
 
 #include <chrono>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -87,6 +88,27 @@ struct Parameters {
   bool domain_constraints;
   /* Whether to keep static preconditions when using domain constraints. */
   bool keep_static_preconditions;
+  /* Number of threads to use for expanding plans. */
+  int search_threads;
+  /* Number of threads to use for grounding and the planning graph. */
+  int grounding_threads;
+  /* Whether to run the flaw selection orders concurrently. */
+  bool portfolio;
+  /* Whether to prune generated plans that duplicate earlier ones. */
+  bool prune_duplicates;
+  /* Whether to rank generated plans only when they are selected. */
+  bool deferred_evaluation;
+  /* Whether to keep searching for plans with shorter makespan. */
+  bool anytime;
+  /* File recording the useful ground actions of the problem between
+     runs, or empty if they are not recorded. */
+  std::string action_cache;
+  /* Key identifying the problem in the action cache file. */
+  uint64_t action_cache_key;
+  /* Number of bytes that the plans of a problem, with their chains,
+     bindings and orderings, may occupy before the worst pending plans
+     are evicted. */
+  size_t memory_limit;
 
   /* Constructs default planning parameters. */
   Parameters();
@@ -0,0 +1,84 @@
+// Copyright (C) 2002--2005 Carnegie Mellon University
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+// PDDL parser.
+
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+struct Domain;
+struct Problem;
+struct ParseState;
+
+
+/* ====================================================================== */
+/* PddlParser */
+
+/*
+ * A parser for PDDL domain and problem definitions.  Each parser has
+ * its own scanner and parse state, so parsers on different threads can
+ * parse different sources at the same time.  Domains are defined as
+ * soon as they are parsed, so a source that defines domains should not
+ * be parsed while other sources are parsed.
+ */
+struct PddlParser {
+  /* Constructs a parser for the source with the given name, which
+     reports errors and warnings on the given stream. */
+  PddlParser(const std::string& name, std::ostream& messages);
+
+  /* Deletes this parser. */
+  ~PddlParser();
+
+  /* Parses the given buffer in place, and returns true on success.
+     The last two bytes of the buffer must be zero. */
+  bool parse(char* buffer, size_t size);
+
+  /* Parses the given file, and returns true on success. */
+  bool parse(FILE* file);
+
+  /* Returns the domains defined by the parsed source, in order. */
+  const std::vector<const Domain*>& domains() const;
+
+  /* Returns the problems defined by the parsed source, in order.  The
+     problems are not added to the table of problems, so the caller
+     should either add or delete them. */
+  const std::vector<const Problem*>& problems() const;
+
+  /* Returns a shared hold on the tables of types, constants,
+     predicates, and functions that parsers add to.  While it is held,
+     parsers can read the tables but have to wait to change them. */
+  static std::shared_lock<std::shared_mutex> read_tables();
+
+ private:
+  /* State of the parser. */
+  ParseState* state_;
+
+  PddlParser(const PddlParser&) = delete;
+  PddlParser& operator=(const PddlParser&) = delete;
+};
+
+
+#endif /* PARSER_H */
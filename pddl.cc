@@ -55,7 +55,7 @@
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 2
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -69,14 +69,19 @@
 /* First part of user prologue.  */
 #line 23 "pddl.yy"
 
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <typeinfo>
 #include <utility>
 
 #include <config.h>
 
 #include "domains.h"
+#include "parser.h"
 #include "formulas.h"
 #include "functions.h"
 #include "predicates.h"
@@ -133,134 +138,191 @@ private:
 };
 
 
+/* Kind of name map being parsed. */
+enum NameKind { TYPE_KIND, CONSTANT_KIND, OBJECT_KIND, VOID_KIND };
+
+/*
+ * State of a single parse.  Each parse has its own state, so that
+ * several sources can be parsed at the same time.
+ */
+struct ParseState {
+  /* Constructs the state for parsing the source with the given name. */
+  ParseState(const std::string& name, std::ostream& messages);
+
+  /* Name of the source being parsed. */
+  std::string name;
+  /* Stream for error and warning messages. */
+  std::ostream* messages;
+  /* Current line number. */
+  size_t line_number;
+  /* Shared hold on the predicate, function, and type tables. */
+  std::shared_lock<std::shared_mutex> tables_lock;
+  /* Domains defined by the source. */
+  std::vector<const Domain*> defined_domains;
+  /* Problems defined by the source. */
+  std::vector<const Problem*> defined_problems;
+
+  /* Whether the last parsing attempt succeeded. */
+  bool success;
+  /* Current domain. */
+  Domain* domain;
+  /* Problem being parsed, or 0 if no problem is being parsed. */
+  Problem* problem;
+  /* Current requirements. */
+  PddlRequirements* requirements;
+  /* Predicate being parsed. */
+  const Predicate* predicate;
+  /* Whether predicate declaration is repeated. */
+  bool repeated_predicate;
+  /* Function being parsed. */
+  const Function* function;
+  /* Whether function declaration is repeated. */
+  bool repeated_function;
+  /* Action being parsed, or 0 if no action is being parsed. */
+  ActionSchema* action;
+  /* Time of current condition. */
+  FormulaTime formula_time;
+  /* Time of current effect. */
+  Effect::EffectTime effect_time;
+  /* Condition for effect being parsed, or 0 if unconditional effect. */
+  const Formula* effect_condition;
+  /* Current variable context. */
+  Context context;
+  /* Predicate for atomic formula being parsed. */
+  const Predicate* atom_predicate;
+  /* Whether the predicate of the currently parsed atom was undeclared. */
+  bool undeclared_atom_predicate;
+  /* Whether parsing metric fluent. */
+  bool metric_fluent;
+  /* Function for fluent being parsed. */
+  const Function* fluent_function;
+  /* Whether the function of the currently parsed fluent was undeclared. */
+  bool undeclared_fluent_function;
+  /* Paramerers for atomic formula or fluent being parsed. */
+  std::vector<Term> term_parameters;
+  /* Quantified variables for effect or formula being parsed. */
+  std::vector<Term> quantified;
+  /* Kind of name map being parsed. */
+  NameKind name_kind;
+
+  /* Outputs an error message. */
+  void error(const std::string& s);
+  /* Outputs a warning message. */
+  void warning(const std::string& s);
+  /* Creates an empty domain with the given name. */
+  void make_domain(const std::string* name);
+  /* Creates an empty problem with the given name. */
+  void make_problem(const std::string* name, const std::string* domain_name);
+  /* Adds :typing to the requirements. */
+  void require_typing();
+  /* Adds :fluents to the requirements. */
+  void require_fluents();
+  /* Adds :disjunctive-preconditions to the requirements. */
+  void require_disjunction();
+  /* Adds :duration-inequalities to the requirements. */
+  void require_duration_inequalities();
+  /* Returns a simple type with the given name. */
+  const Type& make_type(const std::string* name);
+  /* Returns the union of the given types. */
+  Type make_type(const std::set<Type>& types);
+  /* Returns a simple term with the given name. */
+  Term make_term(const std::string* name);
+  /* Creates a predicate with the given name. */
+  void make_predicate(const std::string* name);
+  /* Creates a function with the given name. */
+  void make_function(const std::string* name);
+  /* Creates an action with the given name. */
+  void make_action(const std::string* name, bool durative);
+  /* Adds the current action to the current domain. */
+  void add_action();
+  /* Prepares for the parsing of a universally quantified effect. */
+  void prepare_forall_effect();
+  /* Prepares for the parsing of a conditional effect. */
+  void prepare_conditional_effect(const Formula& condition);
+  /* Adds types, constants, or objects to the current domain or problem. */
+  void add_names(const std::vector<const std::string*>* names,
+                 const Type& type);
+  /* Adds variables to the current variable list. */
+  void add_variables(const std::vector<const std::string*>* names,
+                     const Type& type);
+  /* Prepares for the parsing of an atomic formula. */
+  void prepare_atom(const std::string* name);
+  /* Prepares for the parsing of a fluent. */
+  void prepare_fluent(const std::string* name);
+  /* Adds a term with the given name to the current atomic formula. */
+  void add_term(const std::string* name);
+  /* Creates the atomic formula just parsed. */
+  const Atom* make_atom();
+  /* Creates the fluent just parsed. */
+  const Fluent* make_fluent();
+  /* Creates a subtraction. */
+  const Expression* make_subtraction(const Expression& term,
+                                     const Expression* opt_term);
+  /* Creates an equality formula. */
+  const Formula* make_equality(const Term* term1, const Term* term2);
+  /* Creates a negation. */
+  const Formula* make_negation(const Formula& negand);
+  /* Prepares for the parsing of an existentially quantified formula. */
+  void prepare_exists();
+  /* Prepares for the parsing of a universally quantified formula. */
+  void prepare_forall();
+  /* Creates an existentially quantified formula. */
+  const Formula* make_exists(const Formula& body);
+  /* Creates a universally quantified formula. */
+  const Formula* make_forall(const Formula& body);
+  /* Adds the given literal as an effect to the currect action. */
+  void add_effect(const Literal& literal);
+  /* Pops the top-most universally quantified variables. */
+  void pop_forall_effect();
+  /* Adds a timed initial literal to the current problem. */
+  void add_init_literal(float time, const Literal& literal);
+};
+
+
+/*
+ * Exclusive hold on the predicate, function, and type tables for the
+ * lifetime of this object.  The tables are shared by all parses, so a
+ * parse holds them shared and trades up to an exclusive hold whenever
+ * it adds to them.
+ */
+struct TableWriter {
+  explicit TableWriter(ParseState& state);
+  ~TableWriter();
+
+private:
+  /* State of the parse holding the tables. */
+  ParseState& state_;
+  /* Whether the shared hold was traded for an exclusive one. */
+  bool traded_;
+};
+
+
+union YYSTYPE;
 /* The lexer. */
-extern int yylex();
-/* Current line number. */
-extern size_t line_number;
-/* Name of current file. */
-extern std::string current_file;
+extern int yylex(YYSTYPE* lvalp, void* scanner);
+/* Input buffer of a scanner. */
+typedef struct yy_buffer_state* YY_BUFFER_STATE;
+/* Creates a scanner that counts lines in the given variable. */
+extern int yylex_init_extra(size_t* line_number, void** scanner);
+/* Starts scanning the given buffer in place.  The last two bytes of
+   the buffer must be zero. */
+extern YY_BUFFER_STATE yy_scan_buffer(char* base, size_t size, void* scanner);
+/* Starts scanning the given file. */
+extern void yyset_in(FILE* file, void* scanner);
+/* Deletes the given scanner and its input buffers. */
+extern int yylex_destroy(void* scanner);
 /* Level of warnings. */
 extern int warning_level;
 
-/* Whether the last parsing attempt succeeded. */
-static bool success = true;
-/* Current domain. */
-static Domain* domain;
+/* Guards the predicate, function, and type tables. */
+static std::shared_mutex tables_mutex;
 /* Domains. */
 static std::map<std::string, Domain*> domains;
-/* Problem being parsed, or 0 if no problem is being parsed. */
-static Problem* problem;
-/* Current requirements. */
-static PddlRequirements* requirements;
-/* Predicate being parsed. */
-static const Predicate* predicate;
-/* Whether predicate declaration is repeated. */
-static bool repeated_predicate;
-/* Function being parsed. */
-static const Function* function;
-/* Whether function declaration is repeated. */
-static bool repeated_function;
-/* Action being parsed, or 0 if no action is being parsed. */
-static ActionSchema* action;
-/* Time of current condition. */
-static FormulaTime formula_time;
-/* Time of current effect. */
-static Effect::EffectTime effect_time;
-/* Condition for effect being parsed, or 0 if unconditional effect. */
-static const Formula* effect_condition;
-/* Current variable context. */
-static Context context;
-/* Predicate for atomic formula being parsed. */
-static const Predicate* atom_predicate;
-/* Whether the predicate of the currently parsed atom was undeclared. */
-static bool undeclared_atom_predicate;
-/* Whether parsing metric fluent. */
-static bool metric_fluent;
-/* Function for fluent being parsed. */
-static const Function* fluent_function;
-/* Whether the function of the currently parsed fluent was undeclared. */
-static bool undeclared_fluent_function;
-/* Paramerers for atomic formula or fluent being parsed. */
-static std::vector<Term> term_parameters;
-/* Quantified variables for effect or formula being parsed. */
-static std::vector<Term> quantified;
-/* Kind of name map being parsed. */
-static enum { TYPE_KIND, CONSTANT_KIND, OBJECT_KIND, VOID_KIND } name_kind;
 
-/* Outputs an error message. */
-static void yyerror(const std::string& s);
-/* Outputs a warning message. */
-static void yywarning(const std::string& s);
-/* Creates an empty domain with the given name. */
-static void make_domain(const std::string* name);
-/* Creates an empty problem with the given name. */
-static void make_problem(const std::string* name,
-                         const std::string* domain_name);
-/* Adds :typing to the requirements. */
-static void require_typing();
-/* Adds :fluents to the requirements. */
-static void require_fluents();
-/* Adds :disjunctive-preconditions to the requirements. */
-static void require_disjunction();
-/* Adds :duration-inequalities to the requirements. */
-static void require_duration_inequalities();
-/* Returns a simple type with the given name. */
-static const Type& make_type(const std::string* name);
-/* Returns the union of the given types. */
-static Type make_type(const std::set<Type>& types);
-/* Returns a simple term with the given name. */
-static Term make_term(const std::string* name);
-/* Creates a predicate with the given name. */
-static void make_predicate(const std::string* name);
-/* Creates a function with the given name. */
-static void make_function(const std::string* name);
-/* Creates an action with the given name. */
-static void make_action(const std::string* name, bool durative);
-/* Adds the current action to the current domain. */
-static void add_action();
-/* Prepares for the parsing of a universally quantified effect. */
-static void prepare_forall_effect();
-/* Prepares for the parsing of a conditional effect. */
-static void prepare_conditional_effect(const Formula& condition);
-/* Adds types, constants, or objects to the current domain or problem. */
-static void add_names(const std::vector<const std::string*>* names,
-                      const Type& type);
-/* Adds variables to the current variable list. */
-static void add_variables(const std::vector<const std::string*>* names,
-                          const Type& type);
-/* Prepares for the parsing of an atomic formula. */
-static void prepare_atom(const std::string* name);
-/* Prepares for the parsing of a fluent. */
-static void prepare_fluent(const std::string* name);
-/* Adds a term with the given name to the current atomic formula. */
-static void add_term(const std::string* name);
-/* Creates the atomic formula just parsed. */
-static const Atom* make_atom();
-/* Creates the fluent just parsed. */
-static const Fluent* make_fluent();
-/* Creates a subtraction. */
-static const Expression* make_subtraction(const Expression& term,
-                                          const Expression* opt_term);
-/* Creates an equality formula. */
-static const Formula* make_equality(const Term* term1, const Term* term2);
-/* Creates a negation. */
-static const Formula* make_negation(const Formula& negand);
-/* Prepares for the parsing of an existentially quantified formula. */
-static void prepare_exists();
-/* Prepares for the parsing of a universally quantified formula. */
-static void prepare_forall();
-/* Creates an existentially quantified formula. */
-static const Formula* make_exists(const Formula& body);
-/* Creates a universally quantified formula. */
-static const Formula* make_forall(const Formula& body);
-/* Adds the given literal as an effect to the currect action. */
-static void add_effect(const Literal& literal);
-/* Pops the top-most universally quantified variables. */
-static void pop_forall_effect();
-/* Adds a timed initial literal to the current problem. */
-static void add_init_literal(float time, const Literal& literal);
+/* Outputs a syntax error message. */
+static void yyerror(ParseState& state, void* scanner, const std::string& s);
 
-#line 264 "pddl.cc"
+#line 326 "pddl.cc"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -437,7 +499,7 @@ extern int yydebug;
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 228 "pddl.yy"
+#line 294 "pddl.yy"
 
   const Formula* formula;
   const Literal* literal;
@@ -451,7 +513,7 @@ union YYSTYPE
   std::vector<const std::string*>* strs;
   float num;
 
-#line 455 "pddl.cc"
+#line 517 "pddl.cc"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -460,10 +522,9 @@ typedef union YYSTYPE YYSTYPE;
 #endif
 
 
-extern YYSTYPE yylval;
 
 
-int yyparse (void);
+int yyparse (ParseState& state, void* scanner);
 
 
 #endif /* !YY_YY_PDDL_HH_INCLUDED  */
@@ -1086,40 +1147,40 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   262,   262,   262,   266,   267,   268,   275,   275,   279,
-     280,   281,   282,   285,   286,   287,   290,   291,   292,   293,
-     294,   295,   296,   299,   300,   301,   302,   303,   306,   307,
-     308,   309,   310,   313,   314,   315,   316,   317,   320,   321,
-     322,   325,   326,   327,   330,   331,   332,   335,   336,   339,
-     342,   345,   346,   349,   350,   351,   353,   355,   356,   358,
-     360,   362,   363,   364,   365,   366,   368,   373,   377,   377,
-     381,   381,   385,   388,   388,   395,   396,   399,   399,   403,
-     404,   405,   408,   409,   412,   412,   415,   415,   423,   423,
-     425,   425,   430,   431,   434,   435,   438,   439,   442,   442,
-     446,   446,   449,   450,   453,   454,   461,   462,   466,   471,
-     476,   480,   481,   489,   490,   493,   494,   497,   497,   498,
-     498,   499,   499,   506,   507,   508,   508,   510,   511,   510,
-     515,   516,   519,   520,   523,   524,   528,   529,   532,   533,
-     534,   534,   536,   536,   540,   541,   545,   544,   548,   547,
-     552,   553,   554,   554,   556,   556,   560,   561,   569,   568,
-     573,   574,   577,   578,   581,   582,   585,   585,   589,   592,
-     593,   596,   596,   598,   598,   600,   602,   604,   608,   609,
-     612,   615,   615,   617,   617,   625,   626,   627,   628,   629,
-     629,   630,   630,   632,   632,   634,   634,   638,   639,   642,
-     643,   646,   646,   650,   650,   654,   655,   662,   663,   664,
-     665,   666,   667,   670,   671,   674,   674,   676,   679,   680,
-     682,   684,   686,   688,   691,   692,   695,   695,   697,   704,
-     705,   706,   709,   710,   713,   714,   717,   718,   719,   719,
-     723,   724,   727,   728,   729,   729,   732,   733,   736,   736,
-     739,   740,   741,   744,   745,   746,   747,   750,   757,   760,
-     763,   766,   769,   772,   775,   778,   781,   784,   787,   790,
-     793,   796,   799,   802,   805,   808,   811,   814,   817,   820,
-     820,   820,   821,   822,   822,   822,   822,   822,   823,   823,
-     823,   824,   827,   828,   828,   831,   831,   831,   832,   833,
-     833,   833,   833,   834,   834,   834,   835,   836,   836,   839,
-     842,   842,   842,   843,   843,   843,   844,   844,   844,   844,
-     844,   844,   844,   845,   845,   845,   845,   845,   846,   846,
-     846,   847,   850
+       0,   328,   328,   328,   333,   334,   335,   342,   342,   346,
+     347,   348,   349,   352,   353,   354,   357,   358,   359,   360,
+     361,   362,   363,   366,   367,   368,   369,   370,   373,   374,
+     375,   376,   377,   380,   381,   382,   383,   384,   387,   388,
+     389,   392,   393,   394,   397,   398,   399,   402,   403,   406,
+     409,   412,   413,   416,   417,   418,   420,   422,   423,   425,
+     427,   429,   431,   432,   433,   434,   436,   441,   445,   445,
+     449,   449,   454,   457,   457,   464,   465,   468,   468,   472,
+     473,   474,   477,   478,   481,   481,   484,   484,   492,   492,
+     494,   494,   499,   500,   503,   504,   507,   508,   511,   511,
+     515,   515,   518,   519,   522,   523,   530,   531,   535,   540,
+     545,   549,   550,   558,   559,   562,   563,   566,   566,   568,
+     568,   570,   570,   578,   579,   580,   580,   583,   584,   583,
+     588,   589,   592,   593,   596,   597,   601,   602,   605,   606,
+     607,   607,   609,   609,   613,   614,   618,   617,   624,   623,
+     631,   632,   633,   633,   635,   635,   639,   640,   648,   647,
+     652,   653,   656,   657,   660,   661,   664,   664,   668,   671,
+     672,   675,   675,   677,   677,   679,   681,   683,   687,   688,
+     691,   694,   694,   700,   700,   712,   714,   715,   716,   717,
+     717,   718,   718,   720,   720,   722,   722,   726,   727,   730,
+     731,   734,   734,   738,   738,   742,   743,   750,   751,   752,
+     753,   754,   755,   758,   759,   762,   762,   764,   767,   768,
+     770,   772,   774,   776,   779,   780,   783,   783,   785,   793,
+     794,   795,   798,   799,   802,   803,   806,   807,   808,   808,
+     812,   813,   816,   817,   818,   818,   822,   823,   826,   826,
+     829,   830,   831,   834,   835,   837,   838,   841,   848,   851,
+     854,   857,   860,   863,   866,   869,   872,   875,   878,   881,
+     884,   887,   890,   893,   896,   899,   902,   905,   908,   911,
+     911,   911,   912,   913,   913,   913,   913,   913,   914,   914,
+     914,   915,   918,   919,   919,   922,   922,   922,   923,   924,
+     924,   924,   924,   925,   925,   925,   926,   927,   927,   930,
+     933,   933,   933,   934,   934,   934,   935,   935,   935,   935,
+     935,   935,   935,   936,   936,   936,   936,   936,   937,   937,
+     937,   938,   941
 };
 #endif
 
@@ -1733,7 +1794,7 @@ enum { YYENOMEM = -2 };
       }                                                           \
     else                                                          \
       {                                                           \
-        yyerror (YY_("syntax error: cannot back up")); \
+        yyerror (state, scanner, YY_("syntax error: cannot back up")); \
         YYERROR;                                                  \
       }                                                           \
   while (0)
@@ -1766,7 +1827,7 @@ do {                                                                      \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Kind, Value); \
+                  Kind, Value, state, scanner); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -1778,10 +1839,12 @@ do {                                                                      \
 
 static void
 yy_symbol_value_print (FILE *yyo,
-                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, ParseState& state, void* scanner)
 {
   FILE *yyoutput = yyo;
   YY_USE (yyoutput);
+  YY_USE (state);
+  YY_USE (scanner);
   if (!yyvaluep)
     return;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
@@ -1796,12 +1859,12 @@ yy_symbol_value_print (FILE *yyo,
 
 static void
 yy_symbol_print (FILE *yyo,
-                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, ParseState& state, void* scanner)
 {
   YYFPRINTF (yyo, "%s %s (",
              yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  yy_symbol_value_print (yyo, yykind, yyvaluep, state, scanner);
   YYFPRINTF (yyo, ")");
 }
 
@@ -1835,7 +1898,7 @@ do {                                                            \
 
 static void
 yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
-                 int yyrule)
+                 int yyrule, ParseState& state, void* scanner)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -1848,7 +1911,7 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
                        YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
-                       &yyvsp[(yyi + 1) - (yynrhs)]);
+                       &yyvsp[(yyi + 1) - (yynrhs)], state, scanner);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1856,7 +1919,7 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
 # define YY_REDUCE_PRINT(Rule)          \
 do {                                    \
   if (yydebug)                          \
-    yy_reduce_print (yyssp, yyvsp, Rule); \
+    yy_reduce_print (yyssp, yyvsp, Rule, state, scanner); \
 } while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
@@ -1897,9 +1960,11 @@ int yydebug;
 
 static void
 yydestruct (const char *yymsg,
-            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, ParseState& state, void* scanner)
 {
   YY_USE (yyvaluep);
+  YY_USE (state);
+  YY_USE (scanner);
   if (!yymsg)
     yymsg = "Deleting";
   YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
@@ -1910,13 +1975,6 @@ yydestruct (const char *yymsg,
 }
 
 
-/* Lookahead token kind.  */
-int yychar;
-
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval;
-/* Number of syntax errors so far.  */
-int yynerrs;
 
 
 
@@ -1926,8 +1984,21 @@ int yynerrs;
 `----------*/
 
 int
-yyparse (void)
+yyparse (ParseState& state, void* scanner)
 {
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
     yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
     int yyerrstatus = 0;
@@ -2080,7 +2151,7 @@ yybackup:
   if (yychar == YYEMPTY)
     {
       YYDPRINTF ((stderr, "Reading a token\n"));
-      yychar = yylex ();
+      yychar = yylex (&yylval, scanner);
     }
 
   if (yychar <= YYEOF)
@@ -2168,1012 +2239,1024 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* $@1: %empty  */
-#line 262 "pddl.yy"
-            { success = true; line_number = 1; }
-#line 2174 "pddl.cc"
+#line 328 "pddl.yy"
+            { state.success = true; state.line_number = 1; }
+#line 2245 "pddl.cc"
     break;
 
   case 3: /* pddl_file: $@1 domains_and_problems  */
-#line 263 "pddl.yy"
-              { if (!success) YYERROR; }
-#line 2180 "pddl.cc"
+#line 330 "pddl.yy"
+              { if (!state.success) YYERROR; }
+#line 2251 "pddl.cc"
     break;
 
   case 7: /* $@2: %empty  */
-#line 275 "pddl.yy"
-                                            { make_domain((yyvsp[-1].str)); }
-#line 2186 "pddl.cc"
+#line 342 "pddl.yy"
+                                            { state.make_domain((yyvsp[-1].str)); }
+#line 2257 "pddl.cc"
     break;
 
   case 54: /* require_key: TYPING  */
-#line 350 "pddl.yy"
-                     { requirements->EnableTyping(); }
-#line 2192 "pddl.cc"
+#line 417 "pddl.yy"
+                     { state.requirements->EnableTyping(); }
+#line 2263 "pddl.cc"
     break;
 
   case 55: /* require_key: NEGATIVE_PRECONDITIONS  */
-#line 352 "pddl.yy"
-                { requirements->EnableNegativePreconditions(); }
-#line 2198 "pddl.cc"
+#line 419 "pddl.yy"
+                { state.requirements->EnableNegativePreconditions(); }
+#line 2269 "pddl.cc"
     break;
 
   case 56: /* require_key: DISJUNCTIVE_PRECONDITIONS  */
-#line 354 "pddl.yy"
-                { requirements->EnableDisjunctivePreconditions(); }
-#line 2204 "pddl.cc"
+#line 421 "pddl.yy"
+                { state.requirements->EnableDisjunctivePreconditions(); }
+#line 2275 "pddl.cc"
     break;
 
   case 57: /* require_key: EQUALITY  */
-#line 355 "pddl.yy"
-                       { requirements->EnableEquality(); }
-#line 2210 "pddl.cc"
+#line 422 "pddl.yy"
+                       { state.requirements->EnableEquality(); }
+#line 2281 "pddl.cc"
     break;
 
   case 58: /* require_key: EXISTENTIAL_PRECONDITIONS  */
-#line 357 "pddl.yy"
-                { requirements->EnableExistentialPreconditions(); }
-#line 2216 "pddl.cc"
+#line 424 "pddl.yy"
+                { state.requirements->EnableExistentialPreconditions(); }
+#line 2287 "pddl.cc"
     break;
 
   case 59: /* require_key: UNIVERSAL_PRECONDITIONS  */
-#line 359 "pddl.yy"
-                { requirements->EnableUniversalPreconditions(); }
-#line 2222 "pddl.cc"
+#line 426 "pddl.yy"
+                { state.requirements->EnableUniversalPreconditions(); }
+#line 2293 "pddl.cc"
     break;
 
   case 60: /* require_key: QUANTIFIED_PRECONDITIONS  */
-#line 361 "pddl.yy"
-                { requirements->EnableQuantifiedPreconditions(); }
-#line 2228 "pddl.cc"
+#line 428 "pddl.yy"
+                { state.requirements->EnableQuantifiedPreconditions(); }
+#line 2299 "pddl.cc"
     break;
 
   case 61: /* require_key: CONDITIONAL_EFFECTS  */
-#line 362 "pddl.yy"
-                                  { requirements->EnableConditionalEffects(); }
-#line 2234 "pddl.cc"
+#line 430 "pddl.yy"
+                { state.requirements->EnableConditionalEffects(); }
+#line 2305 "pddl.cc"
     break;
 
   case 62: /* require_key: FLUENTS  */
-#line 363 "pddl.yy"
-                      { requirements->EnableFluents(); }
-#line 2240 "pddl.cc"
+#line 431 "pddl.yy"
+                      { state.requirements->EnableFluents(); }
+#line 2311 "pddl.cc"
     break;
 
   case 63: /* require_key: ADL  */
-#line 364 "pddl.yy"
-                  { requirements->EnableAdl(); }
-#line 2246 "pddl.cc"
+#line 432 "pddl.yy"
+                  { state.requirements->EnableAdl(); }
+#line 2317 "pddl.cc"
     break;
 
   case 64: /* require_key: DURATIVE_ACTIONS  */
-#line 365 "pddl.yy"
-                               { requirements->EnableDurativeActions(); }
-#line 2252 "pddl.cc"
+#line 433 "pddl.yy"
+                               { state.requirements->EnableDurativeActions(); }
+#line 2323 "pddl.cc"
     break;
 
   case 65: /* require_key: DURATION_INEQUALITIES  */
-#line 367 "pddl.yy"
-                { requirements->EnableDurationInequalities(); }
-#line 2258 "pddl.cc"
+#line 435 "pddl.yy"
+                { state.requirements->EnableDurationInequalities(); }
+#line 2329 "pddl.cc"
     break;
 
   case 66: /* require_key: CONTINUOUS_EFFECTS  */
-#line 369 "pddl.yy"
+#line 437 "pddl.yy"
                 {
-                  requirements->EnableContinuousEffects();
-                  yyerror("`:continuous-effects' not supported");
+                  state.requirements->EnableContinuousEffects();
+                  state.error("`:continuous-effects' not supported");
                 }
-#line 2267 "pddl.cc"
+#line 2338 "pddl.cc"
     break;
 
   case 67: /* require_key: TIMED_INITIAL_LITERALS  */
-#line 374 "pddl.yy"
-                { requirements->EnableTimedInitialLiterals(); }
-#line 2273 "pddl.cc"
+#line 442 "pddl.yy"
+                { state.requirements->EnableTimedInitialLiterals(); }
+#line 2344 "pddl.cc"
     break;
 
   case 68: /* $@3: %empty  */
-#line 377 "pddl.yy"
-                      { require_typing(); name_kind = TYPE_KIND; }
-#line 2279 "pddl.cc"
+#line 445 "pddl.yy"
+                      { state.require_typing(); state.name_kind = TYPE_KIND; }
+#line 2350 "pddl.cc"
     break;
 
   case 69: /* types_def: '(' TYPES $@3 typed_names ')'  */
-#line 378 "pddl.yy"
-                              { name_kind = VOID_KIND; }
-#line 2285 "pddl.cc"
+#line 446 "pddl.yy"
+                              { state.name_kind = VOID_KIND; }
+#line 2356 "pddl.cc"
     break;
 
   case 70: /* $@4: %empty  */
-#line 381 "pddl.yy"
-                              { name_kind = CONSTANT_KIND; }
-#line 2291 "pddl.cc"
+#line 449 "pddl.yy"
+                              { state.name_kind = CONSTANT_KIND; }
+#line 2362 "pddl.cc"
     break;
 
   case 71: /* constants_def: '(' CONSTANTS $@4 typed_names ')'  */
-#line 382 "pddl.yy"
-                  { name_kind = VOID_KIND; }
-#line 2297 "pddl.cc"
+#line 451 "pddl.yy"
+                  { state.name_kind = VOID_KIND; }
+#line 2368 "pddl.cc"
     break;
 
   case 73: /* $@5: %empty  */
-#line 388 "pddl.yy"
-                              { require_fluents(); }
-#line 2303 "pddl.cc"
+#line 457 "pddl.yy"
+                              { state.require_fluents(); }
+#line 2374 "pddl.cc"
     break;
 
   case 77: /* $@6: %empty  */
-#line 399 "pddl.yy"
-                               { make_predicate((yyvsp[0].str)); }
-#line 2309 "pddl.cc"
+#line 468 "pddl.yy"
+                               { state.make_predicate((yyvsp[0].str)); }
+#line 2380 "pddl.cc"
     break;
 
   case 78: /* predicate_decl: '(' predicate $@6 variables ')'  */
-#line 400 "pddl.yy"
-                   { predicate = 0; }
-#line 2315 "pddl.cc"
+#line 469 "pddl.yy"
+                   { state.predicate = 0; }
+#line 2386 "pddl.cc"
     break;
 
   case 84: /* $@7: %empty  */
-#line 412 "pddl.yy"
-                         { require_typing(); }
-#line 2321 "pddl.cc"
+#line 481 "pddl.yy"
+                         { state.require_typing(); }
+#line 2392 "pddl.cc"
     break;
 
   case 86: /* $@8: %empty  */
-#line 415 "pddl.yy"
-                             { make_function((yyvsp[0].str)); }
-#line 2327 "pddl.cc"
+#line 484 "pddl.yy"
+                             { state.make_function((yyvsp[0].str)); }
+#line 2398 "pddl.cc"
     break;
 
   case 87: /* function_decl: '(' function $@8 variables ')'  */
-#line 416 "pddl.yy"
-                  { function = 0; }
-#line 2333 "pddl.cc"
+#line 485 "pddl.yy"
+                  { state.function = 0; }
+#line 2404 "pddl.cc"
     break;
 
   case 88: /* $@9: %empty  */
-#line 423 "pddl.yy"
-                             { make_action((yyvsp[0].str), false); }
-#line 2339 "pddl.cc"
+#line 492 "pddl.yy"
+                             { state.make_action((yyvsp[0].str), false); }
+#line 2410 "pddl.cc"
     break;
 
   case 89: /* action_def: '(' ACTION name $@9 parameters action_body ')'  */
-#line 424 "pddl.yy"
-                                          { add_action(); }
-#line 2345 "pddl.cc"
+#line 493 "pddl.yy"
+                                          { state.add_action(); }
+#line 2416 "pddl.cc"
     break;
 
   case 90: /* $@10: %empty  */
-#line 425 "pddl.yy"
-                                      { make_action((yyvsp[0].str), true); }
-#line 2351 "pddl.cc"
+#line 494 "pddl.yy"
+                                      { state.make_action((yyvsp[0].str), true); }
+#line 2422 "pddl.cc"
     break;
 
   case 91: /* action_def: '(' DURATIVE_ACTION name $@10 parameters DURATION duration_constraint da_body ')'  */
-#line 427 "pddl.yy"
-               { add_action(); }
-#line 2357 "pddl.cc"
+#line 496 "pddl.yy"
+               { state.add_action(); }
+#line 2428 "pddl.cc"
     break;
 
   case 98: /* $@11: %empty  */
-#line 442 "pddl.yy"
-                            { formula_time = AT_START; }
-#line 2363 "pddl.cc"
+#line 511 "pddl.yy"
+                            { state.formula_time = AT_START; }
+#line 2434 "pddl.cc"
     break;
 
   case 99: /* precondition: PRECONDITION $@11 formula  */
-#line 443 "pddl.yy"
-                 { action->set_condition(*(yyvsp[0].formula)); }
-#line 2369 "pddl.cc"
+#line 512 "pddl.yy"
+                 { state.action->set_condition(*(yyvsp[0].formula)); }
+#line 2440 "pddl.cc"
     break;
 
   case 100: /* $@12: %empty  */
-#line 446 "pddl.yy"
-                { effect_time = Effect::AT_END; }
-#line 2375 "pddl.cc"
+#line 515 "pddl.yy"
+                { state.effect_time = Effect::AT_END; }
+#line 2446 "pddl.cc"
     break;
 
   case 102: /* da_body: CONDITION da_gd da_body2  */
-#line 449 "pddl.yy"
-                                   { action->set_condition(*(yyvsp[-1].formula)); }
-#line 2381 "pddl.cc"
+#line 518 "pddl.yy"
+                                   { state.action->set_condition(*(yyvsp[-1].formula)); }
+#line 2452 "pddl.cc"
     break;
 
   case 107: /* duration_constraint: '(' and simple_duration_constraints ')'  */
-#line 463 "pddl.yy"
-                        { require_duration_inequalities(); }
-#line 2387 "pddl.cc"
+#line 532 "pddl.yy"
+                        { state.require_duration_inequalities(); }
+#line 2458 "pddl.cc"
     break;
 
   case 108: /* simple_duration_constraint: '(' LE duration_var f_exp ')'  */
-#line 467 "pddl.yy"
+#line 536 "pddl.yy"
                                {
-                                 require_duration_inequalities();
-                                 action->set_max_duration(*(yyvsp[-1].expr));
+                                 state.require_duration_inequalities();
+                                 state.action->set_max_duration(*(yyvsp[-1].expr));
                                }
-#line 2396 "pddl.cc"
+#line 2467 "pddl.cc"
     break;
 
   case 109: /* simple_duration_constraint: '(' GE duration_var f_exp ')'  */
-#line 472 "pddl.yy"
+#line 541 "pddl.yy"
                                {
-                                 require_duration_inequalities();
-                                 action->set_min_duration(*(yyvsp[-1].expr));
+                                 state.require_duration_inequalities();
+                                 state.action->set_min_duration(*(yyvsp[-1].expr));
                                }
-#line 2405 "pddl.cc"
+#line 2476 "pddl.cc"
     break;
 
   case 110: /* simple_duration_constraint: '(' '=' duration_var f_exp ')'  */
-#line 477 "pddl.yy"
-                               { action->set_duration(*(yyvsp[-1].expr)); }
-#line 2411 "pddl.cc"
+#line 546 "pddl.yy"
+                               { state.action->set_duration(*(yyvsp[-1].expr)); }
+#line 2482 "pddl.cc"
     break;
 
   case 114: /* da_gd: '(' and timed_gds ')'  */
-#line 490 "pddl.yy"
+#line 559 "pddl.yy"
                               { (yyval.formula) = (yyvsp[-1].formula); }
-#line 2417 "pddl.cc"
+#line 2488 "pddl.cc"
     break;
 
   case 115: /* timed_gds: %empty  */
-#line 493 "pddl.yy"
+#line 562 "pddl.yy"
                         { (yyval.formula) = &Formula::TRUE; }
-#line 2423 "pddl.cc"
+#line 2494 "pddl.cc"
     break;
 
   case 116: /* timed_gds: timed_gds timed_gd  */
-#line 494 "pddl.yy"
+#line 563 "pddl.yy"
                                { (yyval.formula) = &(*(yyvsp[-1].formula) && *(yyvsp[0].formula)); }
-#line 2429 "pddl.cc"
+#line 2500 "pddl.cc"
     break;
 
   case 117: /* $@13: %empty  */
-#line 497 "pddl.yy"
-                        { formula_time = AT_START; }
-#line 2435 "pddl.cc"
+#line 566 "pddl.yy"
+                        { state.formula_time = AT_START; }
+#line 2506 "pddl.cc"
     break;
 
   case 118: /* timed_gd: '(' at start $@13 formula ')'  */
-#line 497 "pddl.yy"
-                                                                 { (yyval.formula) = (yyvsp[-1].formula); }
-#line 2441 "pddl.cc"
+#line 567 "pddl.yy"
+             { (yyval.formula) = (yyvsp[-1].formula); }
+#line 2512 "pddl.cc"
     break;
 
   case 119: /* $@14: %empty  */
-#line 498 "pddl.yy"
-                      { formula_time = AT_END; }
-#line 2447 "pddl.cc"
+#line 568 "pddl.yy"
+                      { state.formula_time = AT_END; }
+#line 2518 "pddl.cc"
     break;
 
   case 120: /* timed_gd: '(' at end $@14 formula ')'  */
-#line 498 "pddl.yy"
-                                                             { (yyval.formula) = (yyvsp[-1].formula); }
-#line 2453 "pddl.cc"
+#line 569 "pddl.yy"
+             { (yyval.formula) = (yyvsp[-1].formula); }
+#line 2524 "pddl.cc"
     break;
 
   case 121: /* $@15: %empty  */
-#line 499 "pddl.yy"
-                        { formula_time = OVER_ALL; }
-#line 2459 "pddl.cc"
+#line 570 "pddl.yy"
+                        { state.formula_time = OVER_ALL; }
+#line 2530 "pddl.cc"
     break;
 
   case 122: /* timed_gd: '(' over all $@15 formula ')'  */
-#line 499 "pddl.yy"
-                                                                 { (yyval.formula) = (yyvsp[-1].formula); }
-#line 2465 "pddl.cc"
+#line 571 "pddl.yy"
+             { (yyval.formula) = (yyvsp[-1].formula); }
+#line 2536 "pddl.cc"
     break;
 
   case 125: /* $@16: %empty  */
-#line 508 "pddl.yy"
-                         { prepare_forall_effect(); }
-#line 2471 "pddl.cc"
+#line 580 "pddl.yy"
+                         { state.prepare_forall_effect(); }
+#line 2542 "pddl.cc"
     break;
 
   case 126: /* eff_formula: '(' forall $@16 '(' variables ')' eff_formula ')'  */
-#line 509 "pddl.yy"
-                                                  { pop_forall_effect(); }
-#line 2477 "pddl.cc"
+#line 582 "pddl.yy"
+                { state.pop_forall_effect(); }
+#line 2548 "pddl.cc"
     break;
 
   case 127: /* $@17: %empty  */
-#line 510 "pddl.yy"
-                       { formula_time = AT_START; }
-#line 2483 "pddl.cc"
+#line 583 "pddl.yy"
+                       { state.formula_time = AT_START; }
+#line 2554 "pddl.cc"
     break;
 
   case 128: /* $@18: %empty  */
-#line 511 "pddl.yy"
-                { prepare_conditional_effect(*(yyvsp[0].formula)); }
-#line 2489 "pddl.cc"
+#line 584 "pddl.yy"
+                { state.prepare_conditional_effect(*(yyvsp[0].formula)); }
+#line 2560 "pddl.cc"
     break;
 
   case 129: /* eff_formula: '(' when $@17 formula $@18 one_eff_formula ')'  */
-#line 512 "pddl.yy"
-                                    { effect_condition = 0; }
-#line 2495 "pddl.cc"
+#line 585 "pddl.yy"
+                                    { state.effect_condition = 0; }
+#line 2566 "pddl.cc"
     break;
 
   case 134: /* term_literal: atomic_term_formula  */
-#line 523 "pddl.yy"
-                                   { add_effect(*(yyvsp[0].atom)); }
-#line 2501 "pddl.cc"
+#line 596 "pddl.yy"
+                                   { state.add_effect(*(yyvsp[0].atom)); }
+#line 2572 "pddl.cc"
     break;
 
   case 135: /* term_literal: '(' not atomic_term_formula ')'  */
-#line 525 "pddl.yy"
-                 { add_effect(Negation::make(*(yyvsp[-1].atom))); }
-#line 2507 "pddl.cc"
+#line 598 "pddl.yy"
+                 { state.add_effect(Negation::make(*(yyvsp[-1].atom))); }
+#line 2578 "pddl.cc"
     break;
 
   case 140: /* $@19: %empty  */
-#line 534 "pddl.yy"
-                       { prepare_forall_effect(); }
-#line 2513 "pddl.cc"
+#line 607 "pddl.yy"
+                       { state.prepare_forall_effect(); }
+#line 2584 "pddl.cc"
     break;
 
   case 141: /* da_effect: '(' forall $@19 '(' variables ')' da_effect ')'  */
-#line 535 "pddl.yy"
-                                              { pop_forall_effect(); }
-#line 2519 "pddl.cc"
+#line 608 "pddl.yy"
+                                              { state.pop_forall_effect(); }
+#line 2590 "pddl.cc"
     break;
 
   case 142: /* $@20: %empty  */
-#line 536 "pddl.yy"
-                           { prepare_conditional_effect(*(yyvsp[0].formula)); }
-#line 2525 "pddl.cc"
+#line 609 "pddl.yy"
+                           { state.prepare_conditional_effect(*(yyvsp[0].formula)); }
+#line 2596 "pddl.cc"
     break;
 
   case 143: /* da_effect: '(' when da_gd $@20 timed_effect ')'  */
-#line 537 "pddl.yy"
-                               { effect_condition = 0; }
-#line 2531 "pddl.cc"
+#line 610 "pddl.yy"
+                               { state.effect_condition = 0; }
+#line 2602 "pddl.cc"
     break;
 
   case 146: /* $@21: %empty  */
-#line 545 "pddl.yy"
-                 { effect_time = Effect::AT_START; formula_time = AT_START; }
-#line 2537 "pddl.cc"
+#line 618 "pddl.yy"
+                 {
+                   state.effect_time = Effect::AT_START;
+                   state.formula_time = AT_START;
+                 }
+#line 2611 "pddl.cc"
     break;
 
   case 148: /* $@22: %empty  */
-#line 548 "pddl.yy"
-                 { effect_time = Effect::AT_END; formula_time = AT_END; }
-#line 2543 "pddl.cc"
+#line 624 "pddl.yy"
+                 {
+                   state.effect_time = Effect::AT_END;
+                   state.formula_time = AT_END;
+                 }
+#line 2620 "pddl.cc"
     break;
 
   case 152: /* $@23: %empty  */
-#line 554 "pddl.yy"
-                      { prepare_forall_effect(); }
-#line 2549 "pddl.cc"
+#line 633 "pddl.yy"
+                      { state.prepare_forall_effect(); }
+#line 2626 "pddl.cc"
     break;
 
   case 153: /* a_effect: '(' forall $@23 '(' variables ')' a_effect ')'  */
-#line 555 "pddl.yy"
-                                            { pop_forall_effect(); }
-#line 2555 "pddl.cc"
+#line 634 "pddl.yy"
+                                            { state.pop_forall_effect(); }
+#line 2632 "pddl.cc"
     break;
 
   case 154: /* $@24: %empty  */
-#line 556 "pddl.yy"
-                            { prepare_conditional_effect(*(yyvsp[0].formula)); }
-#line 2561 "pddl.cc"
+#line 635 "pddl.yy"
+                            { state.prepare_conditional_effect(*(yyvsp[0].formula)); }
+#line 2638 "pddl.cc"
     break;
 
   case 155: /* a_effect: '(' when formula $@24 one_eff_formula ')'  */
-#line 557 "pddl.yy"
-                                 { effect_condition = 0; }
-#line 2567 "pddl.cc"
+#line 636 "pddl.yy"
+                                 { state.effect_condition = 0; }
+#line 2644 "pddl.cc"
     break;
 
   case 158: /* $@25: %empty  */
-#line 569 "pddl.yy"
-                { make_problem((yyvsp[-5].str), (yyvsp[-1].str)); }
-#line 2573 "pddl.cc"
+#line 648 "pddl.yy"
+                { state.make_problem((yyvsp[-5].str), (yyvsp[-1].str)); }
+#line 2650 "pddl.cc"
     break;
 
   case 159: /* problem_def: '(' define '(' problem name ')' '(' PDOMAIN name ')' $@25 problem_body ')'  */
-#line 570 "pddl.yy"
-                { delete requirements; }
-#line 2579 "pddl.cc"
+#line 649 "pddl.yy"
+                { delete state.requirements; }
+#line 2656 "pddl.cc"
     break;
 
   case 166: /* $@26: %empty  */
-#line 585 "pddl.yy"
-                          { name_kind = OBJECT_KIND; }
-#line 2585 "pddl.cc"
+#line 664 "pddl.yy"
+                          { state.name_kind = OBJECT_KIND; }
+#line 2662 "pddl.cc"
     break;
 
   case 167: /* object_decl: '(' OBJECTS $@26 typed_names ')'  */
-#line 586 "pddl.yy"
-                { name_kind = VOID_KIND; }
-#line 2591 "pddl.cc"
+#line 665 "pddl.yy"
+                { state.name_kind = VOID_KIND; }
+#line 2668 "pddl.cc"
     break;
 
   case 171: /* $@27: %empty  */
-#line 596 "pddl.yy"
-                                  { prepare_atom((yyvsp[0].str)); }
-#line 2597 "pddl.cc"
+#line 675 "pddl.yy"
+                                  { state.prepare_atom((yyvsp[0].str)); }
+#line 2674 "pddl.cc"
     break;
 
   case 172: /* init_element: '(' init_predicate $@27 names ')'  */
-#line 597 "pddl.yy"
-                 { problem->add_init_atom(*make_atom()); }
-#line 2603 "pddl.cc"
+#line 676 "pddl.yy"
+                 { state.problem->add_init_atom(*state.make_atom()); }
+#line 2680 "pddl.cc"
     break;
 
   case 173: /* $@28: %empty  */
-#line 598 "pddl.yy"
-                      { prepare_atom((yyvsp[0].str)); }
-#line 2609 "pddl.cc"
+#line 677 "pddl.yy"
+                      { state.prepare_atom((yyvsp[0].str)); }
+#line 2686 "pddl.cc"
     break;
 
   case 174: /* init_element: '(' AT $@28 names ')'  */
-#line 599 "pddl.yy"
-                 { problem->add_init_atom(*make_atom()); }
-#line 2615 "pddl.cc"
+#line 678 "pddl.yy"
+                 { state.problem->add_init_atom(*state.make_atom()); }
+#line 2692 "pddl.cc"
     break;
 
   case 175: /* init_element: '(' not atomic_name_formula ')'  */
-#line 601 "pddl.yy"
+#line 680 "pddl.yy"
                  { Formula::register_use((yyvsp[-1].atom)); Formula::unregister_use((yyvsp[-1].atom)); }
-#line 2621 "pddl.cc"
+#line 2698 "pddl.cc"
     break;
 
   case 176: /* init_element: '(' '=' ground_f_head NUMBER ')'  */
-#line 603 "pddl.yy"
-                 { problem->add_init_value(*(yyvsp[-2].fluent), (yyvsp[-1].num)); }
-#line 2627 "pddl.cc"
+#line 682 "pddl.yy"
+                 { state.problem->add_init_value(*(yyvsp[-2].fluent), (yyvsp[-1].num)); }
+#line 2704 "pddl.cc"
     break;
 
   case 177: /* init_element: '(' at NUMBER name_literal ')'  */
-#line 605 "pddl.yy"
-                 { add_init_literal((yyvsp[-2].num), *(yyvsp[-1].literal)); }
-#line 2633 "pddl.cc"
+#line 684 "pddl.yy"
+                 { state.add_init_literal((yyvsp[-2].num), *(yyvsp[-1].literal)); }
+#line 2710 "pddl.cc"
     break;
 
   case 180: /* goal: '(' GOAL formula ')'  */
-#line 612 "pddl.yy"
-                            { problem->set_goal(*(yyvsp[-1].formula)); }
-#line 2639 "pddl.cc"
+#line 691 "pddl.yy"
+                            { state.problem->set_goal(*(yyvsp[-1].formula)); }
+#line 2716 "pddl.cc"
     break;
 
   case 181: /* $@29: %empty  */
-#line 615 "pddl.yy"
-                                  { metric_fluent = true; }
-#line 2645 "pddl.cc"
+#line 694 "pddl.yy"
+                                  { state.metric_fluent = true; }
+#line 2722 "pddl.cc"
     break;
 
   case 182: /* metric_spec: '(' METRIC maximize $@29 ground_f_exp ')'  */
-#line 616 "pddl.yy"
-                { problem->set_metric(*(yyvsp[-1].expr), true); metric_fluent = false; }
-#line 2651 "pddl.cc"
+#line 696 "pddl.yy"
+                {
+                  state.problem->set_metric(*(yyvsp[-1].expr), true);
+                  state.metric_fluent = false;
+                }
+#line 2731 "pddl.cc"
     break;
 
   case 183: /* $@30: %empty  */
-#line 617 "pddl.yy"
-                                  { metric_fluent = true; }
-#line 2657 "pddl.cc"
+#line 700 "pddl.yy"
+                                  { state.metric_fluent = true; }
+#line 2737 "pddl.cc"
     break;
 
   case 184: /* metric_spec: '(' METRIC minimize $@30 ground_f_exp ')'  */
-#line 618 "pddl.yy"
-                { problem->set_metric(*(yyvsp[-1].expr)); metric_fluent = false; }
-#line 2663 "pddl.cc"
+#line 702 "pddl.yy"
+                {
+                  state.problem->set_metric(*(yyvsp[-1].expr));
+                  state.metric_fluent = false;
+                }
+#line 2746 "pddl.cc"
     break;
 
   case 185: /* formula: atomic_term_formula  */
-#line 625 "pddl.yy"
-                              { (yyval.formula) = &TimedLiteral::make(*(yyvsp[0].atom), formula_time); }
-#line 2669 "pddl.cc"
+#line 713 "pddl.yy"
+            { (yyval.formula) = &TimedLiteral::make(*(yyvsp[0].atom), state.formula_time); }
+#line 2752 "pddl.cc"
     break;
 
   case 186: /* formula: '(' '=' term term ')'  */
-#line 626 "pddl.yy"
-                                { (yyval.formula) = make_equality((yyvsp[-2].term), (yyvsp[-1].term)); }
-#line 2675 "pddl.cc"
+#line 714 "pddl.yy"
+                                { (yyval.formula) = state.make_equality((yyvsp[-2].term), (yyvsp[-1].term)); }
+#line 2758 "pddl.cc"
     break;
 
   case 187: /* formula: '(' not formula ')'  */
-#line 627 "pddl.yy"
-                              { (yyval.formula) = make_negation(*(yyvsp[-1].formula)); }
-#line 2681 "pddl.cc"
+#line 715 "pddl.yy"
+                              { (yyval.formula) = state.make_negation(*(yyvsp[-1].formula)); }
+#line 2764 "pddl.cc"
     break;
 
   case 188: /* formula: '(' and conjuncts ')'  */
-#line 628 "pddl.yy"
+#line 716 "pddl.yy"
                                 { (yyval.formula) = (yyvsp[-1].formula); }
-#line 2687 "pddl.cc"
+#line 2770 "pddl.cc"
     break;
 
   case 189: /* $@31: %empty  */
-#line 629 "pddl.yy"
-                 { require_disjunction(); }
-#line 2693 "pddl.cc"
+#line 717 "pddl.yy"
+                 { state.require_disjunction(); }
+#line 2776 "pddl.cc"
     break;
 
   case 190: /* formula: '(' or $@31 disjuncts ')'  */
-#line 629 "pddl.yy"
-                                                          { (yyval.formula) = (yyvsp[-1].formula); }
-#line 2699 "pddl.cc"
+#line 717 "pddl.yy"
+                                                                { (yyval.formula) = (yyvsp[-1].formula); }
+#line 2782 "pddl.cc"
     break;
 
   case 191: /* $@32: %empty  */
-#line 630 "pddl.yy"
-                    { require_disjunction(); }
-#line 2705 "pddl.cc"
+#line 718 "pddl.yy"
+                    { state.require_disjunction(); }
+#line 2788 "pddl.cc"
     break;
 
   case 192: /* formula: '(' imply $@32 formula formula ')'  */
-#line 631 "pddl.yy"
+#line 719 "pddl.yy"
             { (yyval.formula) = &(!*(yyvsp[-2].formula) || *(yyvsp[-1].formula)); }
-#line 2711 "pddl.cc"
+#line 2794 "pddl.cc"
     break;
 
   case 193: /* $@33: %empty  */
-#line 632 "pddl.yy"
-                     { prepare_exists(); }
-#line 2717 "pddl.cc"
+#line 720 "pddl.yy"
+                     { state.prepare_exists(); }
+#line 2800 "pddl.cc"
     break;
 
   case 194: /* formula: '(' exists $@33 '(' variables ')' formula ')'  */
-#line 633 "pddl.yy"
-            { (yyval.formula) = make_exists(*(yyvsp[-1].formula)); }
-#line 2723 "pddl.cc"
+#line 721 "pddl.yy"
+            { (yyval.formula) = state.make_exists(*(yyvsp[-1].formula)); }
+#line 2806 "pddl.cc"
     break;
 
   case 195: /* $@34: %empty  */
-#line 634 "pddl.yy"
-                     { prepare_forall(); }
-#line 2729 "pddl.cc"
+#line 722 "pddl.yy"
+                     { state.prepare_forall(); }
+#line 2812 "pddl.cc"
     break;
 
   case 196: /* formula: '(' forall $@34 '(' variables ')' formula ')'  */
-#line 635 "pddl.yy"
-            { (yyval.formula) = make_forall(*(yyvsp[-1].formula)); }
-#line 2735 "pddl.cc"
+#line 723 "pddl.yy"
+            { (yyval.formula) = state.make_forall(*(yyvsp[-1].formula)); }
+#line 2818 "pddl.cc"
     break;
 
   case 197: /* conjuncts: %empty  */
-#line 638 "pddl.yy"
+#line 726 "pddl.yy"
                         { (yyval.formula) = &Formula::TRUE; }
-#line 2741 "pddl.cc"
+#line 2824 "pddl.cc"
     break;
 
   case 198: /* conjuncts: conjuncts formula  */
-#line 639 "pddl.yy"
+#line 727 "pddl.yy"
                               { (yyval.formula) = &(*(yyvsp[-1].formula) && *(yyvsp[0].formula)); }
-#line 2747 "pddl.cc"
+#line 2830 "pddl.cc"
     break;
 
   case 199: /* disjuncts: %empty  */
-#line 642 "pddl.yy"
+#line 730 "pddl.yy"
                         { (yyval.formula) = &Formula::FALSE; }
-#line 2753 "pddl.cc"
+#line 2836 "pddl.cc"
     break;
 
   case 200: /* disjuncts: disjuncts formula  */
-#line 643 "pddl.yy"
+#line 731 "pddl.yy"
                               { (yyval.formula) = &(*(yyvsp[-1].formula) || *(yyvsp[0].formula)); }
-#line 2759 "pddl.cc"
+#line 2842 "pddl.cc"
     break;
 
   case 201: /* $@35: %empty  */
-#line 646 "pddl.yy"
-                                    { prepare_atom((yyvsp[0].str)); }
-#line 2765 "pddl.cc"
+#line 734 "pddl.yy"
+                                    { state.prepare_atom((yyvsp[0].str)); }
+#line 2848 "pddl.cc"
     break;
 
   case 202: /* atomic_term_formula: '(' predicate $@35 terms ')'  */
-#line 647 "pddl.yy"
-                        { (yyval.atom) = make_atom(); }
-#line 2771 "pddl.cc"
+#line 735 "pddl.yy"
+                        { (yyval.atom) = state.make_atom(); }
+#line 2854 "pddl.cc"
     break;
 
   case 203: /* $@36: %empty  */
-#line 650 "pddl.yy"
-                                    { prepare_atom((yyvsp[0].str)); }
-#line 2777 "pddl.cc"
+#line 738 "pddl.yy"
+                                    { state.prepare_atom((yyvsp[0].str)); }
+#line 2860 "pddl.cc"
     break;
 
   case 204: /* atomic_name_formula: '(' predicate $@36 names ')'  */
-#line 651 "pddl.yy"
-                        { (yyval.atom) = make_atom(); }
-#line 2783 "pddl.cc"
+#line 739 "pddl.yy"
+                        { (yyval.atom) = state.make_atom(); }
+#line 2866 "pddl.cc"
     break;
 
   case 205: /* name_literal: atomic_name_formula  */
-#line 654 "pddl.yy"
+#line 742 "pddl.yy"
                                    { (yyval.literal) = (yyvsp[0].atom); }
-#line 2789 "pddl.cc"
+#line 2872 "pddl.cc"
     break;
 
   case 206: /* name_literal: '(' not atomic_name_formula ')'  */
-#line 655 "pddl.yy"
+#line 743 "pddl.yy"
                                                { (yyval.literal) = &Negation::make(*(yyvsp[-1].atom)); }
-#line 2795 "pddl.cc"
+#line 2878 "pddl.cc"
     break;
 
   case 207: /* f_exp: NUMBER  */
-#line 662 "pddl.yy"
+#line 750 "pddl.yy"
                { (yyval.expr) = new Value((yyvsp[0].num)); }
-#line 2801 "pddl.cc"
+#line 2884 "pddl.cc"
     break;
 
   case 208: /* f_exp: '(' '+' f_exp f_exp ')'  */
-#line 663 "pddl.yy"
+#line 751 "pddl.yy"
                                 { (yyval.expr) = &Addition::make(*(yyvsp[-2].expr), *(yyvsp[-1].expr)); }
-#line 2807 "pddl.cc"
+#line 2890 "pddl.cc"
     break;
 
   case 209: /* f_exp: '(' '-' f_exp opt_f_exp ')'  */
-#line 664 "pddl.yy"
-                                    { (yyval.expr) = make_subtraction(*(yyvsp[-2].expr), (yyvsp[-1].expr)); }
-#line 2813 "pddl.cc"
+#line 752 "pddl.yy"
+                                    { (yyval.expr) = state.make_subtraction(*(yyvsp[-2].expr), (yyvsp[-1].expr)); }
+#line 2896 "pddl.cc"
     break;
 
   case 210: /* f_exp: '(' '*' f_exp f_exp ')'  */
-#line 665 "pddl.yy"
+#line 753 "pddl.yy"
                                 { (yyval.expr) = &Multiplication::make(*(yyvsp[-2].expr), *(yyvsp[-1].expr)); }
-#line 2819 "pddl.cc"
+#line 2902 "pddl.cc"
     break;
 
   case 211: /* f_exp: '(' '/' f_exp f_exp ')'  */
-#line 666 "pddl.yy"
+#line 754 "pddl.yy"
                                 { (yyval.expr) = &Division::make(*(yyvsp[-2].expr), *(yyvsp[-1].expr)); }
-#line 2825 "pddl.cc"
+#line 2908 "pddl.cc"
     break;
 
   case 212: /* f_exp: f_head  */
-#line 667 "pddl.yy"
+#line 755 "pddl.yy"
                { (yyval.expr) = (yyvsp[0].fluent); }
-#line 2831 "pddl.cc"
+#line 2914 "pddl.cc"
     break;
 
   case 213: /* opt_f_exp: %empty  */
-#line 670 "pddl.yy"
+#line 758 "pddl.yy"
                         { (yyval.expr) = 0; }
-#line 2837 "pddl.cc"
+#line 2920 "pddl.cc"
     break;
 
   case 215: /* $@37: %empty  */
-#line 674 "pddl.yy"
-                      { prepare_fluent((yyvsp[0].str)); }
-#line 2843 "pddl.cc"
+#line 762 "pddl.yy"
+                      { state.prepare_fluent((yyvsp[0].str)); }
+#line 2926 "pddl.cc"
     break;
 
   case 216: /* f_head: '(' function $@37 terms ')'  */
-#line 675 "pddl.yy"
-           { (yyval.fluent) = make_fluent(); }
-#line 2849 "pddl.cc"
+#line 763 "pddl.yy"
+           { (yyval.fluent) = state.make_fluent(); }
+#line 2932 "pddl.cc"
     break;
 
   case 217: /* f_head: function  */
-#line 676 "pddl.yy"
-                  { prepare_fluent((yyvsp[0].str)); (yyval.fluent) = make_fluent(); }
-#line 2855 "pddl.cc"
+#line 764 "pddl.yy"
+                  { state.prepare_fluent((yyvsp[0].str)); (yyval.fluent) = state.make_fluent(); }
+#line 2938 "pddl.cc"
     break;
 
   case 218: /* ground_f_exp: NUMBER  */
-#line 679 "pddl.yy"
+#line 767 "pddl.yy"
                       { (yyval.expr) = new Value((yyvsp[0].num)); }
-#line 2861 "pddl.cc"
+#line 2944 "pddl.cc"
     break;
 
   case 219: /* ground_f_exp: '(' '+' ground_f_exp ground_f_exp ')'  */
-#line 681 "pddl.yy"
+#line 769 "pddl.yy"
                  { (yyval.expr) = &Addition::make(*(yyvsp[-2].expr), *(yyvsp[-1].expr)); }
-#line 2867 "pddl.cc"
+#line 2950 "pddl.cc"
     break;
 
   case 220: /* ground_f_exp: '(' '-' ground_f_exp opt_ground_f_exp ')'  */
-#line 683 "pddl.yy"
-                 { (yyval.expr) = make_subtraction(*(yyvsp[-2].expr), (yyvsp[-1].expr)); }
-#line 2873 "pddl.cc"
+#line 771 "pddl.yy"
+                 { (yyval.expr) = state.make_subtraction(*(yyvsp[-2].expr), (yyvsp[-1].expr)); }
+#line 2956 "pddl.cc"
     break;
 
   case 221: /* ground_f_exp: '(' '*' ground_f_exp ground_f_exp ')'  */
-#line 685 "pddl.yy"
+#line 773 "pddl.yy"
                  { (yyval.expr) = &Multiplication::make(*(yyvsp[-2].expr), *(yyvsp[-1].expr)); }
-#line 2879 "pddl.cc"
+#line 2962 "pddl.cc"
     break;
 
   case 222: /* ground_f_exp: '(' '/' ground_f_exp ground_f_exp ')'  */
-#line 687 "pddl.yy"
+#line 775 "pddl.yy"
                  { (yyval.expr) = &Division::make(*(yyvsp[-2].expr), *(yyvsp[-1].expr)); }
-#line 2885 "pddl.cc"
+#line 2968 "pddl.cc"
     break;
 
   case 223: /* ground_f_exp: ground_f_head  */
-#line 688 "pddl.yy"
+#line 776 "pddl.yy"
                              { (yyval.expr) = (yyvsp[0].fluent); }
-#line 2891 "pddl.cc"
+#line 2974 "pddl.cc"
     break;
 
   case 224: /* opt_ground_f_exp: %empty  */
-#line 691 "pddl.yy"
+#line 779 "pddl.yy"
                                { (yyval.expr) = 0; }
-#line 2897 "pddl.cc"
+#line 2980 "pddl.cc"
     break;
 
   case 226: /* $@38: %empty  */
-#line 695 "pddl.yy"
-                             { prepare_fluent((yyvsp[0].str)); }
-#line 2903 "pddl.cc"
+#line 783 "pddl.yy"
+                             { state.prepare_fluent((yyvsp[0].str)); }
+#line 2986 "pddl.cc"
     break;
 
   case 227: /* ground_f_head: '(' function $@38 names ')'  */
-#line 696 "pddl.yy"
-                  { (yyval.fluent) = make_fluent(); }
-#line 2909 "pddl.cc"
+#line 784 "pddl.yy"
+                  { (yyval.fluent) = state.make_fluent(); }
+#line 2992 "pddl.cc"
     break;
 
   case 228: /* ground_f_head: function  */
-#line 697 "pddl.yy"
-                         { prepare_fluent((yyvsp[0].str)); (yyval.fluent) = make_fluent(); }
-#line 2915 "pddl.cc"
+#line 786 "pddl.yy"
+                  { state.prepare_fluent((yyvsp[0].str)); (yyval.fluent) = state.make_fluent(); }
+#line 2998 "pddl.cc"
     break;
 
   case 230: /* terms: terms name  */
-#line 705 "pddl.yy"
-                   { add_term((yyvsp[0].str)); }
-#line 2921 "pddl.cc"
+#line 794 "pddl.yy"
+                   { state.add_term((yyvsp[0].str)); }
+#line 3004 "pddl.cc"
     break;
 
   case 231: /* terms: terms variable  */
-#line 706 "pddl.yy"
-                       { add_term((yyvsp[0].str)); }
-#line 2927 "pddl.cc"
+#line 795 "pddl.yy"
+                       { state.add_term((yyvsp[0].str)); }
+#line 3010 "pddl.cc"
     break;
 
   case 233: /* names: names name  */
-#line 710 "pddl.yy"
-                   { add_term((yyvsp[0].str)); }
-#line 2933 "pddl.cc"
+#line 799 "pddl.yy"
+                   { state.add_term((yyvsp[0].str)); }
+#line 3016 "pddl.cc"
     break;
 
   case 234: /* term: name  */
-#line 713 "pddl.yy"
-            { (yyval.term) = new Term(make_term((yyvsp[0].str))); }
-#line 2939 "pddl.cc"
+#line 802 "pddl.yy"
+            { (yyval.term) = new Term(state.make_term((yyvsp[0].str))); }
+#line 3022 "pddl.cc"
     break;
 
   case 235: /* term: variable  */
-#line 714 "pddl.yy"
-                { (yyval.term) = new Term(make_term((yyvsp[0].str))); }
-#line 2945 "pddl.cc"
+#line 803 "pddl.yy"
+                { (yyval.term) = new Term(state.make_term((yyvsp[0].str))); }
+#line 3028 "pddl.cc"
     break;
 
   case 237: /* variables: variable_seq  */
-#line 718 "pddl.yy"
-                         { add_variables((yyvsp[0].strs), TypeTable::OBJECT); }
-#line 2951 "pddl.cc"
+#line 807 "pddl.yy"
+                         { state.add_variables((yyvsp[0].strs), TypeTable::OBJECT); }
+#line 3034 "pddl.cc"
     break;
 
   case 238: /* $@39: %empty  */
-#line 719 "pddl.yy"
-                                   { add_variables((yyvsp[-1].strs), *(yyvsp[0].type)); delete (yyvsp[0].type); }
-#line 2957 "pddl.cc"
+#line 808 "pddl.yy"
+                                   { state.add_variables((yyvsp[-1].strs), *(yyvsp[0].type)); delete (yyvsp[0].type); }
+#line 3040 "pddl.cc"
     break;
 
   case 240: /* variable_seq: variable  */
-#line 723 "pddl.yy"
+#line 812 "pddl.yy"
                         { (yyval.strs) = new std::vector<const std::string*>(1, (yyvsp[0].str)); }
-#line 2963 "pddl.cc"
+#line 3046 "pddl.cc"
     break;
 
   case 241: /* variable_seq: variable_seq variable  */
-#line 724 "pddl.yy"
+#line 813 "pddl.yy"
                                      { (yyval.strs) = (yyvsp[-1].strs); (yyval.strs)->push_back((yyvsp[0].str)); }
-#line 2969 "pddl.cc"
+#line 3052 "pddl.cc"
     break;
 
   case 243: /* typed_names: name_seq  */
-#line 728 "pddl.yy"
-                       { add_names((yyvsp[0].strs), TypeTable::OBJECT); }
-#line 2975 "pddl.cc"
+#line 817 "pddl.yy"
+                       { state.add_names((yyvsp[0].strs), TypeTable::OBJECT); }
+#line 3058 "pddl.cc"
     break;
 
   case 244: /* $@40: %empty  */
-#line 729 "pddl.yy"
-                                 { add_names((yyvsp[-1].strs), *(yyvsp[0].type)); delete (yyvsp[0].type); }
-#line 2981 "pddl.cc"
+#line 818 "pddl.yy"
+                                 { state.add_names((yyvsp[-1].strs), *(yyvsp[0].type)); delete (yyvsp[0].type); }
+#line 3064 "pddl.cc"
     break;
 
   case 246: /* name_seq: name  */
-#line 732 "pddl.yy"
+#line 822 "pddl.yy"
                 { (yyval.strs) = new std::vector<const std::string*>(1, (yyvsp[0].str)); }
-#line 2987 "pddl.cc"
+#line 3070 "pddl.cc"
     break;
 
   case 247: /* name_seq: name_seq name  */
-#line 733 "pddl.yy"
+#line 823 "pddl.yy"
                          { (yyval.strs) = (yyvsp[-1].strs); (yyval.strs)->push_back((yyvsp[0].str)); }
-#line 2993 "pddl.cc"
+#line 3076 "pddl.cc"
     break;
 
   case 248: /* $@41: %empty  */
-#line 736 "pddl.yy"
-                { require_typing(); }
-#line 2999 "pddl.cc"
+#line 826 "pddl.yy"
+                { state.require_typing(); }
+#line 3082 "pddl.cc"
     break;
 
   case 249: /* type_spec: '-' $@41 type  */
-#line 736 "pddl.yy"
-                                           { (yyval.type) = (yyvsp[0].type); }
-#line 3005 "pddl.cc"
+#line 826 "pddl.yy"
+                                                 { (yyval.type) = (yyvsp[0].type); }
+#line 3088 "pddl.cc"
     break;
 
   case 250: /* type: object  */
-#line 739 "pddl.yy"
+#line 829 "pddl.yy"
               { (yyval.type) = new Type(TypeTable::OBJECT); }
-#line 3011 "pddl.cc"
+#line 3094 "pddl.cc"
     break;
 
   case 251: /* type: type_name  */
-#line 740 "pddl.yy"
-                 { (yyval.type) = new Type(make_type((yyvsp[0].str))); }
-#line 3017 "pddl.cc"
+#line 830 "pddl.yy"
+                 { (yyval.type) = new Type(state.make_type((yyvsp[0].str))); }
+#line 3100 "pddl.cc"
     break;
 
   case 252: /* type: '(' either types ')'  */
-#line 741 "pddl.yy"
-                            { (yyval.type) = new Type(make_type(*(yyvsp[-1].types))); delete (yyvsp[-1].types); }
-#line 3023 "pddl.cc"
+#line 831 "pddl.yy"
+                            { (yyval.type) = new Type(state.make_type(*(yyvsp[-1].types))); delete (yyvsp[-1].types); }
+#line 3106 "pddl.cc"
     break;
 
   case 253: /* types: object  */
-#line 744 "pddl.yy"
+#line 834 "pddl.yy"
                { (yyval.types) = new std::set<Type>(); }
-#line 3029 "pddl.cc"
+#line 3112 "pddl.cc"
     break;
 
   case 254: /* types: type_name  */
-#line 745 "pddl.yy"
-                  { (yyval.types) = new std::set<Type>(); (yyval.types)->insert(make_type((yyvsp[0].str))); }
-#line 3035 "pddl.cc"
+#line 836 "pddl.yy"
+          { (yyval.types) = new std::set<Type>(); (yyval.types)->insert(state.make_type((yyvsp[0].str))); }
+#line 3118 "pddl.cc"
     break;
 
   case 255: /* types: types object  */
-#line 746 "pddl.yy"
+#line 837 "pddl.yy"
                      { (yyval.types) = (yyvsp[-1].types); }
-#line 3041 "pddl.cc"
+#line 3124 "pddl.cc"
     break;
 
   case 256: /* types: types type_name  */
-#line 747 "pddl.yy"
-                        { (yyval.types) = (yyvsp[-1].types); (yyval.types)->insert(make_type((yyvsp[0].str))); }
-#line 3047 "pddl.cc"
+#line 838 "pddl.yy"
+                        { (yyval.types) = (yyvsp[-1].types); (yyval.types)->insert(state.make_type((yyvsp[0].str))); }
+#line 3130 "pddl.cc"
     break;
 
   case 258: /* define: DEFINE  */
-#line 757 "pddl.yy"
+#line 848 "pddl.yy"
                 { delete (yyvsp[0].str); }
-#line 3053 "pddl.cc"
+#line 3136 "pddl.cc"
     break;
 
   case 259: /* domain: DOMAIN_TOKEN  */
-#line 760 "pddl.yy"
+#line 851 "pddl.yy"
                       { delete (yyvsp[0].str); }
-#line 3059 "pddl.cc"
+#line 3142 "pddl.cc"
     break;
 
   case 260: /* problem: PROBLEM  */
-#line 763 "pddl.yy"
+#line 854 "pddl.yy"
                   { delete (yyvsp[0].str); }
-#line 3065 "pddl.cc"
+#line 3148 "pddl.cc"
     break;
 
   case 261: /* when: WHEN  */
-#line 766 "pddl.yy"
+#line 857 "pddl.yy"
             { delete (yyvsp[0].str); }
-#line 3071 "pddl.cc"
+#line 3154 "pddl.cc"
     break;
 
   case 262: /* not: NOT  */
-#line 769 "pddl.yy"
+#line 860 "pddl.yy"
           { delete (yyvsp[0].str); }
-#line 3077 "pddl.cc"
+#line 3160 "pddl.cc"
     break;
 
   case 263: /* and: AND  */
-#line 772 "pddl.yy"
+#line 863 "pddl.yy"
           { delete (yyvsp[0].str); }
-#line 3083 "pddl.cc"
+#line 3166 "pddl.cc"
     break;
 
   case 264: /* or: OR  */
-#line 775 "pddl.yy"
+#line 866 "pddl.yy"
         { delete (yyvsp[0].str); }
-#line 3089 "pddl.cc"
+#line 3172 "pddl.cc"
     break;
 
   case 265: /* imply: IMPLY  */
-#line 778 "pddl.yy"
+#line 869 "pddl.yy"
               { delete (yyvsp[0].str); }
-#line 3095 "pddl.cc"
+#line 3178 "pddl.cc"
     break;
 
   case 266: /* exists: EXISTS  */
-#line 781 "pddl.yy"
+#line 872 "pddl.yy"
                 { delete (yyvsp[0].str); }
-#line 3101 "pddl.cc"
+#line 3184 "pddl.cc"
     break;
 
   case 267: /* forall: FORALL  */
-#line 784 "pddl.yy"
+#line 875 "pddl.yy"
                 { delete (yyvsp[0].str); }
-#line 3107 "pddl.cc"
+#line 3190 "pddl.cc"
     break;
 
   case 268: /* at: AT  */
-#line 787 "pddl.yy"
+#line 878 "pddl.yy"
         { delete (yyvsp[0].str); }
-#line 3113 "pddl.cc"
+#line 3196 "pddl.cc"
     break;
 
   case 269: /* over: OVER  */
-#line 790 "pddl.yy"
+#line 881 "pddl.yy"
             { delete (yyvsp[0].str); }
-#line 3119 "pddl.cc"
+#line 3202 "pddl.cc"
     break;
 
   case 270: /* start: START  */
-#line 793 "pddl.yy"
+#line 884 "pddl.yy"
               { delete (yyvsp[0].str); }
-#line 3125 "pddl.cc"
+#line 3208 "pddl.cc"
     break;
 
   case 271: /* end: END  */
-#line 796 "pddl.yy"
+#line 887 "pddl.yy"
           { delete (yyvsp[0].str); }
-#line 3131 "pddl.cc"
+#line 3214 "pddl.cc"
     break;
 
   case 272: /* all: ALL  */
-#line 799 "pddl.yy"
+#line 890 "pddl.yy"
           { delete (yyvsp[0].str); }
-#line 3137 "pddl.cc"
+#line 3220 "pddl.cc"
     break;
 
   case 273: /* duration_var: DURATION_VAR  */
-#line 802 "pddl.yy"
+#line 893 "pddl.yy"
                             { delete (yyvsp[0].str); }
-#line 3143 "pddl.cc"
+#line 3226 "pddl.cc"
     break;
 
   case 274: /* minimize: MINIMIZE  */
-#line 805 "pddl.yy"
+#line 896 "pddl.yy"
                     { delete (yyvsp[0].str); }
-#line 3149 "pddl.cc"
+#line 3232 "pddl.cc"
     break;
 
   case 275: /* maximize: MAXIMIZE  */
-#line 808 "pddl.yy"
+#line 899 "pddl.yy"
                     { delete (yyvsp[0].str); }
-#line 3155 "pddl.cc"
+#line 3238 "pddl.cc"
     break;
 
   case 276: /* number: NUMBER_TOKEN  */
-#line 811 "pddl.yy"
+#line 902 "pddl.yy"
                       { delete (yyvsp[0].str); }
-#line 3161 "pddl.cc"
+#line 3244 "pddl.cc"
     break;
 
   case 277: /* object: OBJECT_TOKEN  */
-#line 814 "pddl.yy"
+#line 905 "pddl.yy"
                       { delete (yyvsp[0].str); }
-#line 3167 "pddl.cc"
+#line 3250 "pddl.cc"
     break;
 
   case 278: /* either: EITHER  */
-#line 817 "pddl.yy"
+#line 908 "pddl.yy"
                 { delete (yyvsp[0].str); }
-#line 3173 "pddl.cc"
+#line 3256 "pddl.cc"
     break;
 
 
-#line 3177 "pddl.cc"
+#line 3260 "pddl.cc"
 
       default: break;
     }
@@ -3220,7 +3303,7 @@ yyerrlab:
   if (!yyerrstatus)
     {
       ++yynerrs;
-      yyerror (YY_("syntax error"));
+      yyerror (state, scanner, YY_("syntax error"));
     }
 
   if (yyerrstatus == 3)
@@ -3237,7 +3320,7 @@ yyerrlab:
       else
         {
           yydestruct ("Error: discarding",
-                      yytoken, &yylval);
+                      yytoken, &yylval, state, scanner);
           yychar = YYEMPTY;
         }
     }
@@ -3293,7 +3376,7 @@ yyerrlab1:
 
 
       yydestruct ("Error: popping",
-                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, state, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -3331,7 +3414,7 @@ yyabortlab:
 | yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
 `-----------------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (YY_("memory exhausted"));
+  yyerror (state, scanner, YY_("memory exhausted"));
   yyresult = 2;
   goto yyreturnlab;
 
@@ -3346,7 +3429,7 @@ yyreturnlab:
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval);
+                  yytoken, &yylval, state, scanner);
     }
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
@@ -3355,7 +3438,7 @@ yyreturnlab:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, state, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
@@ -3366,21 +3449,60 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 853 "pddl.yy"
+#line 944 "pddl.yy"
+
+
+/* Constructs the state for parsing the source with the given name. */
+ParseState::ParseState(const std::string& name, std::ostream& messages)
+  : name(name), messages(&messages), line_number(1),
+    tables_lock(tables_mutex, std::defer_lock), success(true), domain(0),
+    problem(0), requirements(0), predicate(0), repeated_predicate(false),
+    function(0), repeated_function(false), action(0),
+    formula_time(AT_START), effect_time(Effect::AT_END),
+    effect_condition(0), atom_predicate(0),
+    undeclared_atom_predicate(false), metric_fluent(false),
+    fluent_function(0), undeclared_fluent_function(false),
+    name_kind(TYPE_KIND) {}
+
+
+/* Trades the shared hold on the tables for an exclusive one, unless
+   the state already holds them exclusively. */
+TableWriter::TableWriter(ParseState& state)
+  : state_(state), traded_(state.tables_lock.owns_lock()) {
+  if (traded_) {
+    state_.tables_lock.unlock();
+    tables_mutex.lock();
+  }
+}
+
+
+/* Trades the exclusive hold on the tables back for a shared one. */
+TableWriter::~TableWriter() {
+  if (traded_) {
+    tables_mutex.unlock();
+    state_.tables_lock.lock();
+  }
+}
+
+
+/* Outputs a syntax error message. */
+static void yyerror(ParseState& state, void* scanner, const std::string& s) {
+  state.error(s);
+}
 
 
 /* Outputs an error message. */
-static void yyerror(const std::string& s) {
-  std::cerr << PACKAGE ":" << current_file << ':' << line_number << ": " << s
+void ParseState::error(const std::string& s) {
+  *messages << PACKAGE ":" << name << ':' << line_number << ": " << s
             << std::endl;
   success = false;
 }
 
 
 /* Outputs a warning. */
-static void yywarning(const std::string& s) {
+void ParseState::warning(const std::string& s) {
   if (warning_level > 0) {
-    std::cerr << PACKAGE ":" << current_file << ':' << line_number << ": " << s
+    *messages << PACKAGE ":" << name << ':' << line_number << ": " << s
               << std::endl;
     if (warning_level > 1) {
       success = false;
@@ -3390,9 +3512,11 @@ static void yywarning(const std::string& s) {
 
 
 /* Creates an empty domain with the given name. */
-static void make_domain(const std::string* name) {
+void ParseState::make_domain(const std::string* name) {
+  TableWriter writer(*this);
   domain = new Domain(*name);
   domains[*name] = domain;
+  defined_domains.push_back(domain);
   requirements = &domain->requirements;
   problem = 0;
   delete name;
@@ -3400,66 +3524,77 @@ static void make_domain(const std::string* name) {
 
 
 /* Creates an empty problem with the given name. */
-static void make_problem(const std::string* name,
-                         const std::string* domain_name) {
+void ParseState::make_problem(const std::string* name,
+                              const std::string* domain_name) {
   std::map<std::string, Domain*>::const_iterator di =
     domains.find(*domain_name);
   if (di != domains.end()) {
     domain = (*di).second;
   } else {
-    domain = new Domain(*domain_name);
-    domains[*domain_name] = domain;
-    yyerror("undeclared domain `" + *domain_name + "' used");
+    TableWriter writer(*this);
+    di = domains.find(*domain_name);
+    if (di != domains.end()) {
+      domain = (*di).second;
+    } else {
+      domain = new Domain(*domain_name);
+      domains[*domain_name] = domain;
+    }
+    error("undeclared domain `" + *domain_name + "' used");
   }
   requirements = new PddlRequirements(domain->requirements);
   problem = new Problem(*name, *domain);
+  defined_problems.push_back(problem);
   delete name;
   delete domain_name;
 }
 
 /* Adds :typing to the requirements. */
-static void require_typing() {
+void ParseState::require_typing() {
   if (!requirements->typing()) {
-    yywarning("assuming `:typing' requirement");
+    warning("assuming `:typing' requirement");
     requirements->EnableTyping();
   }
 }
 
 
 /* Adds :fluents to the requirements. */
-static void require_fluents() {
+void ParseState::require_fluents() {
   if (!requirements->fluents()) {
-    yywarning("assuming `:fluents' requirement");
+    warning("assuming `:fluents' requirement");
     requirements->EnableFluents();
   }
 }
 
 
 /* Adds :disjunctive-preconditions to the requirements. */
-static void require_disjunction() {
+void ParseState::require_disjunction() {
   if (!requirements->disjunctive_preconditions()) {
-    yywarning("assuming `:disjunctive-preconditions' requirement");
+    warning("assuming `:disjunctive-preconditions' requirement");
     requirements->EnableDisjunctivePreconditions();
   }
 }
 
 
 /* Adds :duration-inequalities to the requirements. */
-static void require_duration_inequalities() {
+void ParseState::require_duration_inequalities() {
   if (!requirements->duration_inequalities()) {
-    yywarning("assuming `:duration-inequalities' requirement");
+    warning("assuming `:duration-inequalities' requirement");
     requirements->EnableDurationInequalities();
   }
 }
 
 
 /* Returns a simple type with the given name. */
-static const Type& make_type(const std::string* name) {
+const Type& ParseState::make_type(const std::string* name) {
   const Type* t = domain->types().find_type(*name);
   if (t == 0) {
-    t = &domain->types().add_type(*name);
+    TableWriter writer(*this);
+    t = domain->types().find_type(*name);
+    if (t == 0) {
+      t = &domain->types().add_type(*name);
+    }
     if (name_kind != TYPE_KIND) {
-      yywarning("implicit declaration of type `" + *name + "'");
+      warning("implicit declaration of type `" + *name + "'");
     }
   }
   delete name;
@@ -3468,12 +3603,13 @@ static const Type& make_type(const std::string* name) {
 
 
 /* Returns the union of the given types. */
-static Type make_type(const std::set<Type>& types) {
+Type ParseState::make_type(const std::set<Type>& types) {
+  TableWriter writer(*this);
   return TypeTable::union_type(types);
 }
 
 /* Returns a simple term with the given name. */
-static Term make_term(const std::string* name) {
+Term ParseState::make_term(const std::string* name) {
   if ((*name)[0] == '?') {
     const Variable* vp = context.find(*name);
     if (vp != 0) {
@@ -3482,7 +3618,7 @@ static Term make_term(const std::string* name) {
     } else {
       Variable v = TermTable::add_variable(TypeTable::OBJECT);
       context.insert(*name, v);
-      yyerror("free variable `" + *name + "' used");
+      error("free variable `" + *name + "' used");
       delete name;
       return v;
     }
@@ -3490,6 +3626,10 @@ static Term make_term(const std::string* name) {
     TermTable& terms = (problem != 0) ? problem->terms() : domain->terms();
     const Object* o = terms.find_object(*name);
     if (o == 0) {
+      std::unique_ptr<TableWriter> writer;
+      if (problem == 0) {
+        writer.reset(new TableWriter(*this));
+      }
       size_t n = term_parameters.size();
       if (atom_predicate != 0
           && PredicateTable::parameters(*atom_predicate).size() > n) {
@@ -3498,7 +3638,7 @@ static Term make_term(const std::string* name) {
       } else {
         o = &terms.add_object(*name, TypeTable::OBJECT);
       }
-      yywarning("implicit declaration of object `" + *name + "'");
+      warning("implicit declaration of object `" + *name + "'");
     }
     delete name;
     return *o;
@@ -3507,21 +3647,23 @@ static Term make_term(const std::string* name) {
 
 
 /* Creates a predicate with the given name. */
-static void make_predicate(const std::string* name) {
+void ParseState::make_predicate(const std::string* name) {
+  TableWriter writer(*this);
   predicate = domain->predicates().find_predicate(*name);
   if (predicate == 0) {
     repeated_predicate = false;
     predicate = &domain->predicates().add_predicate(*name);
   } else {
     repeated_predicate = true;
-    yywarning("ignoring repeated declaration of predicate `" + *name + "'");
+    warning("ignoring repeated declaration of predicate `" + *name + "'");
   }
   delete name;
 }
 
 
 /* Creates a function with the given name. */
-static void make_function(const std::string* name) {
+void ParseState::make_function(const std::string* name) {
+  TableWriter writer(*this);
   repeated_function = false;
   function = domain->functions().find_function(*name);
   if (function == 0) {
@@ -3529,9 +3671,9 @@ static void make_function(const std::string* name) {
   } else {
     repeated_function = true;
     if (*name == "total-time") {
-      yywarning("ignoring declaration of reserved function `" + *name + "'");
+      warning("ignoring declaration of reserved function `" + *name + "'");
     } else {
-      yywarning("ignoring repeated declaration of function `" + *name + "'");
+      warning("ignoring repeated declaration of function `" + *name + "'");
     }
   }
   delete name;
@@ -3539,10 +3681,10 @@ static void make_function(const std::string* name) {
 
 
 /* Creates an action with the given name. */
-static void make_action(const std::string* name, bool durative) {
+void ParseState::make_action(const std::string* name, bool durative) {
   if (durative) {
     if (!requirements->durative_actions()) {
-      yywarning("assuming `:durative-actions' requirement");
+      warning("assuming `:durative-actions' requirement");
       requirements->EnableDurativeActions();
     }
   }
@@ -3553,14 +3695,15 @@ static void make_action(const std::string* name, bool durative) {
 
 
 /* Adds the current action to the current domain. */
-static void add_action() {
+void ParseState::add_action() {
+  TableWriter writer(*this);
   context.pop_frame();
   if (domain->find_action(action->name()) == 0) {
     action->strengthen_effects(*domain);
     domain->add_action(*action);
   } else {
-    yywarning("ignoring repeated declaration of action `"
-              + action->name() + "'");
+    warning("ignoring repeated declaration of action `"
+            + action->name() + "'");
     delete action;
   }
   action = 0;
@@ -3568,9 +3711,9 @@ static void add_action() {
 
 
 /* Prepares for the parsing of a universally quantified effect. */
-static void prepare_forall_effect() {
+void ParseState::prepare_forall_effect() {
   if (!requirements->conditional_effects()) {
-    yywarning("assuming `:conditional-effects' requirement");
+    warning("assuming `:conditional-effects' requirement");
     requirements->EnableConditionalEffects();
   }
   context.push_frame();
@@ -3579,9 +3722,9 @@ static void prepare_forall_effect() {
 
 
 /* Prepares for the parsing of a conditional effect. */
-static void prepare_conditional_effect(const Formula& condition) {
+void ParseState::prepare_conditional_effect(const Formula& condition) {
   if (!requirements->conditional_effects()) {
-    yywarning("assuming `:conditional-effects' requirement");
+    warning("assuming `:conditional-effects' requirement");
     requirements->EnableConditionalEffects();
   }
   effect_condition = &condition;
@@ -3589,26 +3732,28 @@ static void prepare_conditional_effect(const Formula& condition) {
 
 
 /* Adds types, constants, or objects to the current domain or problem. */
-static void add_names(const std::vector<const std::string*>* names,
-                      const Type& type) {
+void ParseState::add_names(const std::vector<const std::string*>* names,
+                           const Type& type) {
   for (std::vector<const std::string*>::const_iterator si = names->begin();
        si != names->end(); si++) {
     const std::string* s = *si;
     if (name_kind == TYPE_KIND) {
+      TableWriter writer(*this);
       if (*s == TypeTable::OBJECT_NAME) {
-        yywarning("ignoring declaration of reserved type `object'");
+        warning("ignoring declaration of reserved type `object'");
       } else if (*s == TypeTable::NUMBER_NAME) {
-        yywarning("ignoring declaration of reserved type `number'");
+        warning("ignoring declaration of reserved type `number'");
       } else {
         const Type* t = domain->types().find_type(*s);
         if (t == 0) {
           t = &domain->types().add_type(*s);
         }
         if (!TypeTable::add_supertype(*t, type)) {
-          yyerror("cyclic type hierarchy");
+          error("cyclic type hierarchy");
         }
       }
     } else if (name_kind == CONSTANT_KIND) {
+      TableWriter writer(*this);
       const Object* o = domain->terms().find_object(*s);
       if (o == 0) {
         domain->terms().add_object(*s, type);
@@ -3620,8 +3765,8 @@ static void add_names(const std::vector<const std::string*>* names,
       }
     } else { /* name_kind == OBJECT_KIND */
       if (domain->terms().find_object(*s) != 0) {
-        yywarning("ignoring declaration of object `" + *s
-                  + "' previously declared as constant");
+        warning("ignoring declaration of object `" + *s
+                + "' previously declared as constant");
       } else {
         const Object* o = problem->terms().find_object(*s);
         if (o == 0) {
@@ -3641,24 +3786,26 @@ static void add_names(const std::vector<const std::string*>* names,
 
 
 /* Adds variables to the current variable list. */
-static void add_variables(const std::vector<const std::string*>* names,
-                          const Type& type) {
+void ParseState::add_variables(const std::vector<const std::string*>* names,
+                               const Type& type) {
   for (std::vector<const std::string*>::const_iterator si = names->begin();
        si != names->end(); si++) {
     const std::string* s = *si;
     if (predicate != 0) {
       if (!repeated_predicate) {
+        TableWriter writer(*this);
         PredicateTable::add_parameter(*predicate, type);
       }
     } else if (function != 0) {
       if (!repeated_function) {
+        TableWriter writer(*this);
         FunctionTable::add_parameter(*function, type);
       }
     } else {
       if (context.shallow_find(*s) != 0) {
-        yyerror("repetition of parameter `" + *s + "'");
+        error("repetition of parameter `" + *s + "'");
       } else if (context.find(*s) != 0) {
-        yywarning("shadowing parameter `" + *s + "'");
+        warning("shadowing parameter `" + *s + "'");
       }
       Variable var = TermTable::add_variable(type);
       context.insert(*s, var);
@@ -3675,15 +3822,19 @@ static void add_variables(const std::vector<const std::string*>* names,
 
 
 /* Prepares for the parsing of an atomic formula. */
-static void prepare_atom(const std::string* name) {
+void ParseState::prepare_atom(const std::string* name) {
   atom_predicate = domain->predicates().find_predicate(*name);
   if (atom_predicate == 0) {
-    atom_predicate = &domain->predicates().add_predicate(*name);
+    TableWriter writer(*this);
+    atom_predicate = domain->predicates().find_predicate(*name);
+    if (atom_predicate == 0) {
+      atom_predicate = &domain->predicates().add_predicate(*name);
+    }
     undeclared_atom_predicate = true;
     if (problem != 0) {
-      yywarning("undeclared predicate `" + *name + "' used");
+      warning("undeclared predicate `" + *name + "' used");
     } else {
-      yywarning("implicit declaration of predicate `" + *name + "'");
+      warning("implicit declaration of predicate `" + *name + "'");
     }
   } else {
     undeclared_atom_predicate = false;
@@ -3694,22 +3845,26 @@ static void prepare_atom(const std::string* name) {
 
 
 /* Prepares for the parsing of a fluent. */
-static void prepare_fluent(const std::string* name) {
+void ParseState::prepare_fluent(const std::string* name) {
   fluent_function = domain->functions().find_function(*name);
   if (fluent_function == 0) {
-    fluent_function = &domain->functions().add_function(*name);
+    TableWriter writer(*this);
+    fluent_function = domain->functions().find_function(*name);
+    if (fluent_function == 0) {
+      fluent_function = &domain->functions().add_function(*name);
+    }
     undeclared_fluent_function = true;
     if (problem != 0) {
-      yywarning("undeclared function `" + *name + "' used");
+      warning("undeclared function `" + *name + "' used");
     } else {
-      yywarning("implicit declaration of function `" + *name + "'");
+      warning("implicit declaration of function `" + *name + "'");
     }
   } else {
     undeclared_fluent_function = false;
   }
   if (*name == "total-time") {
     if (!metric_fluent) {
-      yyerror("reserved function `" + *name + "' not allowed here");
+      error("reserved function `" + *name + "' not allowed here");
     }
   } else {
     require_fluents();
@@ -3720,30 +3875,32 @@ static void prepare_fluent(const std::string* name) {
 
 
 /* Adds a term with the given name to the current atomic formula. */
-static void add_term(const std::string* name) {
+void ParseState::add_term(const std::string* name) {
   Term term = make_term(name);
   if (atom_predicate != 0) {
     size_t n = term_parameters.size();
     if (undeclared_atom_predicate) {
+      TableWriter writer(*this);
       PredicateTable::add_parameter(*atom_predicate, TermTable::type(term));
     } else {
       const std::vector<Type>& params =
           PredicateTable::parameters(*atom_predicate);
       if (params.size() > n
           && !TypeTable::subtype(TermTable::type(term), params[n])) {
-        yyerror("type mismatch");
+        error("type mismatch");
       }
     }
   } else if (fluent_function != 0) {
     size_t n = term_parameters.size();
     if (undeclared_fluent_function) {
+      TableWriter writer(*this);
       FunctionTable::add_parameter(*fluent_function, TermTable::type(term));
     } else {
       const std::vector<Type>& params =
           FunctionTable::parameters(*fluent_function);
       if (params.size() > n
           && !TypeTable::subtype(TermTable::type(term), params[n])) {
-        yyerror("type mismatch");
+        error("type mismatch");
       }
     }
   }
@@ -3752,14 +3909,14 @@ static void add_term(const std::string* name) {
 
 
 /* Creates the atomic formula just parsed. */
-static const Atom* make_atom() {
+const Atom* ParseState::make_atom() {
   size_t n = term_parameters.size();
   if (PredicateTable::parameters(*atom_predicate).size() < n) {
-    yyerror("too many parameters passed to predicate `"
-            + PredicateTable::name(*atom_predicate) + "'");
+    error("too many parameters passed to predicate `"
+          + PredicateTable::name(*atom_predicate) + "'");
   } else if (PredicateTable::parameters(*atom_predicate).size() > n) {
-    yyerror("too few parameters passed to predicate `"
-            + PredicateTable::name(*atom_predicate) + "'");
+    error("too few parameters passed to predicate `"
+          + PredicateTable::name(*atom_predicate) + "'");
   }
   const Atom& atom = Atom::make(*atom_predicate, term_parameters);
   atom_predicate = 0;
@@ -3768,14 +3925,14 @@ static const Atom* make_atom() {
 
 
 /* Creates the fluent just parsed. */
-static const Fluent* make_fluent() {
+const Fluent* ParseState::make_fluent() {
   size_t n = term_parameters.size();
   if (FunctionTable::parameters(*fluent_function).size() < n) {
-    yyerror("too many parameters passed to function `"
-            + FunctionTable::name(*fluent_function) + "'");
+    error("too many parameters passed to function `"
+          + FunctionTable::name(*fluent_function) + "'");
   } else if (FunctionTable::parameters(*fluent_function).size() > n) {
-    yyerror("too few parameters passed to function `"
-            + FunctionTable::name(*fluent_function) + "'");
+    error("too few parameters passed to function `"
+          + FunctionTable::name(*fluent_function) + "'");
   }
   const Fluent& fluent = Fluent::make(*fluent_function, term_parameters);
   fluent_function = 0;
@@ -3784,8 +3941,8 @@ static const Fluent* make_fluent() {
 
 
 /* Creates a subtraction. */
-static const Expression* make_subtraction(const Expression& term,
-                                          const Expression* opt_term) {
+const Expression* ParseState::make_subtraction(const Expression& term,
+                                               const Expression* opt_term) {
   if (opt_term != 0) {
     return &Subtraction::make(term, *opt_term);
   } else {
@@ -3795,9 +3952,10 @@ static const Expression* make_subtraction(const Expression& term,
 
 
 /* Creates an equality formula. */
-static const Formula* make_equality(const Term* term1, const Term* term2) {
+const Formula* ParseState::make_equality(const Term* term1,
+                                         const Term* term2) {
   if (!requirements->equality()) {
-    yywarning("assuming `:equality' requirement");
+    warning("assuming `:equality' requirement");
     requirements->EnableEquality();
   }
   const Formula& eq = Equality::make(*term1, *term2);
@@ -3808,16 +3966,16 @@ static const Formula* make_equality(const Term* term1, const Term* term2) {
 
 
 /* Creates a negated formula. */
-static const Formula* make_negation(const Formula& negand) {
+const Formula* ParseState::make_negation(const Formula& negand) {
   if (typeid(negand) == typeid(Literal)
       || typeid(negand) == typeid(TimedLiteral)) {
     if (!requirements->negative_preconditions()) {
-      yywarning("assuming `:negative-preconditions' requirement");
+      warning("assuming `:negative-preconditions' requirement");
       requirements->EnableNegativePreconditions();
     }
   } else if (!requirements->disjunctive_preconditions() &&
              typeid(negand) != typeid(Equality)) {
-    yywarning("assuming `:disjunctive-preconditions' requirement");
+    warning("assuming `:disjunctive-preconditions' requirement");
     requirements->EnableDisjunctivePreconditions();
   }
   return &!negand;
@@ -3825,9 +3983,9 @@ static const Formula* make_negation(const Formula& negand) {
 
 
 /* Prepares for the parsing of an existentially quantified formula. */
-static void prepare_exists() {
+void ParseState::prepare_exists() {
   if (!requirements->existential_preconditions()) {
-    yywarning("assuming `:existential-preconditions' requirement");
+    warning("assuming `:existential-preconditions' requirement");
     requirements->EnableExistentialPreconditions();
   }
   context.push_frame();
@@ -3836,9 +3994,9 @@ static void prepare_exists() {
 
 
 /* Prepares for the parsing of a universally quantified formula. */
-static void prepare_forall() {
+void ParseState::prepare_forall() {
   if (!requirements->universal_preconditions()) {
-    yywarning("assuming `:universal-preconditions' requirement");
+    warning("assuming `:universal-preconditions' requirement");
     requirements->EnableUniversalPreconditions();
   }
   context.push_frame();
@@ -3847,7 +4005,7 @@ static void prepare_forall() {
 
 
 /* Creates an existentially quantified formula. */
-static const Formula* make_exists(const Formula& body) {
+const Formula* ParseState::make_exists(const Formula& body) {
   context.pop_frame();
   size_t m = quantified.size() - 1;
   size_t n = m;
@@ -3875,7 +4033,7 @@ static const Formula* make_exists(const Formula& body) {
 
 
 /* Creates a universally quantified formula. */
-static const Formula* make_forall(const Formula& body) {
+const Formula* ParseState::make_forall(const Formula& body) {
   context.pop_frame();
   size_t m = quantified.size() - 1;
   size_t n = m;
@@ -3903,8 +4061,11 @@ static const Formula* make_forall(const Formula& body) {
 
 
 /* Adds the current effect to the currect action. */
-static void add_effect(const Literal& literal) {
-  PredicateTable::make_dynamic(literal.predicate());
+void ParseState::add_effect(const Literal& literal) {
+  {
+    TableWriter writer(*this);
+    PredicateTable::make_dynamic(literal.predicate());
+  }
   Effect* effect = new Effect(literal, effect_time);
   for (std::vector<Term>::const_iterator vi = quantified.begin();
        vi != quantified.end(); vi++) {
@@ -3920,7 +4081,7 @@ static void add_effect(const Literal& literal) {
 
 
 /* Pops the top-most universally quantified variables. */
-static void pop_forall_effect() {
+void ParseState::pop_forall_effect() {
   context.pop_frame();
   size_t n = quantified.size() - 1;
   while (quantified[n].variable()) {
@@ -3931,9 +4092,69 @@ static void pop_forall_effect() {
 
 
 /* Adds a timed initial literal to the current problem. */
-static void add_init_literal(float time, const Literal& literal) {
+void ParseState::add_init_literal(float time, const Literal& literal) {
   problem->add_init_literal(time, literal);
   if (time > 0.0f) {
+    TableWriter writer(*this);
     PredicateTable::make_dynamic(literal.predicate());
   }
 }
+
+
+/* Parses the source the given scanner is set up for while holding the
+   tables shared, and returns true on success. */
+static bool parse_source(ParseState& state, void* scanner) {
+  state.tables_lock.lock();
+  bool success = (yyparse(state, scanner) == 0);
+  state.tables_lock.unlock();
+  yylex_destroy(scanner);
+  return success;
+}
+
+
+/* Constructs a parser for the source with the given name, which
+   reports errors and warnings on the given stream. */
+PddlParser::PddlParser(const std::string& name, std::ostream& messages)
+  : state_(new ParseState(name, messages)) {}
+
+
+/* Deletes this parser. */
+PddlParser::~PddlParser() {
+  delete state_;
+}
+
+
+/* Parses the given buffer in place, and returns true on success. */
+bool PddlParser::parse(char* buffer, size_t size) {
+  void* scanner;
+  yylex_init_extra(&state_->line_number, &scanner);
+  yy_scan_buffer(buffer, size, scanner);
+  return parse_source(*state_, scanner);
+}
+
+
+/* Parses the given file, and returns true on success. */
+bool PddlParser::parse(FILE* file) {
+  void* scanner;
+  yylex_init_extra(&state_->line_number, &scanner);
+  yyset_in(file, scanner);
+  return parse_source(*state_, scanner);
+}
+
+
+/* Returns the domains defined by the parsed source, in order. */
+const std::vector<const Domain*>& PddlParser::domains() const {
+  return state_->defined_domains;
+}
+
+
+/* Returns the problems defined by the parsed source, in order. */
+const std::vector<const Problem*>& PddlParser::problems() const {
+  return state_->defined_problems;
+}
+
+
+/* Returns a shared hold on the tables that parsers add to. */
+std::shared_lock<std::shared_mutex> PddlParser::read_tables() {
+  return std::shared_lock<std::shared_mutex>(tables_mutex);
+}
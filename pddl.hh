@@ -187,7 +187,7 @@ extern int yydebug;
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 228 "pddl.yy"
+#line 294 "pddl.yy"
 
   const Formula* formula;
   const Literal* literal;
@@ -210,10 +210,9 @@ typedef union YYSTYPE YYSTYPE;
 #endif
 
 
-extern YYSTYPE yylval;
 
 
-int yyparse (void);
+int yyparse (ParseState& state, void* scanner);
 
 
 #endif /* !YY_YY_PDDL_HH_INCLUDED  */
@@ -21,14 +21,19 @@
 // PDDL parser.
 
 %{
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <typeinfo>
 #include <utility>
 
 #include <config.h>
 
 #include "domains.h"
+#include "parser.h"
 #include "formulas.h"
 #include "functions.h"
 #include "predicates.h"
@@ -85,134 +90,195 @@ private:
 };
 
 
+/* Kind of name map being parsed. */
+enum NameKind { TYPE_KIND, CONSTANT_KIND, OBJECT_KIND, VOID_KIND };
+
+/*
+ * State of a single parse.  Each parse has its own state, so that
+ * several sources can be parsed at the same time.
+ */
+struct ParseState {
+  /* Constructs the state for parsing the source with the given name. */
+  ParseState(const std::string& name, std::ostream& messages);
+
+  /* Name of the source being parsed. */
+  std::string name;
+  /* Stream for error and warning messages. */
+  std::ostream* messages;
+  /* Current line number. */
+  size_t line_number;
+  /* Shared hold on the predicate, function, and type tables. */
+  std::shared_lock<std::shared_mutex> tables_lock;
+  /* Domains defined by the source. */
+  std::vector<const Domain*> defined_domains;
+  /* Problems defined by the source. */
+  std::vector<const Problem*> defined_problems;
+
+  /* Whether the last parsing attempt succeeded. */
+  bool success;
+  /* Current domain. */
+  Domain* domain;
+  /* Problem being parsed, or 0 if no problem is being parsed. */
+  Problem* problem;
+  /* Current requirements. */
+  PddlRequirements* requirements;
+  /* Predicate being parsed. */
+  const Predicate* predicate;
+  /* Whether predicate declaration is repeated. */
+  bool repeated_predicate;
+  /* Function being parsed. */
+  const Function* function;
+  /* Whether function declaration is repeated. */
+  bool repeated_function;
+  /* Action being parsed, or 0 if no action is being parsed. */
+  ActionSchema* action;
+  /* Time of current condition. */
+  FormulaTime formula_time;
+  /* Time of current effect. */
+  Effect::EffectTime effect_time;
+  /* Condition for effect being parsed, or 0 if unconditional effect. */
+  const Formula* effect_condition;
+  /* Current variable context. */
+  Context context;
+  /* Predicate for atomic formula being parsed. */
+  const Predicate* atom_predicate;
+  /* Whether the predicate of the currently parsed atom was undeclared. */
+  bool undeclared_atom_predicate;
+  /* Whether parsing metric fluent. */
+  bool metric_fluent;
+  /* Function for fluent being parsed. */
+  const Function* fluent_function;
+  /* Whether the function of the currently parsed fluent was undeclared. */
+  bool undeclared_fluent_function;
+  /* Paramerers for atomic formula or fluent being parsed. */
+  std::vector<Term> term_parameters;
+  /* Quantified variables for effect or formula being parsed. */
+  std::vector<Term> quantified;
+  /* Kind of name map being parsed. */
+  NameKind name_kind;
+
+  /* Outputs an error message. */
+  void error(const std::string& s);
+  /* Outputs a warning message. */
+  void warning(const std::string& s);
+  /* Creates an empty domain with the given name. */
+  void make_domain(const std::string* name);
+  /* Creates an empty problem with the given name. */
+  void make_problem(const std::string* name, const std::string* domain_name);
+  /* Adds :typing to the requirements. */
+  void require_typing();
+  /* Adds :fluents to the requirements. */
+  void require_fluents();
+  /* Adds :disjunctive-preconditions to the requirements. */
+  void require_disjunction();
+  /* Adds :duration-inequalities to the requirements. */
+  void require_duration_inequalities();
+  /* Returns a simple type with the given name. */
+  const Type& make_type(const std::string* name);
+  /* Returns the union of the given types. */
+  Type make_type(const std::set<Type>& types);
+  /* Returns a simple term with the given name. */
+  Term make_term(const std::string* name);
+  /* Creates a predicate with the given name. */
+  void make_predicate(const std::string* name);
+  /* Creates a function with the given name. */
+  void make_function(const std::string* name);
+  /* Creates an action with the given name. */
+  void make_action(const std::string* name, bool durative);
+  /* Adds the current action to the current domain. */
+  void add_action();
+  /* Prepares for the parsing of a universally quantified effect. */
+  void prepare_forall_effect();
+  /* Prepares for the parsing of a conditional effect. */
+  void prepare_conditional_effect(const Formula& condition);
+  /* Adds types, constants, or objects to the current domain or problem. */
+  void add_names(const std::vector<const std::string*>* names,
+                 const Type& type);
+  /* Adds variables to the current variable list. */
+  void add_variables(const std::vector<const std::string*>* names,
+                     const Type& type);
+  /* Prepares for the parsing of an atomic formula. */
+  void prepare_atom(const std::string* name);
+  /* Prepares for the parsing of a fluent. */
+  void prepare_fluent(const std::string* name);
+  /* Adds a term with the given name to the current atomic formula. */
+  void add_term(const std::string* name);
+  /* Creates the atomic formula just parsed. */
+  const Atom* make_atom();
+  /* Creates the fluent just parsed. */
+  const Fluent* make_fluent();
+  /* Creates a subtraction. */
+  const Expression* make_subtraction(const Expression& term,
+                                     const Expression* opt_term);
+  /* Creates an equality formula. */
+  const Formula* make_equality(const Term* term1, const Term* term2);
+  /* Creates a negation. */
+  const Formula* make_negation(const Formula& negand);
+  /* Prepares for the parsing of an existentially quantified formula. */
+  void prepare_exists();
+  /* Prepares for the parsing of a universally quantified formula. */
+  void prepare_forall();
+  /* Creates an existentially quantified formula. */
+  const Formula* make_exists(const Formula& body);
+  /* Creates a universally quantified formula. */
+  const Formula* make_forall(const Formula& body);
+  /* Adds the given literal as an effect to the currect action. */
+  void add_effect(const Literal& literal);
+  /* Pops the top-most universally quantified variables. */
+  void pop_forall_effect();
+  /* Adds a timed initial literal to the current problem. */
+  void add_init_literal(float time, const Literal& literal);
+};
+
+
+/*
+ * Exclusive hold on the predicate, function, and type tables for the
+ * lifetime of this object.  The tables are shared by all parses, so a
+ * parse holds them shared and trades up to an exclusive hold whenever
+ * it adds to them.
+ */
+struct TableWriter {
+  explicit TableWriter(ParseState& state);
+  ~TableWriter();
+
+private:
+  /* State of the parse holding the tables. */
+  ParseState& state_;
+  /* Whether the shared hold was traded for an exclusive one. */
+  bool traded_;
+};
+
+
+union YYSTYPE;
 /* The lexer. */
-extern int yylex();
-/* Current line number. */
-extern size_t line_number;
-/* Name of current file. */
-extern std::string current_file;
+extern int yylex(YYSTYPE* lvalp, void* scanner);
+/* Input buffer of a scanner. */
+typedef struct yy_buffer_state* YY_BUFFER_STATE;
+/* Creates a scanner that counts lines in the given variable. */
+extern int yylex_init_extra(size_t* line_number, void** scanner);
+/* Starts scanning the given buffer in place.  The last two bytes of
+   the buffer must be zero. */
+extern YY_BUFFER_STATE yy_scan_buffer(char* base, size_t size, void* scanner);
+/* Starts scanning the given file. */
+extern void yyset_in(FILE* file, void* scanner);
+/* Deletes the given scanner and its input buffers. */
+extern int yylex_destroy(void* scanner);
 /* Level of warnings. */
 extern int warning_level;
 
-/* Whether the last parsing attempt succeeded. */
-static bool success = true;
-/* Current domain. */
-static Domain* domain;
+/* Guards the predicate, function, and type tables. */
+static std::shared_mutex tables_mutex;
 /* Domains. */
 static std::map<std::string, Domain*> domains;
-/* Problem being parsed, or 0 if no problem is being parsed. */
-static Problem* problem;
-/* Current requirements. */
-static PddlRequirements* requirements;
-/* Predicate being parsed. */
-static const Predicate* predicate;
-/* Whether predicate declaration is repeated. */
-static bool repeated_predicate;
-/* Function being parsed. */
-static const Function* function;
-/* Whether function declaration is repeated. */
-static bool repeated_function;
-/* Action being parsed, or 0 if no action is being parsed. */
-static ActionSchema* action;
-/* Time of current condition. */
-static FormulaTime formula_time;
-/* Time of current effect. */
-static Effect::EffectTime effect_time;
-/* Condition for effect being parsed, or 0 if unconditional effect. */
-static const Formula* effect_condition;
-/* Current variable context. */
-static Context context;
-/* Predicate for atomic formula being parsed. */
-static const Predicate* atom_predicate;
-/* Whether the predicate of the currently parsed atom was undeclared. */
-static bool undeclared_atom_predicate;
-/* Whether parsing metric fluent. */
-static bool metric_fluent;
-/* Function for fluent being parsed. */
-static const Function* fluent_function;
-/* Whether the function of the currently parsed fluent was undeclared. */
-static bool undeclared_fluent_function;
-/* Paramerers for atomic formula or fluent being parsed. */
-static std::vector<Term> term_parameters;
-/* Quantified variables for effect or formula being parsed. */
-static std::vector<Term> quantified;
-/* Kind of name map being parsed. */
-static enum { TYPE_KIND, CONSTANT_KIND, OBJECT_KIND, VOID_KIND } name_kind;
 
-/* Outputs an error message. */
-static void yyerror(const std::string& s);
-/* Outputs a warning message. */
-static void yywarning(const std::string& s);
-/* Creates an empty domain with the given name. */
-static void make_domain(const std::string* name);
-/* Creates an empty problem with the given name. */
-static void make_problem(const std::string* name,
-                         const std::string* domain_name);
-/* Adds :typing to the requirements. */
-static void require_typing();
-/* Adds :fluents to the requirements. */
-static void require_fluents();
-/* Adds :disjunctive-preconditions to the requirements. */
-static void require_disjunction();
-/* Adds :duration-inequalities to the requirements. */
-static void require_duration_inequalities();
-/* Returns a simple type with the given name. */
-static const Type& make_type(const std::string* name);
-/* Returns the union of the given types. */
-static Type make_type(const std::set<Type>& types);
-/* Returns a simple term with the given name. */
-static Term make_term(const std::string* name);
-/* Creates a predicate with the given name. */
-static void make_predicate(const std::string* name);
-/* Creates a function with the given name. */
-static void make_function(const std::string* name);
-/* Creates an action with the given name. */
-static void make_action(const std::string* name, bool durative);
-/* Adds the current action to the current domain. */
-static void add_action();
-/* Prepares for the parsing of a universally quantified effect. */
-static void prepare_forall_effect();
-/* Prepares for the parsing of a conditional effect. */
-static void prepare_conditional_effect(const Formula& condition);
-/* Adds types, constants, or objects to the current domain or problem. */
-static void add_names(const std::vector<const std::string*>* names,
-                      const Type& type);
-/* Adds variables to the current variable list. */
-static void add_variables(const std::vector<const std::string*>* names,
-                          const Type& type);
-/* Prepares for the parsing of an atomic formula. */
-static void prepare_atom(const std::string* name);
-/* Prepares for the parsing of a fluent. */
-static void prepare_fluent(const std::string* name);
-/* Adds a term with the given name to the current atomic formula. */
-static void add_term(const std::string* name);
-/* Creates the atomic formula just parsed. */
-static const Atom* make_atom();
-/* Creates the fluent just parsed. */
-static const Fluent* make_fluent();
-/* Creates a subtraction. */
-static const Expression* make_subtraction(const Expression& term,
-                                          const Expression* opt_term);
-/* Creates an equality formula. */
-static const Formula* make_equality(const Term* term1, const Term* term2);
-/* Creates a negation. */
-static const Formula* make_negation(const Formula& negand);
-/* Prepares for the parsing of an existentially quantified formula. */
-static void prepare_exists();
-/* Prepares for the parsing of a universally quantified formula. */
-static void prepare_forall();
-/* Creates an existentially quantified formula. */
-static const Formula* make_exists(const Formula& body);
-/* Creates a universally quantified formula. */
-static const Formula* make_forall(const Formula& body);
-/* Adds the given literal as an effect to the currect action. */
-static void add_effect(const Literal& literal);
-/* Pops the top-most universally quantified variables. */
-static void pop_forall_effect();
-/* Adds a timed initial literal to the current problem. */
-static void add_init_literal(float time, const Literal& literal);
+/* Outputs a syntax error message. */
+static void yyerror(ParseState& state, void* scanner, const std::string& s);
 %}
 
+%define api.pure full
+%parse-param {ParseState& state} {void* scanner}
+%lex-param {void* scanner}
+
 %token REQUIREMENTS TYPES CONSTANTS PREDICATES FUNCTIONS
 %token STRIPS TYPING NEGATIVE_PRECONDITIONS DISJUNCTIVE_PRECONDITIONS EQUALITY
 %token EXISTENTIAL_PRECONDITIONS UNIVERSAL_PRECONDITIONS
@@ -259,8 +325,9 @@ static void add_init_literal(float time, const Literal& literal);
 
 %%
 
-pddl_file : { success = true; line_number = 1; } domains_and_problems
-              { if (!success) YYERROR; }
+pddl_file : { state.success = true; state.line_number = 1; }
+              domains_and_problems
+              { if (!state.success) YYERROR; }
           ;
 
 domains_and_problems : /* empty */
@@ -272,7 +339,7 @@ domains_and_problems : /* empty */
 /* ====================================================================== */
 /* Domain definitions. */
 
-domain_def : '(' define '(' domain name ')' { make_domain($5); }
+domain_def : '(' define '(' domain name ')' { state.make_domain($5); }
                domain_body ')'
            ;
 
@@ -347,45 +414,47 @@ require_keys : require_key
              ;
 
 require_key : STRIPS
-            | TYPING { requirements->EnableTyping(); }
+            | TYPING { state.requirements->EnableTyping(); }
             | NEGATIVE_PRECONDITIONS
-                { requirements->EnableNegativePreconditions(); }
+                { state.requirements->EnableNegativePreconditions(); }
             | DISJUNCTIVE_PRECONDITIONS
-                { requirements->EnableDisjunctivePreconditions(); }
-            | EQUALITY { requirements->EnableEquality(); }
+                { state.requirements->EnableDisjunctivePreconditions(); }
+            | EQUALITY { state.requirements->EnableEquality(); }
             | EXISTENTIAL_PRECONDITIONS
-                { requirements->EnableExistentialPreconditions(); }
+                { state.requirements->EnableExistentialPreconditions(); }
             | UNIVERSAL_PRECONDITIONS
-                { requirements->EnableUniversalPreconditions(); }
+                { state.requirements->EnableUniversalPreconditions(); }
             | QUANTIFIED_PRECONDITIONS
-                { requirements->EnableQuantifiedPreconditions(); }
-            | CONDITIONAL_EFFECTS { requirements->EnableConditionalEffects(); }
-            | FLUENTS { requirements->EnableFluents(); }
-            | ADL { requirements->EnableAdl(); }
-            | DURATIVE_ACTIONS { requirements->EnableDurativeActions(); }
+                { state.requirements->EnableQuantifiedPreconditions(); }
+            | CONDITIONAL_EFFECTS
+                { state.requirements->EnableConditionalEffects(); }
+            | FLUENTS { state.requirements->EnableFluents(); }
+            | ADL { state.requirements->EnableAdl(); }
+            | DURATIVE_ACTIONS { state.requirements->EnableDurativeActions(); }
             | DURATION_INEQUALITIES
-                { requirements->EnableDurationInequalities(); }
+                { state.requirements->EnableDurationInequalities(); }
             | CONTINUOUS_EFFECTS
                 {
-                  requirements->EnableContinuousEffects();
-                  yyerror("`:continuous-effects' not supported");
+                  state.requirements->EnableContinuousEffects();
+                  state.error("`:continuous-effects' not supported");
                 }
             | TIMED_INITIAL_LITERALS
-                { requirements->EnableTimedInitialLiterals(); }
+                { state.requirements->EnableTimedInitialLiterals(); }
             ;
 
-types_def : '(' TYPES { require_typing(); name_kind = TYPE_KIND; }
-              typed_names ')' { name_kind = VOID_KIND; }
+types_def : '(' TYPES { state.require_typing(); state.name_kind = TYPE_KIND; }
+              typed_names ')' { state.name_kind = VOID_KIND; }
           ;
 
-constants_def : '(' CONSTANTS { name_kind = CONSTANT_KIND; } typed_names ')'
-                  { name_kind = VOID_KIND; }
+constants_def : '(' CONSTANTS { state.name_kind = CONSTANT_KIND; }
+                  typed_names ')'
+                  { state.name_kind = VOID_KIND; }
               ;
 
 predicates_def : '(' PREDICATES predicate_decls ')'
                ;
 
-functions_def : '(' FUNCTIONS { require_fluents(); } function_decls ')'
+functions_def : '(' FUNCTIONS { state.require_fluents(); } function_decls ')'
               ;
 
 
@@ -396,8 +465,8 @@ predicate_decls : /* empty */
                 | predicate_decls predicate_decl
                 ;
 
-predicate_decl : '(' predicate { make_predicate($2); } variables ')'
-                   { predicate = 0; }
+predicate_decl : '(' predicate { state.make_predicate($2); } variables ')'
+                   { state.predicate = 0; }
                ;
 
 function_decls : /* empty */
@@ -409,22 +478,22 @@ function_decl_seq : function_decl
                   | function_decl_seq function_decl
                   ;
 
-function_type_spec : '-' { require_typing(); } function_type
+function_type_spec : '-' { state.require_typing(); } function_type
                    ;
 
-function_decl : '(' function { make_function($2); } variables ')'
-                  { function = 0; }
+function_decl : '(' function { state.make_function($2); } variables ')'
+                  { state.function = 0; }
               ;
 
 
 /* ====================================================================== */
 /* Actions. */
 
-action_def : '(' ACTION name { make_action($3, false); }
-               parameters action_body ')' { add_action(); }
-           | '(' DURATIVE_ACTION name { make_action($3, true); }
+action_def : '(' ACTION name { state.make_action($3, false); }
+               parameters action_body ')' { state.add_action(); }
+           | '(' DURATIVE_ACTION name { state.make_action($3, true); }
                parameters DURATION duration_constraint da_body ')'
-               { add_action(); }
+               { state.add_action(); }
            ;
 
 parameters : /* empty */
@@ -439,14 +508,14 @@ action_body2 : /* empty */
              | effect
              ;
 
-precondition : PRECONDITION { formula_time = AT_START; } formula
-                 { action->set_condition(*$3); }
+precondition : PRECONDITION { state.formula_time = AT_START; } formula
+                 { state.action->set_condition(*$3); }
              ;
 
-effect : EFFECT { effect_time = Effect::AT_END; } eff_formula
+effect : EFFECT { state.effect_time = Effect::AT_END; } eff_formula
        ;
 
-da_body : CONDITION da_gd da_body2 { action->set_condition(*$2); }
+da_body : CONDITION da_gd da_body2 { state.action->set_condition(*$2); }
         | da_body2
         ;
 
@@ -460,21 +529,21 @@ da_body2 : /* empty */
 
 duration_constraint : simple_duration_constraint
                     | '(' and simple_duration_constraints ')'
-                        { require_duration_inequalities(); }
+                        { state.require_duration_inequalities(); }
                     ;
 
 simple_duration_constraint : '(' LE duration_var f_exp ')'
                                {
-                                 require_duration_inequalities();
-                                 action->set_max_duration(*$4);
+                                 state.require_duration_inequalities();
+                                 state.action->set_max_duration(*$4);
                                }
                            | '(' GE duration_var f_exp ')'
                                {
-                                 require_duration_inequalities();
-                                 action->set_min_duration(*$4);
+                                 state.require_duration_inequalities();
+                                 state.action->set_min_duration(*$4);
                                }
                            | '(' '=' duration_var f_exp ')'
-                               { action->set_duration(*$4); }
+                               { state.action->set_duration(*$4); }
                            ;
 
 simple_duration_constraints : /* empty */
@@ -494,9 +563,12 @@ timed_gds : /* empty */ { $$ = &Formula::TRUE; }
           | timed_gds timed_gd { $$ = &(*$1 && *$2); }
           ;
 
-timed_gd : '(' at start { formula_time = AT_START; } formula ')' { $$ = $5; }
-         | '(' at end { formula_time = AT_END; } formula ')' { $$ = $5; }
-         | '(' over all { formula_time = OVER_ALL; } formula ')' { $$ = $5; }
+timed_gd : '(' at start { state.formula_time = AT_START; } formula ')'
+             { $$ = $5; }
+         | '(' at end { state.formula_time = AT_END; } formula ')'
+             { $$ = $5; }
+         | '(' over all { state.formula_time = OVER_ALL; } formula ')'
+             { $$ = $5; }
          ;
 
 
@@ -505,11 +577,12 @@ timed_gd : '(' at start { formula_time = AT_START; } formula ')' { $$ = $5; }
 
 eff_formula : term_literal
             | '(' and eff_formulas ')'
-            | '(' forall { prepare_forall_effect(); }
-                '(' variables ')' eff_formula ')' { pop_forall_effect(); }
-            | '(' when { formula_time = AT_START; } formula
-                { prepare_conditional_effect(*$4); }
-                one_eff_formula ')' { effect_condition = 0; }
+            | '(' forall { state.prepare_forall_effect(); }
+                '(' variables ')' eff_formula ')'
+                { state.pop_forall_effect(); }
+            | '(' when { state.formula_time = AT_START; } formula
+                { state.prepare_conditional_effect(*$4); }
+                one_eff_formula ')' { state.effect_condition = 0; }
             ;
 
 eff_formulas : /* empty */
@@ -520,9 +593,9 @@ one_eff_formula : term_literal
                 | '(' and term_literals ')'
                 ;
 
-term_literal : atomic_term_formula { add_effect(*$1); }
+term_literal : atomic_term_formula { state.add_effect(*$1); }
              | '(' not atomic_term_formula ')'
-                 { add_effect(Negation::make(*$3)); }
+                 { state.add_effect(Negation::make(*$3)); }
              ;
 
 term_literals : /* empty */
@@ -531,10 +604,10 @@ term_literals : /* empty */
 
 da_effect : timed_effect
           | '(' and da_effects ')'
-          | '(' forall { prepare_forall_effect(); }
-              '(' variables ')' da_effect ')' { pop_forall_effect(); }
-          | '(' when da_gd { prepare_conditional_effect(*$3); }
-              timed_effect ')' { effect_condition = 0; }
+          | '(' forall { state.prepare_forall_effect(); }
+              '(' variables ')' da_effect ')' { state.pop_forall_effect(); }
+          | '(' when da_gd { state.prepare_conditional_effect(*$3); }
+              timed_effect ')' { state.effect_condition = 0; }
           ;
 
 da_effects : /* empty */
@@ -542,19 +615,25 @@ da_effects : /* empty */
            ;
 
 timed_effect : '(' at start
-                 { effect_time = Effect::AT_START; formula_time = AT_START; }
+                 {
+                   state.effect_time = Effect::AT_START;
+                   state.formula_time = AT_START;
+                 }
                  a_effect ')'
              | '(' at end
-                 { effect_time = Effect::AT_END; formula_time = AT_END; }
+                 {
+                   state.effect_time = Effect::AT_END;
+                   state.formula_time = AT_END;
+                 }
                  a_effect ')'
              ;
 
 a_effect : term_literal
          | '(' and a_effects ')'
-         | '(' forall { prepare_forall_effect(); }
-             '(' variables ')' a_effect ')' { pop_forall_effect(); }
-         | '(' when formula { prepare_conditional_effect(*$3); }
-             one_eff_formula ')' { effect_condition = 0; }
+         | '(' forall { state.prepare_forall_effect(); }
+             '(' variables ')' a_effect ')' { state.pop_forall_effect(); }
+         | '(' when formula { state.prepare_conditional_effect(*$3); }
+             one_eff_formula ')' { state.effect_condition = 0; }
          ;
 
 a_effects : /* empty */
@@ -566,8 +645,8 @@ a_effects : /* empty */
 /* Problem definitions. */
 
 problem_def : '(' define '(' problem name ')' '(' PDOMAIN name ')'
-                { make_problem($5, $9); } problem_body ')'
-                { delete requirements; }
+                { state.make_problem($5, $9); } problem_body ')'
+                { delete state.requirements; }
             ;
 
 problem_body : require_def problem_body2
@@ -582,8 +661,8 @@ problem_body3 : init goal_spec
               | goal_spec
               ;
 
-object_decl : '(' OBJECTS { name_kind = OBJECT_KIND; } typed_names ')'
-                { name_kind = VOID_KIND; }
+object_decl : '(' OBJECTS { state.name_kind = OBJECT_KIND; } typed_names ')'
+                { state.name_kind = VOID_KIND; }
             ;
 
 init : '(' INIT init_elements ')'
@@ -593,46 +672,55 @@ init_elements : /* empty */
               | init_elements init_element
               ;
 
-init_element : '(' init_predicate { prepare_atom($2); } names ')'
-                 { problem->add_init_atom(*make_atom()); }
-             | '(' AT { prepare_atom($2); } names ')'
-                 { problem->add_init_atom(*make_atom()); }
+init_element : '(' init_predicate { state.prepare_atom($2); } names ')'
+                 { state.problem->add_init_atom(*state.make_atom()); }
+             | '(' AT { state.prepare_atom($2); } names ')'
+                 { state.problem->add_init_atom(*state.make_atom()); }
              | '(' not atomic_name_formula ')'
                  { Formula::register_use($3); Formula::unregister_use($3); }
              | '(' '=' ground_f_head NUMBER ')'
-                 { problem->add_init_value(*$3, $4); }
+                 { state.problem->add_init_value(*$3, $4); }
              | '(' at NUMBER name_literal ')'
-                 { add_init_literal($3, *$4); }
+                 { state.add_init_literal($3, *$4); }
              ;
 
 goal_spec : goal
           | goal metric_spec
           ;
 
-goal : '(' GOAL formula ')' { problem->set_goal(*$3); }
+goal : '(' GOAL formula ')' { state.problem->set_goal(*$3); }
      ;
 
-metric_spec : '(' METRIC maximize { metric_fluent = true; } ground_f_exp ')'
-                { problem->set_metric(*$5, true); metric_fluent = false; }
-            | '(' METRIC minimize { metric_fluent = true; } ground_f_exp ')'
-                { problem->set_metric(*$5); metric_fluent = false; }
+metric_spec : '(' METRIC maximize { state.metric_fluent = true; }
+                ground_f_exp ')'
+                {
+                  state.problem->set_metric(*$5, true);
+                  state.metric_fluent = false;
+                }
+            | '(' METRIC minimize { state.metric_fluent = true; }
+                ground_f_exp ')'
+                {
+                  state.problem->set_metric(*$5);
+                  state.metric_fluent = false;
+                }
             ;
 
 
 /* ====================================================================== */
 /* Formulas. */
 
-formula : atomic_term_formula { $$ = &TimedLiteral::make(*$1, formula_time); }
-        | '(' '=' term term ')' { $$ = make_equality($3, $4); }
-        | '(' not formula ')' { $$ = make_negation(*$3); }
+formula : atomic_term_formula
+            { $$ = &TimedLiteral::make(*$1, state.formula_time); }
+        | '(' '=' term term ')' { $$ = state.make_equality($3, $4); }
+        | '(' not formula ')' { $$ = state.make_negation(*$3); }
         | '(' and conjuncts ')' { $$ = $3; }
-        | '(' or { require_disjunction(); } disjuncts ')' { $$ = $4; }
-        | '(' imply { require_disjunction(); } formula formula ')'
+        | '(' or { state.require_disjunction(); } disjuncts ')' { $$ = $4; }
+        | '(' imply { state.require_disjunction(); } formula formula ')'
             { $$ = &(!*$4 || *$5); }
-        | '(' exists { prepare_exists(); } '(' variables ')' formula ')'
-            { $$ = make_exists(*$7); }
-        | '(' forall { prepare_forall(); } '(' variables ')' formula ')'
-            { $$ = make_forall(*$7); }
+        | '(' exists { state.prepare_exists(); } '(' variables ')' formula ')'
+            { $$ = state.make_exists(*$7); }
+        | '(' forall { state.prepare_forall(); } '(' variables ')' formula ')'
+            { $$ = state.make_forall(*$7); }
         ;
 
 conjuncts : /* empty */ { $$ = &Formula::TRUE; }
@@ -643,12 +731,12 @@ disjuncts : /* empty */ { $$ = &Formula::FALSE; }
           | disjuncts formula { $$ = &(*$1 || *$2); }
           ;
 
-atomic_term_formula : '(' predicate { prepare_atom($2); } terms ')'
-                        { $$ = make_atom(); }
+atomic_term_formula : '(' predicate { state.prepare_atom($2); } terms ')'
+                        { $$ = state.make_atom(); }
                     ;
 
-atomic_name_formula : '(' predicate { prepare_atom($2); } names ')'
-                        { $$ = make_atom(); }
+atomic_name_formula : '(' predicate { state.prepare_atom($2); } names ')'
+                        { $$ = state.make_atom(); }
                     ;
 
 name_literal : atomic_name_formula { $$ = $1; }
@@ -661,7 +749,7 @@ name_literal : atomic_name_formula { $$ = $1; }
 
 f_exp : NUMBER { $$ = new Value($1); }
       | '(' '+' f_exp f_exp ')' { $$ = &Addition::make(*$3, *$4); }
-      | '(' '-' f_exp opt_f_exp ')' { $$ = make_subtraction(*$3, $4); }
+      | '(' '-' f_exp opt_f_exp ')' { $$ = state.make_subtraction(*$3, $4); }
       | '(' '*' f_exp f_exp ')' { $$ = &Multiplication::make(*$3, *$4); }
       | '(' '/' f_exp f_exp ')' { $$ = &Division::make(*$3, *$4); }
       | f_head { $$ = $1; }
@@ -671,16 +759,16 @@ opt_f_exp : /* empty */ { $$ = 0; }
           | f_exp
           ;
 
-f_head : '(' function { prepare_fluent($2); } terms ')'
-           { $$ = make_fluent(); }
-       | function { prepare_fluent($1); $$ = make_fluent(); }
+f_head : '(' function { state.prepare_fluent($2); } terms ')'
+           { $$ = state.make_fluent(); }
+       | function { state.prepare_fluent($1); $$ = state.make_fluent(); }
        ;
 
 ground_f_exp : NUMBER { $$ = new Value($1); }
              | '(' '+' ground_f_exp ground_f_exp ')'
                  { $$ = &Addition::make(*$3, *$4); }
              | '(' '-' ground_f_exp opt_ground_f_exp ')'
-                 { $$ = make_subtraction(*$3, $4); }
+                 { $$ = state.make_subtraction(*$3, $4); }
              | '(' '*' ground_f_exp ground_f_exp ')'
                  { $$ = &Multiplication::make(*$3, *$4); }
              | '(' '/' ground_f_exp ground_f_exp ')'
@@ -692,9 +780,10 @@ opt_ground_f_exp : /* empty */ { $$ = 0; }
                  | ground_f_exp
                  ;
 
-ground_f_head : '(' function { prepare_fluent($2); } names ')'
-                  { $$ = make_fluent(); }
-              | function { prepare_fluent($1); $$ = make_fluent(); }
+ground_f_head : '(' function { state.prepare_fluent($2); } names ')'
+                  { $$ = state.make_fluent(); }
+              | function
+                  { state.prepare_fluent($1); $$ = state.make_fluent(); }
               ;
 
 
@@ -702,21 +791,21 @@ ground_f_head : '(' function { prepare_fluent($2); } names ')'
 /* Terms and types. */
 
 terms : /* empty */
-      | terms name { add_term($2); }
-      | terms variable { add_term($2); }
+      | terms name { state.add_term($2); }
+      | terms variable { state.add_term($2); }
       ;
 
 names : /* empty */
-      | names name { add_term($2); }
+      | names name { state.add_term($2); }
       ;
 
-term : name { $$ = new Term(make_term($1)); }
-     | variable { $$ = new Term(make_term($1)); }
+term : name { $$ = new Term(state.make_term($1)); }
+     | variable { $$ = new Term(state.make_term($1)); }
      ;
 
 variables : /* empty */
-          | variable_seq { add_variables($1, TypeTable::OBJECT); }
-          | variable_seq type_spec { add_variables($1, *$2); delete $2; }
+          | variable_seq { state.add_variables($1, TypeTable::OBJECT); }
+          | variable_seq type_spec { state.add_variables($1, *$2); delete $2; }
               variables
           ;
 
@@ -725,26 +814,28 @@ variable_seq : variable { $$ = new std::vector<const std::string*>(1, $1); }
              ;
 
 typed_names : /* empty */
-            | name_seq { add_names($1, TypeTable::OBJECT); }
-            | name_seq type_spec { add_names($1, *$2); delete $2; } typed_names
+            | name_seq { state.add_names($1, TypeTable::OBJECT); }
+            | name_seq type_spec { state.add_names($1, *$2); delete $2; }
+                typed_names
             ;
 
 name_seq : name { $$ = new std::vector<const std::string*>(1, $1); }
          | name_seq name { $$ = $1; $$->push_back($2); }
          ;
 
-type_spec : '-' { require_typing(); } type { $$ = $3; }
+type_spec : '-' { state.require_typing(); } type { $$ = $3; }
           ;
 
 type : object { $$ = new Type(TypeTable::OBJECT); }
-     | type_name { $$ = new Type(make_type($1)); }
-     | '(' either types ')' { $$ = new Type(make_type(*$3)); delete $3; }
+     | type_name { $$ = new Type(state.make_type($1)); }
+     | '(' either types ')' { $$ = new Type(state.make_type(*$3)); delete $3; }
      ;
 
 types : object { $$ = new std::set<Type>(); }
-      | type_name { $$ = new std::set<Type>(); $$->insert(make_type($1)); }
+      | type_name
+          { $$ = new std::set<Type>(); $$->insert(state.make_type($1)); }
       | types object { $$ = $1; }
-      | types type_name { $$ = $1; $$->insert(make_type($2)); }
+      | types type_name { $$ = $1; $$->insert(state.make_type($2)); }
       ;
 
 function_type : number
@@ -852,18 +943,57 @@ variable : VARIABLE
 
 %%
 
+/* Constructs the state for parsing the source with the given name. */
+ParseState::ParseState(const std::string& name, std::ostream& messages)
+  : name(name), messages(&messages), line_number(1),
+    tables_lock(tables_mutex, std::defer_lock), success(true), domain(0),
+    problem(0), requirements(0), predicate(0), repeated_predicate(false),
+    function(0), repeated_function(false), action(0),
+    formula_time(AT_START), effect_time(Effect::AT_END),
+    effect_condition(0), atom_predicate(0),
+    undeclared_atom_predicate(false), metric_fluent(false),
+    fluent_function(0), undeclared_fluent_function(false),
+    name_kind(TYPE_KIND) {}
+
+
+/* Trades the shared hold on the tables for an exclusive one, unless
+   the state already holds them exclusively. */
+TableWriter::TableWriter(ParseState& state)
+  : state_(state), traded_(state.tables_lock.owns_lock()) {
+  if (traded_) {
+    state_.tables_lock.unlock();
+    tables_mutex.lock();
+  }
+}
+
+
+/* Trades the exclusive hold on the tables back for a shared one. */
+TableWriter::~TableWriter() {
+  if (traded_) {
+    tables_mutex.unlock();
+    state_.tables_lock.lock();
+  }
+}
+
+
+/* Outputs a syntax error message. */
+static void yyerror(ParseState& state, void* scanner, const std::string& s) {
+  state.error(s);
+}
+
+
 /* Outputs an error message. */
-static void yyerror(const std::string& s) {
-  std::cerr << PACKAGE ":" << current_file << ':' << line_number << ": " << s
+void ParseState::error(const std::string& s) {
+  *messages << PACKAGE ":" << name << ':' << line_number << ": " << s
             << std::endl;
   success = false;
 }
 
 
 /* Outputs a warning. */
-static void yywarning(const std::string& s) {
+void ParseState::warning(const std::string& s) {
   if (warning_level > 0) {
-    std::cerr << PACKAGE ":" << current_file << ':' << line_number << ": " << s
+    *messages << PACKAGE ":" << name << ':' << line_number << ": " << s
               << std::endl;
     if (warning_level > 1) {
       success = false;
@@ -873,9 +1003,11 @@ static void yywarning(const std::string& s) {
 
 
 /* Creates an empty domain with the given name. */
-static void make_domain(const std::string* name) {
+void ParseState::make_domain(const std::string* name) {
+  TableWriter writer(*this);
   domain = new Domain(*name);
   domains[*name] = domain;
+  defined_domains.push_back(domain);
   requirements = &domain->requirements;
   problem = 0;
   delete name;
@@ -883,66 +1015,77 @@ static void make_domain(const std::string* name) {
 
 
 /* Creates an empty problem with the given name. */
-static void make_problem(const std::string* name,
-                         const std::string* domain_name) {
+void ParseState::make_problem(const std::string* name,
+                              const std::string* domain_name) {
   std::map<std::string, Domain*>::const_iterator di =
     domains.find(*domain_name);
   if (di != domains.end()) {
     domain = (*di).second;
   } else {
-    domain = new Domain(*domain_name);
-    domains[*domain_name] = domain;
-    yyerror("undeclared domain `" + *domain_name + "' used");
+    TableWriter writer(*this);
+    di = domains.find(*domain_name);
+    if (di != domains.end()) {
+      domain = (*di).second;
+    } else {
+      domain = new Domain(*domain_name);
+      domains[*domain_name] = domain;
+    }
+    error("undeclared domain `" + *domain_name + "' used");
   }
   requirements = new PddlRequirements(domain->requirements);
   problem = new Problem(*name, *domain);
+  defined_problems.push_back(problem);
   delete name;
   delete domain_name;
 }
 
 /* Adds :typing to the requirements. */
-static void require_typing() {
+void ParseState::require_typing() {
   if (!requirements->typing()) {
-    yywarning("assuming `:typing' requirement");
+    warning("assuming `:typing' requirement");
     requirements->EnableTyping();
   }
 }
 
 
 /* Adds :fluents to the requirements. */
-static void require_fluents() {
+void ParseState::require_fluents() {
   if (!requirements->fluents()) {
-    yywarning("assuming `:fluents' requirement");
+    warning("assuming `:fluents' requirement");
     requirements->EnableFluents();
   }
 }
 
 
 /* Adds :disjunctive-preconditions to the requirements. */
-static void require_disjunction() {
+void ParseState::require_disjunction() {
   if (!requirements->disjunctive_preconditions()) {
-    yywarning("assuming `:disjunctive-preconditions' requirement");
+    warning("assuming `:disjunctive-preconditions' requirement");
     requirements->EnableDisjunctivePreconditions();
   }
 }
 
 
 /* Adds :duration-inequalities to the requirements. */
-static void require_duration_inequalities() {
+void ParseState::require_duration_inequalities() {
   if (!requirements->duration_inequalities()) {
-    yywarning("assuming `:duration-inequalities' requirement");
+    warning("assuming `:duration-inequalities' requirement");
     requirements->EnableDurationInequalities();
   }
 }
 
 
 /* Returns a simple type with the given name. */
-static const Type& make_type(const std::string* name) {
+const Type& ParseState::make_type(const std::string* name) {
   const Type* t = domain->types().find_type(*name);
   if (t == 0) {
-    t = &domain->types().add_type(*name);
+    TableWriter writer(*this);
+    t = domain->types().find_type(*name);
+    if (t == 0) {
+      t = &domain->types().add_type(*name);
+    }
     if (name_kind != TYPE_KIND) {
-      yywarning("implicit declaration of type `" + *name + "'");
+      warning("implicit declaration of type `" + *name + "'");
     }
   }
   delete name;
@@ -951,12 +1094,13 @@ static const Type& make_type(const std::string* name) {
 
 
 /* Returns the union of the given types. */
-static Type make_type(const std::set<Type>& types) {
+Type ParseState::make_type(const std::set<Type>& types) {
+  TableWriter writer(*this);
   return TypeTable::union_type(types);
 }
 
 /* Returns a simple term with the given name. */
-static Term make_term(const std::string* name) {
+Term ParseState::make_term(const std::string* name) {
   if ((*name)[0] == '?') {
     const Variable* vp = context.find(*name);
     if (vp != 0) {
@@ -965,7 +1109,7 @@ static Term make_term(const std::string* name) {
     } else {
       Variable v = TermTable::add_variable(TypeTable::OBJECT);
       context.insert(*name, v);
-      yyerror("free variable `" + *name + "' used");
+      error("free variable `" + *name + "' used");
       delete name;
       return v;
     }
@@ -973,6 +1117,10 @@ static Term make_term(const std::string* name) {
     TermTable& terms = (problem != 0) ? problem->terms() : domain->terms();
     const Object* o = terms.find_object(*name);
     if (o == 0) {
+      std::unique_ptr<TableWriter> writer;
+      if (problem == 0) {
+        writer.reset(new TableWriter(*this));
+      }
       size_t n = term_parameters.size();
       if (atom_predicate != 0
           && PredicateTable::parameters(*atom_predicate).size() > n) {
@@ -981,7 +1129,7 @@ static Term make_term(const std::string* name) {
       } else {
         o = &terms.add_object(*name, TypeTable::OBJECT);
       }
-      yywarning("implicit declaration of object `" + *name + "'");
+      warning("implicit declaration of object `" + *name + "'");
     }
     delete name;
     return *o;
@@ -990,21 +1138,23 @@ static Term make_term(const std::string* name) {
 
 
 /* Creates a predicate with the given name. */
-static void make_predicate(const std::string* name) {
+void ParseState::make_predicate(const std::string* name) {
+  TableWriter writer(*this);
   predicate = domain->predicates().find_predicate(*name);
   if (predicate == 0) {
     repeated_predicate = false;
     predicate = &domain->predicates().add_predicate(*name);
   } else {
     repeated_predicate = true;
-    yywarning("ignoring repeated declaration of predicate `" + *name + "'");
+    warning("ignoring repeated declaration of predicate `" + *name + "'");
   }
   delete name;
 }
 
 
 /* Creates a function with the given name. */
-static void make_function(const std::string* name) {
+void ParseState::make_function(const std::string* name) {
+  TableWriter writer(*this);
   repeated_function = false;
   function = domain->functions().find_function(*name);
   if (function == 0) {
@@ -1012,9 +1162,9 @@ static void make_function(const std::string* name) {
   } else {
     repeated_function = true;
     if (*name == "total-time") {
-      yywarning("ignoring declaration of reserved function `" + *name + "'");
+      warning("ignoring declaration of reserved function `" + *name + "'");
     } else {
-      yywarning("ignoring repeated declaration of function `" + *name + "'");
+      warning("ignoring repeated declaration of function `" + *name + "'");
     }
   }
   delete name;
@@ -1022,10 +1172,10 @@ static void make_function(const std::string* name) {
 
 
 /* Creates an action with the given name. */
-static void make_action(const std::string* name, bool durative) {
+void ParseState::make_action(const std::string* name, bool durative) {
   if (durative) {
     if (!requirements->durative_actions()) {
-      yywarning("assuming `:durative-actions' requirement");
+      warning("assuming `:durative-actions' requirement");
       requirements->EnableDurativeActions();
     }
   }
@@ -1036,14 +1186,15 @@ static void make_action(const std::string* name, bool durative) {
 
 
 /* Adds the current action to the current domain. */
-static void add_action() {
+void ParseState::add_action() {
+  TableWriter writer(*this);
   context.pop_frame();
   if (domain->find_action(action->name()) == 0) {
     action->strengthen_effects(*domain);
     domain->add_action(*action);
   } else {
-    yywarning("ignoring repeated declaration of action `"
-              + action->name() + "'");
+    warning("ignoring repeated declaration of action `"
+            + action->name() + "'");
     delete action;
   }
   action = 0;
@@ -1051,9 +1202,9 @@ static void add_action() {
 
 
 /* Prepares for the parsing of a universally quantified effect. */
-static void prepare_forall_effect() {
+void ParseState::prepare_forall_effect() {
   if (!requirements->conditional_effects()) {
-    yywarning("assuming `:conditional-effects' requirement");
+    warning("assuming `:conditional-effects' requirement");
     requirements->EnableConditionalEffects();
   }
   context.push_frame();
@@ -1062,9 +1213,9 @@ static void prepare_forall_effect() {
 
 
 /* Prepares for the parsing of a conditional effect. */
-static void prepare_conditional_effect(const Formula& condition) {
+void ParseState::prepare_conditional_effect(const Formula& condition) {
   if (!requirements->conditional_effects()) {
-    yywarning("assuming `:conditional-effects' requirement");
+    warning("assuming `:conditional-effects' requirement");
     requirements->EnableConditionalEffects();
   }
   effect_condition = &condition;
@@ -1072,26 +1223,28 @@ static void prepare_conditional_effect(const Formula& condition) {
 
 
 /* Adds types, constants, or objects to the current domain or problem. */
-static void add_names(const std::vector<const std::string*>* names,
-                      const Type& type) {
+void ParseState::add_names(const std::vector<const std::string*>* names,
+                           const Type& type) {
   for (std::vector<const std::string*>::const_iterator si = names->begin();
        si != names->end(); si++) {
     const std::string* s = *si;
     if (name_kind == TYPE_KIND) {
+      TableWriter writer(*this);
       if (*s == TypeTable::OBJECT_NAME) {
-        yywarning("ignoring declaration of reserved type `object'");
+        warning("ignoring declaration of reserved type `object'");
       } else if (*s == TypeTable::NUMBER_NAME) {
-        yywarning("ignoring declaration of reserved type `number'");
+        warning("ignoring declaration of reserved type `number'");
       } else {
         const Type* t = domain->types().find_type(*s);
         if (t == 0) {
           t = &domain->types().add_type(*s);
         }
         if (!TypeTable::add_supertype(*t, type)) {
-          yyerror("cyclic type hierarchy");
+          error("cyclic type hierarchy");
         }
       }
     } else if (name_kind == CONSTANT_KIND) {
+      TableWriter writer(*this);
       const Object* o = domain->terms().find_object(*s);
       if (o == 0) {
         domain->terms().add_object(*s, type);
@@ -1103,8 +1256,8 @@ static void add_names(const std::vector<const std::string*>* names,
       }
     } else { /* name_kind == OBJECT_KIND */
       if (domain->terms().find_object(*s) != 0) {
-        yywarning("ignoring declaration of object `" + *s
-                  + "' previously declared as constant");
+        warning("ignoring declaration of object `" + *s
+                + "' previously declared as constant");
       } else {
         const Object* o = problem->terms().find_object(*s);
         if (o == 0) {
@@ -1124,24 +1277,26 @@ static void add_names(const std::vector<const std::string*>* names,
 
 
 /* Adds variables to the current variable list. */
-static void add_variables(const std::vector<const std::string*>* names,
-                          const Type& type) {
+void ParseState::add_variables(const std::vector<const std::string*>* names,
+                               const Type& type) {
   for (std::vector<const std::string*>::const_iterator si = names->begin();
        si != names->end(); si++) {
     const std::string* s = *si;
     if (predicate != 0) {
       if (!repeated_predicate) {
+        TableWriter writer(*this);
         PredicateTable::add_parameter(*predicate, type);
       }
     } else if (function != 0) {
       if (!repeated_function) {
+        TableWriter writer(*this);
         FunctionTable::add_parameter(*function, type);
       }
     } else {
       if (context.shallow_find(*s) != 0) {
-        yyerror("repetition of parameter `" + *s + "'");
+        error("repetition of parameter `" + *s + "'");
       } else if (context.find(*s) != 0) {
-        yywarning("shadowing parameter `" + *s + "'");
+        warning("shadowing parameter `" + *s + "'");
       }
       Variable var = TermTable::add_variable(type);
       context.insert(*s, var);
@@ -1158,15 +1313,19 @@ static void add_variables(const std::vector<const std::string*>* names,
 
 
 /* Prepares for the parsing of an atomic formula. */
-static void prepare_atom(const std::string* name) {
+void ParseState::prepare_atom(const std::string* name) {
   atom_predicate = domain->predicates().find_predicate(*name);
   if (atom_predicate == 0) {
-    atom_predicate = &domain->predicates().add_predicate(*name);
+    TableWriter writer(*this);
+    atom_predicate = domain->predicates().find_predicate(*name);
+    if (atom_predicate == 0) {
+      atom_predicate = &domain->predicates().add_predicate(*name);
+    }
     undeclared_atom_predicate = true;
     if (problem != 0) {
-      yywarning("undeclared predicate `" + *name + "' used");
+      warning("undeclared predicate `" + *name + "' used");
     } else {
-      yywarning("implicit declaration of predicate `" + *name + "'");
+      warning("implicit declaration of predicate `" + *name + "'");
     }
   } else {
     undeclared_atom_predicate = false;
@@ -1177,22 +1336,26 @@ static void prepare_atom(const std::string* name) {
 
 
 /* Prepares for the parsing of a fluent. */
-static void prepare_fluent(const std::string* name) {
+void ParseState::prepare_fluent(const std::string* name) {
   fluent_function = domain->functions().find_function(*name);
   if (fluent_function == 0) {
-    fluent_function = &domain->functions().add_function(*name);
+    TableWriter writer(*this);
+    fluent_function = domain->functions().find_function(*name);
+    if (fluent_function == 0) {
+      fluent_function = &domain->functions().add_function(*name);
+    }
     undeclared_fluent_function = true;
     if (problem != 0) {
-      yywarning("undeclared function `" + *name + "' used");
+      warning("undeclared function `" + *name + "' used");
     } else {
-      yywarning("implicit declaration of function `" + *name + "'");
+      warning("implicit declaration of function `" + *name + "'");
     }
   } else {
     undeclared_fluent_function = false;
   }
   if (*name == "total-time") {
     if (!metric_fluent) {
-      yyerror("reserved function `" + *name + "' not allowed here");
+      error("reserved function `" + *name + "' not allowed here");
     }
   } else {
     require_fluents();
@@ -1203,30 +1366,32 @@ static void prepare_fluent(const std::string* name) {
 
 
 /* Adds a term with the given name to the current atomic formula. */
-static void add_term(const std::string* name) {
+void ParseState::add_term(const std::string* name) {
   Term term = make_term(name);
   if (atom_predicate != 0) {
     size_t n = term_parameters.size();
     if (undeclared_atom_predicate) {
+      TableWriter writer(*this);
       PredicateTable::add_parameter(*atom_predicate, TermTable::type(term));
     } else {
       const std::vector<Type>& params =
           PredicateTable::parameters(*atom_predicate);
       if (params.size() > n
           && !TypeTable::subtype(TermTable::type(term), params[n])) {
-        yyerror("type mismatch");
+        error("type mismatch");
       }
     }
   } else if (fluent_function != 0) {
     size_t n = term_parameters.size();
     if (undeclared_fluent_function) {
+      TableWriter writer(*this);
       FunctionTable::add_parameter(*fluent_function, TermTable::type(term));
     } else {
       const std::vector<Type>& params =
           FunctionTable::parameters(*fluent_function);
       if (params.size() > n
           && !TypeTable::subtype(TermTable::type(term), params[n])) {
-        yyerror("type mismatch");
+        error("type mismatch");
       }
     }
   }
@@ -1235,14 +1400,14 @@ static void add_term(const std::string* name) {
 
 
 /* Creates the atomic formula just parsed. */
-static const Atom* make_atom() {
+const Atom* ParseState::make_atom() {
   size_t n = term_parameters.size();
   if (PredicateTable::parameters(*atom_predicate).size() < n) {
-    yyerror("too many parameters passed to predicate `"
-            + PredicateTable::name(*atom_predicate) + "'");
+    error("too many parameters passed to predicate `"
+          + PredicateTable::name(*atom_predicate) + "'");
   } else if (PredicateTable::parameters(*atom_predicate).size() > n) {
-    yyerror("too few parameters passed to predicate `"
-            + PredicateTable::name(*atom_predicate) + "'");
+    error("too few parameters passed to predicate `"
+          + PredicateTable::name(*atom_predicate) + "'");
   }
   const Atom& atom = Atom::make(*atom_predicate, term_parameters);
   atom_predicate = 0;
@@ -1251,14 +1416,14 @@ static const Atom* make_atom() {
 
 
 /* Creates the fluent just parsed. */
-static const Fluent* make_fluent() {
+const Fluent* ParseState::make_fluent() {
   size_t n = term_parameters.size();
   if (FunctionTable::parameters(*fluent_function).size() < n) {
-    yyerror("too many parameters passed to function `"
-            + FunctionTable::name(*fluent_function) + "'");
+    error("too many parameters passed to function `"
+          + FunctionTable::name(*fluent_function) + "'");
   } else if (FunctionTable::parameters(*fluent_function).size() > n) {
-    yyerror("too few parameters passed to function `"
-            + FunctionTable::name(*fluent_function) + "'");
+    error("too few parameters passed to function `"
+          + FunctionTable::name(*fluent_function) + "'");
   }
   const Fluent& fluent = Fluent::make(*fluent_function, term_parameters);
   fluent_function = 0;
@@ -1267,8 +1432,8 @@ static const Fluent* make_fluent() {
 
 
 /* Creates a subtraction. */
-static const Expression* make_subtraction(const Expression& term,
-                                          const Expression* opt_term) {
+const Expression* ParseState::make_subtraction(const Expression& term,
+                                               const Expression* opt_term) {
   if (opt_term != 0) {
     return &Subtraction::make(term, *opt_term);
   } else {
@@ -1278,9 +1443,10 @@ static const Expression* make_subtraction(const Expression& term,
 
 
 /* Creates an equality formula. */
-static const Formula* make_equality(const Term* term1, const Term* term2) {
+const Formula* ParseState::make_equality(const Term* term1,
+                                         const Term* term2) {
   if (!requirements->equality()) {
-    yywarning("assuming `:equality' requirement");
+    warning("assuming `:equality' requirement");
     requirements->EnableEquality();
   }
   const Formula& eq = Equality::make(*term1, *term2);
@@ -1291,16 +1457,16 @@ static const Formula* make_equality(const Term* term1, const Term* term2) {
 
 
 /* Creates a negated formula. */
-static const Formula* make_negation(const Formula& negand) {
+const Formula* ParseState::make_negation(const Formula& negand) {
   if (typeid(negand) == typeid(Literal)
       || typeid(negand) == typeid(TimedLiteral)) {
     if (!requirements->negative_preconditions()) {
-      yywarning("assuming `:negative-preconditions' requirement");
+      warning("assuming `:negative-preconditions' requirement");
       requirements->EnableNegativePreconditions();
     }
   } else if (!requirements->disjunctive_preconditions() &&
              typeid(negand) != typeid(Equality)) {
-    yywarning("assuming `:disjunctive-preconditions' requirement");
+    warning("assuming `:disjunctive-preconditions' requirement");
     requirements->EnableDisjunctivePreconditions();
   }
   return &!negand;
@@ -1308,9 +1474,9 @@ static const Formula* make_negation(const Formula& negand) {
 
 
 /* Prepares for the parsing of an existentially quantified formula. */
-static void prepare_exists() {
+void ParseState::prepare_exists() {
   if (!requirements->existential_preconditions()) {
-    yywarning("assuming `:existential-preconditions' requirement");
+    warning("assuming `:existential-preconditions' requirement");
     requirements->EnableExistentialPreconditions();
   }
   context.push_frame();
@@ -1319,9 +1485,9 @@ static void prepare_exists() {
 
 
 /* Prepares for the parsing of a universally quantified formula. */
-static void prepare_forall() {
+void ParseState::prepare_forall() {
   if (!requirements->universal_preconditions()) {
-    yywarning("assuming `:universal-preconditions' requirement");
+    warning("assuming `:universal-preconditions' requirement");
     requirements->EnableUniversalPreconditions();
   }
   context.push_frame();
@@ -1330,7 +1496,7 @@ static void prepare_forall() {
 
 
 /* Creates an existentially quantified formula. */
-static const Formula* make_exists(const Formula& body) {
+const Formula* ParseState::make_exists(const Formula& body) {
   context.pop_frame();
   size_t m = quantified.size() - 1;
   size_t n = m;
@@ -1358,7 +1524,7 @@ static const Formula* make_exists(const Formula& body) {
 
 
 /* Creates a universally quantified formula. */
-static const Formula* make_forall(const Formula& body) {
+const Formula* ParseState::make_forall(const Formula& body) {
   context.pop_frame();
   size_t m = quantified.size() - 1;
   size_t n = m;
@@ -1386,8 +1552,11 @@ static const Formula* make_forall(const Formula& body) {
 
 
 /* Adds the current effect to the currect action. */
-static void add_effect(const Literal& literal) {
-  PredicateTable::make_dynamic(literal.predicate());
+void ParseState::add_effect(const Literal& literal) {
+  {
+    TableWriter writer(*this);
+    PredicateTable::make_dynamic(literal.predicate());
+  }
   Effect* effect = new Effect(literal, effect_time);
   for (std::vector<Term>::const_iterator vi = quantified.begin();
        vi != quantified.end(); vi++) {
@@ -1403,7 +1572,7 @@ static void add_effect(const Literal& literal) {
 
 
 /* Pops the top-most universally quantified variables. */
-static void pop_forall_effect() {
+void ParseState::pop_forall_effect() {
   context.pop_frame();
   size_t n = quantified.size() - 1;
   while (quantified[n].variable()) {
@@ -1414,9 +1583,69 @@ static void pop_forall_effect() {
 
 
 /* Adds a timed initial literal to the current problem. */
-static void add_init_literal(float time, const Literal& literal) {
+void ParseState::add_init_literal(float time, const Literal& literal) {
   problem->add_init_literal(time, literal);
   if (time > 0.0f) {
+    TableWriter writer(*this);
     PredicateTable::make_dynamic(literal.predicate());
   }
 }
+
+
+/* Parses the source the given scanner is set up for while holding the
+   tables shared, and returns true on success. */
+static bool parse_source(ParseState& state, void* scanner) {
+  state.tables_lock.lock();
+  bool success = (yyparse(state, scanner) == 0);
+  state.tables_lock.unlock();
+  yylex_destroy(scanner);
+  return success;
+}
+
+
+/* Constructs a parser for the source with the given name, which
+   reports errors and warnings on the given stream. */
+PddlParser::PddlParser(const std::string& name, std::ostream& messages)
+  : state_(new ParseState(name, messages)) {}
+
+
+/* Deletes this parser. */
+PddlParser::~PddlParser() {
+  delete state_;
+}
+
+
+/* Parses the given buffer in place, and returns true on success. */
+bool PddlParser::parse(char* buffer, size_t size) {
+  void* scanner;
+  yylex_init_extra(&state_->line_number, &scanner);
+  yy_scan_buffer(buffer, size, scanner);
+  return parse_source(*state_, scanner);
+}
+
+
+/* Parses the given file, and returns true on success. */
+bool PddlParser::parse(FILE* file) {
+  void* scanner;
+  yylex_init_extra(&state_->line_number, &scanner);
+  yyset_in(file, scanner);
+  return parse_source(*state_, scanner);
+}
+
+
+/* Returns the domains defined by the parsed source, in order. */
+const std::vector<const Domain*>& PddlParser::domains() const {
+  return state_->defined_domains;
+}
+
+
+/* Returns the problems defined by the parsed source, in order. */
+const std::vector<const Problem*>& PddlParser::problems() const {
+  return state_->defined_problems;
+}
+
+
+/* Returns a shared hold on the tables that parsers add to. */
+std::shared_lock<std::shared_mutex> PddlParser::read_tables() {
+  return std::shared_lock<std::shared_mutex>(tables_mutex);
+}
@@ -20,9 +20,15 @@
 #include "plans.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <queue>
+#include <thread>
 #include <typeinfo>
+#include <unordered_set>
 
 #include "bindings.h"
 #include "debug.h"
@@ -36,31 +42,82 @@
 #include "terms.h"
 #include "types.h"
 
+#include "src/hash.h"
 #include "src/timer.h"
+#include "src/worker-pool.h"
 
 /*
- * Mapping of predicate names to achievers.
+ * Mapping of predicates to achievers, indexed by predicate.
  */
-struct PredicateAchieverMap : public std::map<Predicate, ActionEffectMap> {
+struct PredicateAchieverMap {
+  /* Returns the achievers for the given predicate, or NULL if the
+     predicate has no achievers. */
+  const ActionEffectMap* find(const Predicate& predicate) const {
+    size_t i = predicate.index();
+    return ((i < achievers_.size() && !achievers_[i].empty())
+            ? &achievers_[i] : NULL);
+  }
+
+  /* Returns the achievers for the given predicate for modification. */
+  ActionEffectMap& operator[](const Predicate& predicate) {
+    size_t i = predicate.index();
+    if (i >= achievers_.size()) {
+      achievers_.resize(i + 1);
+    }
+    return achievers_[i];
+  }
+
+  /* Removes all achievers. */
+  void clear() { achievers_.clear(); }
+
+private:
+  /* Achievers for each predicate. */
+  std::vector<ActionEffectMap> achievers_;
 };
 
 
-/* Planning parameters. */
-static const Parameters* params;
-/* Domain of problem currently being solved. */
-static const Domain* domain = NULL;
-/* Problem currently being solved. */
-static const Problem* problem = NULL;
-/* Planning graph. */
-static const PlanningGraph* planning_graph;
-/* The goal action. */
-static Action* goal_action;
-/* Maps predicates to actions. */
-static PredicateAchieverMap achieves_pred;
-/* Maps negated predicates to actions. */
-static PredicateAchieverMap achieves_neg_pred;
-/* Whether last flaw was a static predicate. */
-static bool static_pred_flaw;
+/*
+ * State of planning for a single problem.  The thread that plans for
+ * the problem owns the context, and threads that help with the search
+ * use the context of that thread.
+ */
+struct PlanningContext {
+  /* Constructs an empty context. */
+  PlanningContext()
+    : params(NULL), domain(NULL), problem(NULL), planning_graph(NULL),
+      goal_action(NULL) {}
+
+  /* Planning parameters. */
+  const Parameters* params;
+  /* Domain of problem being solved. */
+  const Domain* domain;
+  /* Problem being solved. */
+  const Problem* problem;
+  /* Planning graph. */
+  const PlanningGraph* planning_graph;
+  /* The goal action. */
+  Action* goal_action;
+  /* Maps predicates to actions. */
+  PredicateAchieverMap achieves_pred;
+  /* Maps negated predicates to actions. */
+  PredicateAchieverMap achieves_neg_pred;
+  /* Arena holding the chains and plans of the search, which are all
+     freed at once with the context. */
+  NodePool::Arena arena;
+};
+
+/* Context of the problem being solved on this thread. */
+static thread_local PlanningContext* context = NULL;
+/* Mutex protecting the cached achievers below. */
+static std::mutex achievers_mutex;
+/* Domain that the cached achievers are for, or NULL if none. */
+static const Domain* achievers_domain = NULL;
+/* Maps predicates to action schemas of the cached domain. */
+static PredicateAchieverMap domain_achieves_pred;
+/* Maps negated predicates to action schemas of the cached domain. */
+static PredicateAchieverMap domain_achieves_neg_pred;
+/* Whether last flaw was a static predicate (set per search thread). */
+static thread_local bool static_pred_flaw;
 
 
 /* ====================================================================== */
@@ -107,13 +164,275 @@ namespace std {
 }
 
 
+/* Checks if generated plans are ranked only when they are selected.
+   Ranks are needed right away with IDA*, to compare against the f
+   limit. */
+static bool deferred_evaluation() {
+  return (context->params->deferred_evaluation
+          && context->params->search_algorithm != Parameters::IDA_STAR);
+}
+
+
+/*
+ * Less than function object for queued plans.  With deferred
+ * evaluation, plans are compared by the primary rank they are
+ * estimated to have, so that comparing plans does not rank them.
+ */
+struct PlanLess {
+  /* Constructs a comparison function object. */
+  explicit PlanLess(bool estimated = false) : estimated(estimated) {}
+
+  /* Comparison function operator. */
+  bool operator()(const Plan* p1, const Plan* p2) const {
+    if (estimated) {
+      return p1->estimated_rank() > p2->estimated_rank();
+    } else {
+      return *p1 < *p2;
+    }
+  }
+
+  /* Whether plans are compared by estimated primary rank. */
+  bool estimated;
+};
+
+
 /*
  * A plan queue.
  */
-struct PlanQueue : public std::priority_queue<const Plan*> {
+struct PlanQueue
+  : public std::priority_queue<const Plan*, std::vector<const Plan*>,
+                               PlanLess> {
+  /* Constructs an empty plan queue. */
+  PlanQueue()
+    : std::priority_queue<const Plan*, std::vector<const Plan*>, PlanLess>(
+        PlanLess(deferred_evaluation())) {}
+
+  /* Removes up to the given number of plans with the worst rank from
+     this queue, and appends them to the given list. */
+  void remove_worst(size_t n, std::vector<const Plan*>* removed) {
+    n = std::min(n, c.size());
+    std::nth_element(c.begin(), c.begin() + n, c.end(), comp);
+    removed->insert(removed->end(), c.begin(), c.begin() + n);
+    c.erase(c.begin(), c.begin() + n);
+    std::make_heap(c.begin(), c.end(), comp);
+  }
+};
+
+
+/*
+ * State of a single search for a complete plan.
+ */
+struct SearchState {
+  /* Constructs the state for a search. */
+  SearchState(const Timer<>& timer, const std::atomic<bool>* cancelled,
+              bool show_progress)
+    : timer(timer), cancelled(cancelled), show_progress(show_progress),
+      num_visited_plans(0), num_generated_plans(0), num_static(0),
+      num_dead_ends(0), num_duplicates(0), num_evicted(0),
+      best_evicted_rank(std::numeric_limits<float>::infinity()) {}
+
+  /* Timer started when planning for the current problem began. */
+  const Timer<>& timer;
+  /* Flag telling the search to stop, or NULL if it cannot be cancelled. */
+  const std::atomic<bool>* cancelled;
+  /* Whether this search displays the progress bar. */
+  bool show_progress;
+  /* Function that receives the plans found in anytime mode. */
+  Plan::PlanCallback improved_plan;
+  /* Number of visited plan. */
+  size_t num_visited_plans;
+  /* Number of generated plans. */
+  size_t num_generated_plans;
+  /* Number of static preconditions encountered. */
+  size_t num_static;
+  /* Number of dead ends encountered. */
+  size_t num_dead_ends;
+  /* Number of generated plans pruned as duplicates. */
+  size_t num_duplicates;
+  /* Number of pending plans evicted to stay within the memory limit. */
+  size_t num_evicted;
+  /* Best primary rank of an evicted plan. */
+  float best_evicted_rank;
 };
 
 
+/*
+ * The canonical key of a plan, which identifies the plan for
+ * duplicate detection.
+ */
+typedef std::vector<uint64_t> PlanKey;
+
+
+/*
+ * Hash function object for plan keys.
+ */
+struct PlanKeyHash {
+  size_t operator()(const PlanKey& key) const {
+    uint64_t h = key.size();
+    for (uint64_t value : key) {
+      h = HashCombine(h, value);
+    }
+    return h;
+  }
+};
+
+
+/*
+ * Keys of the plans generated by a search.  Keys with the same hash
+ * value are compared in full, so only plans that are the same up to
+ * the naming of their steps are considered duplicates.  The memory
+ * used by the keys is charged to the node pool, so that it counts
+ * towards the memory limit.
+ */
+struct PlanKeySet {
+  /* Constructs an empty set that records keys. */
+  PlanKeySet() : recording_(true), key_bytes_(0), charged_(0) {}
+
+  PlanKeySet(const PlanKeySet&) = delete;
+  PlanKeySet& operator=(const PlanKeySet&) = delete;
+
+  /* Deletes this set. */
+  ~PlanKeySet() {
+    NodePool::Charge(-static_cast<long>(charged_));
+  }
+
+  /* Checks if this set has stopped recording keys. */
+  bool released() const { return !recording_; }
+
+  /* Adds the given key to this set, and returns false if it was
+     already there.  Returns true without adding the key once this set
+     has been released. */
+  bool insert(const PlanKey& key) {
+    if (!recording_) {
+      return true;
+    }
+    if (!keys_.insert(key).second) {
+      return false;
+    }
+    key_bytes_ += sizeof(PlanKey) + key.size()*sizeof(uint64_t)
+      + 2*sizeof(void*);
+    update_charge();
+    return true;
+  }
+
+  /* Removes all keys from this set. */
+  void clear() {
+    std::unordered_set<PlanKey, PlanKeyHash>().swap(keys_);
+    key_bytes_ = 0;
+    update_charge();
+  }
+
+  /* Removes all keys from this set, and stops recording new ones. */
+  void release() {
+    clear();
+    recording_ = false;
+  }
+
+private:
+  /* Keys in this set. */
+  std::unordered_set<PlanKey, PlanKeyHash> keys_;
+  /* Whether new keys are recorded. */
+  bool recording_;
+  /* Number of bytes used by the keys, not counting the buckets. */
+  size_t key_bytes_;
+  /* Number of bytes charged to the node pool. */
+  size_t charged_;
+
+  /* Charges the change in the memory used by this set. */
+  void update_charge() {
+    const size_t bytes = key_bytes_ + keys_.bucket_count()*sizeof(void*);
+    NodePool::Charge(static_cast<long>(bytes) - static_cast<long>(charged_));
+    charged_ = bytes;
+  }
+};
+
+
+/* Returns the key of the given plan. */
+static PlanKey plan_key(const Plan& plan) {
+  PlanKey key;
+  plan.key(key);
+  return key;
+}
+
+
+/* Returns the number of bytes used by the plans of the problem being
+   solved on this thread, with their chains, bindings and orderings. */
+static size_t search_bytes() {
+  return size_t(context->arena.BytesInUse());
+}
+
+
+/* Evicts the worst pending plans, starting with the plans in dead
+   queues, until the search fits within the memory limit.  The best
+   plan of each queue is never evicted.  Before any pending plan is
+   evicted, the plans cut off by the f limit of IDA* are dropped, so
+   that the next iteration starts over from the initial plan, and the
+   keys of generated plans are released and duplicates are no longer
+   pruned, because a key of a plan that is gone would keep an
+   equivalent plan from being generated again. */
+static void evict_plans(std::vector<PlanQueue>& plans,
+                        std::vector<PlanQueue*>& dead_queues,
+                        std::vector<const Plan*>& cutoff_plans,
+                        bool& frontier_complete,
+                        std::vector<PlanKeySet>& generated_keys,
+                        SearchState& state) {
+  while (!dead_queues.empty()
+         && search_bytes() > context->params->memory_limit) {
+    PlanQueue& dead_queue = *dead_queues.back();
+    while (!dead_queue.empty()) {
+      delete dead_queue.top();
+      dead_queue.pop();
+    }
+    dead_queues.pop_back();
+  }
+  if (frontier_complete
+      && search_bytes() > context->params->memory_limit) {
+    for (size_t i = 0; i < cutoff_plans.size(); i++) {
+      delete cutoff_plans[i];
+    }
+    std::vector<const Plan*>().swap(cutoff_plans);
+    frontier_complete = false;
+  }
+  if (search_bytes() > context->params->memory_limit) {
+    for (size_t i = 0; i < generated_keys.size(); i++) {
+      generated_keys[i].release();
+    }
+  }
+  /* Evict a quarter of each queue at a time, because plans share
+     chains and evicting a single plan may free little memory. */
+  std::vector<const Plan*> evicted;
+  while (search_bytes() > context->params->memory_limit) {
+    for (size_t i = 0; i < plans.size(); i++) {
+      if (plans[i].size() > 1) {
+        plans[i].remove_worst(std::min((plans[i].size() + 3)/4,
+                                       plans[i].size() - 1),
+                              &evicted);
+      }
+    }
+    if (evicted.empty()) {
+      break;
+    }
+    for (size_t i = 0; i < evicted.size(); i++) {
+      state.best_evicted_rank = std::min(state.best_evicted_rank,
+                                         evicted[i]->estimated_rank());
+      delete evicted[i];
+    }
+    state.num_evicted += evicted.size();
+    evicted.clear();
+  }
+}
+
+
+/* Returns the makespan of the given plan.  Refining a plan never
+   shortens its makespan, so this is a lower bound for the makespan of
+   any completion of the plan. */
+static float plan_makespan(const Plan& plan) {
+  std::map<size_t, float> start_times;
+  std::map<size_t, float> end_times;
+  return plan.orderings().schedule(start_times, end_times);
+}
+
+
 /* Id of goal step. */
 const size_t Plan::GOAL_ID = std::numeric_limits<size_t>::max();
 
@@ -145,7 +464,7 @@ static bool add_goal(const Chain<OpenCondition>*& open_conds,
     }
     if (l != NULL) {
       if (!test_only
-          && !(params->strip_static_preconditions()
+          && !(context->params->strip_static_preconditions()
                && PredicateTable::static_predicate(l->predicate()))) {
         open_conds =
           new Chain<OpenCondition>(OpenCondition(step_id, *l, when),
@@ -158,7 +477,7 @@ static bool add_goal(const Chain<OpenCondition>*& open_conds,
         const FormulaList& gs = conj->conjuncts();
         for (FormulaList::const_iterator fi = gs.begin();
              fi != gs.end(); fi++) {
-          if (params->random_open_conditions) {
+          if (context->params->random_open_conditions) {
             size_t pos = size_t((goals.size() + 1.0)*rand()/(RAND_MAX + 1.0));
             if (pos == goals.size()) {
               goals.push_back(*fi);
@@ -190,7 +509,7 @@ static bool add_goal(const Chain<OpenCondition>*& open_conds,
                                            bl->step_id2(step_id), is_eq));
 #ifdef BRANCH_ON_INEQUALITY
             const Inequality* neq = dynamic_cast<const Inequality*>(bl);
-            if (params->domain_constraints
+            if (context->params->domain_constraints
                 && neq != NULL && bl.term().variable()) {
               /* Both terms are variables, so handle specially. */
               if (!test_only) {
@@ -205,7 +524,7 @@ static bool add_goal(const Chain<OpenCondition>*& open_conds,
           } else {
             const Exists* exists = dynamic_cast<const Exists*>(goal);
             if (exists != NULL) {
-              if (params->random_open_conditions) {
+              if (context->params->random_open_conditions) {
                 size_t pos =
                   size_t((goals.size() + 1.0)*rand()/(RAND_MAX + 1.0));
                 if (pos == goals.size()) {
@@ -222,8 +541,8 @@ static bool add_goal(const Chain<OpenCondition>*& open_conds,
               const Forall* forall = dynamic_cast<const Forall*>(goal);
               if (forall != NULL) {
                 const Formula& g = forall->universal_base(
-                    std::map<Variable, Term>(), *problem);
-                if (params->random_open_conditions) {
+                    std::map<Variable, Term>(), *context->problem);
+                if (context->params->random_open_conditions) {
                   size_t pos =
                     size_t((goals.size() + 1.0)*rand()/(RAND_MAX + 1.0));
                   if (pos == goals.size()) {
@@ -251,16 +570,12 @@ static bool add_goal(const Chain<OpenCondition>*& open_conds,
 
 /* Returns a set of achievers for the given literal. */
 static const ActionEffectMap* literal_achievers(const Literal& literal) {
-  if (params->ground_actions) {
-    return planning_graph->literal_achievers(literal);
+  if (context->params->ground_actions) {
+    return context->planning_graph->literal_achievers(literal);
   } else if (typeid(literal) == typeid(Atom)) {
-    PredicateAchieverMap::const_iterator pai =
-      achieves_pred.find(literal.predicate());
-    return (pai != achieves_pred.end()) ? &(*pai).second : NULL;
+    return context->achieves_pred.find(literal.predicate());
   } else {
-    PredicateAchieverMap::const_iterator pai =
-      achieves_neg_pred.find(literal.predicate());
-    return (pai != achieves_neg_pred.end()) ? &(*pai).second : NULL;
+    return context->achieves_neg_pred.find(literal.predicate());
   }
 }
 
@@ -282,7 +597,8 @@ static void link_threats(const Chain<Unsafe>*& unsafes, size_t& num_unsafes,
       for (EffectList::const_iterator ei = effects.begin();
            ei != effects.end(); ei++) {
         const Effect& e = **ei;
-        if (!problem->durative() && e.link_condition().contradiction()) {
+        if (!context->problem->durative()
+            && e.link_condition().contradiction()) {
           continue;
         }
         StepTime et = end_time(e);
@@ -321,7 +637,8 @@ static void step_threats(const Chain<Unsafe>*& unsafes, size_t& num_unsafes,
       for (EffectList::const_iterator ei = effects.begin();
            ei != effects.end(); ei++) {
         const Effect& e = **ei;
-        if (!problem->durative() && e.link_condition().contradiction()) {
+        if (!context->problem->durative()
+            && e.link_condition().contradiction()) {
           continue;
         }
         StepTime et = end_time(e);
@@ -416,7 +733,7 @@ static const Bindings* step_instantiation(const Chain<Step>* steps, size_t n,
       } else {
         const Type& t = TermTable::type(v);
         const std::vector<Object>& arguments =
-            problem->terms().compatible_objects(t);
+            context->problem->terms().compatible_objects(t);
         for (std::vector<Object>::const_iterator oi = arguments.begin();
              oi != arguments.end(); oi++) {
           BindingList bl;
@@ -446,14 +763,14 @@ const Plan* Plan::make_initial_plan(const Problem& problem) {
   /*
    * Create goal of problem.
    */
-  if (params->ground_actions) {
-    goal_action = new GroundAction("", false);
+  if (context->params->ground_actions) {
+    context->goal_action = new GroundAction("", false);
     const Formula& goal_formula =
         problem.goal().instantiation(std::map<Variable, Term>(), problem);
-    goal_action->set_condition(goal_formula);
+    context->goal_action->set_condition(goal_formula);
   } else {
-    goal_action = new ActionSchema("", false);
-    goal_action->set_condition(problem.goal());
+    context->goal_action = new ActionSchema("", false);
+    context->goal_action->set_condition(problem.goal());
   }
   /* Chain of open conditions. */
   const Chain<OpenCondition>* open_conds = NULL;
@@ -463,7 +780,7 @@ const Plan* Plan::make_initial_plan(const Problem& problem) {
   BindingList new_bindings;
   /* Add goals as open conditions. */
   if (!add_goal(open_conds, num_open_conds, new_bindings,
-                goal_action->condition(), GOAL_ID)) {
+                context->goal_action->condition(), GOAL_ID)) {
     /* Goals are inconsistent. */
     RCObject::ref(open_conds);
     RCObject::destructive_deref(open_conds);
@@ -475,7 +792,8 @@ const Plan* Plan::make_initial_plan(const Problem& problem) {
   /* Make chain of initial steps. */
   const Chain<Step>* steps =
     new Chain<Step>(Step(0, problem.init_action()),
-                    new Chain<Step>(Step(GOAL_ID, *goal_action), NULL));
+                    new Chain<Step>(Step(GOAL_ID, *context->goal_action),
+                                    NULL));
   size_t num_steps = 0;
   /* Variable bindings. */
   const Bindings* bindings = &Bindings::EMPTY;
@@ -513,14 +831,18 @@ const Plan* Plan::make_initial_plan(const Problem& problem) {
 
 /* Returns plan for given problem. */
 const Plan* Plan::plan(const Problem& problem, const Parameters& p,
-                       bool last_problem) {
+                       bool last_problem, const PlanCallback& improved_plan) {
   Timer<> timer;
 
-  /* Set planning parameters. */
-  params = &p;
-  /* Set current domain. */
-  domain = &problem.domain();
-  ::problem = &problem;
+  /* Set up the context for planning on this thread. */
+  if (context == NULL) {
+    context = new PlanningContext();
+  }
+  NodePool::SetThreadArena(&context->arena);
+  const Parameters* params = &p;
+  context->params = params;
+  context->domain = &problem.domain();
+  context->problem = &problem;
 
   /*
    * Initialize planning graph and maps from predicates to actions.
@@ -533,28 +855,41 @@ const Plan* Plan::plan(const Problem& problem, const Parameters& p,
     }
   }
   if (need_pg) {
-    planning_graph = new PlanningGraph(problem, *params);
+    context->planning_graph = new PlanningGraph(problem, *params);
   } else {
-    planning_graph = NULL;
+    context->planning_graph = NULL;
   }
   if (!params->ground_actions) {
-    achieves_pred.clear();
-    achieves_neg_pred.clear();
-    for (std::map<std::string, const ActionSchema*>::const_iterator ai =
-             domain->actions().begin();
-         ai != domain->actions().end(); ai++) {
-      const ActionSchema* as = (*ai).second;
-      for (EffectList::const_iterator ei = as->effects().begin();
-           ei != as->effects().end(); ei++) {
-        const Literal& literal = (*ei)->literal();
-        if (typeid(literal) == typeid(Atom)) {
-          achieves_pred[literal.predicate()].insert(std::make_pair(as, *ei));
-        } else {
-          achieves_neg_pred[literal.predicate()].insert(std::make_pair(as,
-                                                                       *ei));
+    /* The achievers among the action schemas are kept between
+       problems with the same domain. */
+    const Domain* domain = context->domain;
+    std::unique_lock<std::mutex> lock(achievers_mutex);
+    if (achievers_domain != domain) {
+      domain_achieves_pred.clear();
+      domain_achieves_neg_pred.clear();
+      for (std::map<std::string, const ActionSchema*>::const_iterator ai =
+               domain->actions().begin();
+           ai != domain->actions().end(); ai++) {
+        const ActionSchema* as = (*ai).second;
+        for (EffectList::const_iterator ei = as->effects().begin();
+             ei != as->effects().end(); ei++) {
+          const Literal& literal = (*ei)->literal();
+          if (typeid(literal) == typeid(Atom)) {
+            domain_achieves_pred[literal.predicate()].insert(
+                std::make_pair(as, *ei));
+          } else {
+            domain_achieves_neg_pred[literal.predicate()].insert(
+                std::make_pair(as, *ei));
+          }
         }
       }
+      achievers_domain = domain;
     }
+    PredicateAchieverMap& achieves_pred = context->achieves_pred;
+    PredicateAchieverMap& achieves_neg_pred = context->achieves_neg_pred;
+    achieves_pred = domain_achieves_pred;
+    achieves_neg_pred = domain_achieves_neg_pred;
+    lock.unlock();
     const GroundAction& ia = problem.init_action();
     for (EffectList::const_iterator ei = ia.effects().begin();
          ei != ia.effects().end(); ei++) {
@@ -577,28 +912,260 @@ const Plan* Plan::plan(const Problem& problem, const Parameters& p,
       }
     }
   }
+
+  /* Construct the initial plan. */
+  const Plan* initial_plan = make_initial_plan(problem);
+  if (initial_plan != NULL) {
+    initial_plan->id_ = 0;
+  }
+
+  /*
+   * Search for complete plan, either interleaving the flaw selection
+   * orders on this thread or running each of them on its own thread.
+   */
+  const Plan* current_plan = NULL;
+  std::vector<SearchState> states;
+  if (!params->portfolio || params->flaw_orders.size() == 1
+      || initial_plan == NULL || params->anytime) {
+    states.push_back(SearchState(timer, NULL, true));
+    states.back().improved_plan = improved_plan;
+    current_plan = search(initial_plan, params->flaw_orders,
+                          params->search_limits, states.back(),
+                          last_problem);
+  } else {
+    const size_t n = params->flaw_orders.size();
+    /* N.B. Must compute rank of the initial plan before it is shared
+       between threads, because the rank is cached on first use. */
+    initial_plan->primary_rank();
+    /* Set by the first search that finds a plan or runs out of plans. */
+    std::atomic<bool> finished(false);
+    /* Index of the first search to finish. */
+    size_t winner = n;
+    std::vector<const Plan*> results(n, NULL);
+    for (size_t i = 0; i < n; i++) {
+      states.push_back(SearchState(timer, &finished, i == 0));
+    }
+    /* The searches share the context of this thread. */
+    PlanningContext* const plan_context = context;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < n; i++) {
+      threads.emplace_back([&, i]() {
+        context = plan_context;
+        NodePool::SetThreadArena(&plan_context->arena);
+        const Plan* plan =
+            search(initial_plan,
+                   std::vector<FlawSelectionOrder>(1, params->flaw_orders[i]),
+                   std::vector<size_t>(1, params->search_limits[i]),
+                   states[i], last_problem);
+        results[i] = plan;
+        if ((plan == NULL || plan->complete()) && !finished.exchange(true)) {
+          winner = i;
+        }
+      });
+    }
+    for (size_t i = 0; i < n; i++) {
+      threads[i].join();
+    }
+    current_plan = results[(winner < n) ? winner : 0];
+    for (size_t i = 0; i < n; i++) {
+      if (results[i] != NULL && results[i] != current_plan
+          && results[i] != initial_plan) {
+        delete results[i];
+      }
+    }
+    if (verbosity > 1 && winner < n) {
+      std::cerr << "flaw order " << winner << " finished first" << std::endl;
+    }
+  }
+  if (verbosity > 0) {
+    /*
+     * Print statistics.
+     */
+    size_t num_generated_plans = 0;
+    size_t num_visited_plans = 0;
+    size_t num_static = 0;
+    size_t num_dead_ends = 0;
+    size_t num_duplicates = 0;
+    size_t num_evicted = 0;
+    float best_evicted_rank = std::numeric_limits<float>::infinity();
+    for (std::vector<SearchState>::const_iterator si = states.begin();
+         si != states.end(); si++) {
+      num_generated_plans += (*si).num_generated_plans;
+      num_visited_plans += (*si).num_visited_plans;
+      num_static += (*si).num_static;
+      num_dead_ends += (*si).num_dead_ends;
+      num_duplicates += (*si).num_duplicates;
+      num_evicted += (*si).num_evicted;
+      best_evicted_rank = std::min(best_evicted_rank,
+                                   (*si).best_evicted_rank);
+    }
+    std::cerr << std::endl << "Plans generated: " << num_generated_plans;
+    if (num_static > 0) {
+      std::cerr << " [" << (num_generated_plans - num_static) << "]";
+    }
+    std::cerr << std::endl << "Plans visited: " << num_visited_plans;
+    if (num_static > 0) {
+      std::cerr << " [" << (num_visited_plans - num_static) << "]";
+    }
+    std::cerr << std::endl << "Dead ends encountered: " << num_dead_ends
+              << std::endl;
+    if (params->prune_duplicates) {
+      std::cerr << "Duplicate plans pruned: " << num_duplicates << std::endl;
+    }
+    if (params->memory_limit != std::numeric_limits<size_t>::max()) {
+      std::cerr << "Plans evicted: " << num_evicted;
+      if (num_evicted > 0) {
+        std::cerr << " (best rank " << best_evicted_rank << ")";
+      }
+      std::cerr << std::endl;
+    }
+  }
+  /*
+   * Discard the initial plan, unless this is the last problem in which
+   * case we can save time by just letting the operating system reclaim
+   * the memory for us.
+   */
+  if (!last_problem && current_plan != initial_plan) {
+    delete initial_plan;
+  }
+  /* Return last plan, or NULL if problem does not have a solution. */
+  return current_plan;
+}
+
+
+/* Searches for a complete plan starting from the given initial plan,
+   switching between the given flaw selection orders. */
+const Plan* Plan::search(const Plan* initial_plan,
+                         const std::vector<FlawSelectionOrder>& flaw_orders,
+                         const std::vector<size_t>& search_limits,
+                         SearchState& state, bool last_problem) {
+  const Parameters* params = context->params;
   static_pred_flaw = false;
 
   /* Number of visited plan. */
-  size_t num_visited_plans = 0;
+  size_t& num_visited_plans = state.num_visited_plans;
   /* Number of generated plans. */
-  size_t num_generated_plans = 0;
+  size_t& num_generated_plans = state.num_generated_plans;
   /* Number of static preconditions encountered. */
-  size_t num_static = 0;
+  size_t& num_static = state.num_static;
   /* Number of dead ends encountered. */
-  size_t num_dead_ends = 0;
+  size_t& num_dead_ends = state.num_dead_ends;
 
   /* Generated plans for different flaw selection orders. */
-  std::vector<size_t> generated_plans(params->flaw_orders.size(), 0);
+  std::vector<size_t> generated_plans(flaw_orders.size(), 0);
   /* Queues of pending plans. */
-  std::vector<PlanQueue> plans(params->flaw_orders.size(), PlanQueue());
+  std::vector<PlanQueue> plans(flaw_orders.size(), PlanQueue());
+  /* Keys of generated plans for different flaw selection
+     orders, used to prune duplicates. */
+  std::vector<PlanKeySet> generated_keys(flaw_orders.size());
+  /* Number of generated plans pruned as duplicates. */
+  size_t& num_duplicates = state.num_duplicates;
   /* Dead plan queues. */
   std::vector<PlanQueue*> dead_queues;
-  /* Construct the initial plan. */
-  const Plan* initial_plan = make_initial_plan(problem);
-  if (initial_plan != NULL) {
-    initial_plan->id_ = 0;
-  }
+  /* Worker threads for expanding plans, or NULL if single threaded. */
+  std::unique_ptr<WorkerPool> pool;
+  if (params->search_threads > 1) {
+    pool.reset(new WorkerPool(params->search_threads));
+  }
+  /* Context that the worker threads take over from this thread. */
+  PlanningContext* const search_context = context;
+  /* Next id for plans generated by worker threads. */
+  size_t next_plan_id = 1;
+  /* Whether generated plans are ranked only when they are selected. */
+  const bool deferred = deferred_evaluation();
+  /* Best complete plan found so far in anytime mode, and its
+     makespan. */
+  const Plan* best_plan = NULL;
+  float best_makespan = std::numeric_limits<float>::infinity();
+  /* Keeps the given complete plan if it has a shorter makespan than
+     the best plan found so far, and otherwise discards it. */
+  auto record_plan = [&](const Plan* plan) {
+    const float makespan = plan_makespan(*plan);
+    if (makespan < best_makespan) {
+      if (best_plan != NULL && best_plan != initial_plan) {
+        delete best_plan;
+      }
+      best_plan = plan;
+      best_makespan = makespan;
+      if (state.improved_plan) {
+        state.improved_plan(*plan);
+      }
+    } else if (plan != initial_plan) {
+      delete plan;
+    }
+  };
+  /* Plans cut off by the f limit of IDA*.  As long as every cut off
+     plan is kept, the next iteration continues from these plans
+     instead of starting over from the initial plan.  This is only done
+     with a single flaw selection order, because the plans of the other
+     orders would have to be searched in the same iteration.  With a
+     memory limit, the cut off plans count towards the limit, and are
+     dropped before pending plans are evicted. */
+  std::vector<const Plan*> cutoff_plans;
+  const bool reuse_frontier = (params->search_algorithm == Parameters::IDA_STAR
+                               && flaw_orders.size() == 1);
+  bool frontier_complete = reuse_frontier;
+  /* Removes the best plan from the given queue and returns it, or
+     returns NULL if the queue is empty.  With deferred evaluation,
+     plans are ranked when they reach the front of the queue, and are
+     queued again if their rank is worse than estimated. */
+  auto pop_plan = [](PlanQueue& queue) -> const Plan* {
+    while (!queue.empty()) {
+      const Plan* plan = queue.top();
+      queue.pop();
+      if (plan->num_ranks_ > 0) {
+        return plan;
+      }
+      const float estimate = plan->rank_[0];
+      const float rank = plan->primary_rank();
+      if (rank == std::numeric_limits<float>::infinity()) {
+        delete plan;
+      } else if (rank > estimate) {
+        queue.push(plan);
+      } else {
+        return plan;
+      }
+    }
+    return NULL;
+  };
+  /* Instantiates all actions of the given plan if it is otherwise
+     complete, and returns the resulting plan.  Plans that cannot be
+     instantiated, and in anytime mode also complete plans, are
+     replaced by the next plan from the given queue. */
+  auto instantiate_plan = [&](const Plan* plan,
+                              PlanQueue& queue) -> const Plan* {
+    bool instantiated = params->ground_actions;
+    while (plan != NULL && plan->complete()) {
+      if (instantiated) {
+        if (!params->anytime) {
+          break;
+        }
+        /* Keep going in anytime mode. */
+        record_plan(plan);
+        plan = pop_plan(queue);
+        instantiated = params->ground_actions;
+        continue;
+      }
+      const Bindings* new_bindings =
+        step_instantiation(plan->steps(), 0, *plan->bindings_);
+      if (new_bindings != NULL) {
+        instantiated = true;
+        if (new_bindings != plan->bindings_) {
+          const Plan* inst_plan =
+            new Plan(plan->steps(), plan->num_steps(),
+                     plan->links(), plan->num_links(),
+                     plan->orderings(), *new_bindings,
+                     NULL, 0, NULL, 0, NULL, plan);
+          delete plan;
+          plan = inst_plan;
+        }
+      } else {
+        /* Problem lacks solution if there are no more plans. */
+        plan = pop_plan(queue);
+      }
+    }
+    return plan;
+  };
 
   /* Variable for progress bar (number of generated plans). */
   size_t last_dot = 0;
@@ -609,7 +1176,7 @@ const Plan* Plan::plan(const Problem& problem, const Parameters& p,
    * Search for complete plan.
    */
   size_t current_flaw_order = 0;
-  size_t flaw_orders_left = params->flaw_orders.size();
+  size_t flaw_orders_left = flaw_orders.size();
   size_t next_switch = 1000;
   const Plan* current_plan = initial_plan;
   generated_plans[current_flaw_order]++;
@@ -636,17 +1203,50 @@ const Plan* Plan::plan(const Problem& problem, const Parameters& p,
           dead_queues.pop_back();
         }
       }
-      const auto elapsed_time = timer.ElapsedTime();
+      const auto elapsed_time = state.timer.ElapsedTime();
       if (elapsed_time >= params->time_limit) {
         /* Time limit exceeded. */
         break;
       }
+      if (state.cancelled != NULL
+          && state.cancelled->load(std::memory_order_relaxed)) {
+        /* Another search has found a plan. */
+        break;
+      }
 
       /*
-       * Visiting a new plan.
+       * Visiting new plans.  With worker threads, the current plan is
+       * expanded together with the next best incomplete plans in the
+       * queue, one per thread.
        */
-      num_visited_plans++;
-      if (verbosity == 1) {
+      std::vector<const Plan*> batch(1, current_plan);
+      if (pool != NULL) {
+        PlanQueue& queue = plans[current_flaw_order];
+        while (batch.size() < size_t(pool->num_threads())) {
+          const Plan* plan = pop_plan(queue);
+          if (plan == NULL) {
+            break;
+          } else if (plan->complete()) {
+            queue.push(plan);
+            break;
+          }
+          batch.push_back(plan);
+        }
+      }
+      for (size_t bi = 0; bi < batch.size(); bi++) {
+        num_visited_plans++;
+        if (verbosity > 1) {
+          const Plan& plan = *batch[bi];
+          std::cerr << std::endl << (num_visited_plans - num_static) << ": "
+                    << "!!!!CURRENT PLAN (id " << plan.id_ << ")"
+                    << " with rank (" << plan.primary_rank();
+          for (size_t ri = 1; ri < plan.num_ranks_; ri++) {
+            std::cerr << ',' << plan.rank(ri);
+          }
+          std::cerr << ")" << std::endl << plan << std::endl;
+        }
+      }
+      if (verbosity == 1 && state.show_progress) {
         while (num_generated_plans - num_static - last_dot >= 1000) {
           std::cerr << '.';
           last_dot += 1000;
@@ -656,57 +1256,148 @@ const Plan* Plan::plan(const Problem& problem, const Parameters& p,
           ++next_hash;
         }
       }
-      if (verbosity > 1) {
-        std::cerr << std::endl << (num_visited_plans - num_static) << ": "
-                  << "!!!!CURRENT PLAN (id " << current_plan->id_ << ")"
-                  << " with rank (" << current_plan->primary_rank();
-        for (size_t ri = 1; ri < current_plan->rank_.size(); ri++) {
-          std::cerr << ',' << current_plan->rank_[ri];
+      /* Checks if the given child of the given plan is to be queued,
+         and otherwise deletes it, or keeps it as a cut off plan.  With
+         deferred evaluation, the child is first given an estimated
+         rank. */
+      auto keep_child = [&](const Plan& new_plan, const Plan& parent) {
+        if (deferred) {
+          /* Estimate the rank from the rank of the parent, with the
+             change in steps and open conditions as the change in
+             heuristic value. */
+          new_plan.rank_[0] = parent.primary_rank()
+            + (float(new_plan.num_steps()) - parent.num_steps())
+            + params->weight*(float(new_plan.num_open_conds())
+                              - parent.num_open_conds());
+        } else if (new_plan.primary_rank()
+                   == std::numeric_limits<float>::infinity()) {
+          delete &new_plan;
+          return false;
+        }
+        if (params->search_algorithm == Parameters::IDA_STAR
+            && new_plan.primary_rank() > f_limit) {
+          next_f_limit = std::min(next_f_limit, new_plan.primary_rank());
+          if (frontier_complete) {
+            cutoff_plans.push_back(&new_plan);
+          } else {
+            delete &new_plan;
+          }
+          return false;
+        }
+        if (best_plan != NULL && plan_makespan(new_plan) >= best_makespan) {
+          /* Cannot lead to a better plan than the best one found. */
+          delete &new_plan;
+          return false;
+        }
+        if (params->prune_duplicates
+            && !generated_keys[current_flaw_order].released()
+            && !generated_keys[current_flaw_order].insert(
+                plan_key(new_plan))) {
+          /* An equivalent plan has already been generated. */
+          num_duplicates++;
+          delete &new_plan;
+          return false;
+        }
+        return true;
+      };
+      /* Lists of children to the plans in the batch. */
+      std::vector<PlanList> refinements;
+      /* Whether the flaw refined in each plan was a static predicate. */
+      std::vector<char> static_flaws(batch.size(), false);
+      const FlawSelectionOrder& flaw_order = flaw_orders[current_flaw_order];
+      if (pool == NULL) {
+        /* Each child is ranked and checked as soon as it is built, and
+           refinement stops once the children kept reach the search
+           limit, so children past the limit are never built. */
+        const size_t capacity =
+          (generated_plans[current_flaw_order]
+           < search_limits[current_flaw_order])
+          ? (search_limits[current_flaw_order]
+             - generated_plans[current_flaw_order])
+          : 0;
+        refinements.push_back(PlanList(capacity, [&](const Plan* new_plan) {
+          /* N.B. Must set id before computing rank, because it may be
+             used. */
+          new_plan->id_ = num_generated_plans + refinements[0].size();
+          return keep_child(*new_plan, *current_plan);
+        }));
+        current_plan->refinements(refinements[0], flaw_order);
+        static_flaws[0] = static_pred_flaw;
+      } else {
+        refinements.resize(batch.size());
+        pool->ParallelFor(batch.size(), [&](size_t bi) {
+          context = search_context;
+          NodePool::SetThreadArena(&search_context->arena);
+          batch[bi]->refinements(refinements[bi], flaw_order);
+          static_flaws[bi] = static_pred_flaw;
+        });
+        /* N.B. Must set ids before computing ranks, because they may
+           be used. */
+        std::vector<const Plan*> children;
+        for (size_t bi = 0; bi < batch.size(); bi++) {
+          for (PlanList::const_iterator pi = refinements[bi].begin();
+               pi != refinements[bi].end(); pi++) {
+            (*pi)->id_ = next_plan_id++;
+            children.push_back(*pi);
+          }
+        }
+        if (!deferred) {
+          pool->ParallelFor(children.size(), [&](size_t ci) {
+            context = search_context;
+            NodePool::SetThreadArena(&search_context->arena);
+            children[ci]->primary_rank();
+          });
         }
-        std::cerr << ")" << std::endl << *current_plan << std::endl;
       }
-      /* List of children to current plan. */
-      PlanList refinements;
-      /* Get plan refinements. */
-      current_plan->refinements(refinements,
-                                params->flaw_orders[current_flaw_order]);
       /* Add children to queue of pending plans. */
-      bool added = false;
-      for (PlanList::const_iterator pi = refinements.begin();
-           pi != refinements.end(); pi++) {
-        const Plan& new_plan = **pi;
-        /* N.B. Must set id before computing rank, because it may be used. */
-        new_plan.id_ = num_generated_plans;
-        if (new_plan.primary_rank() != std::numeric_limits<float>::infinity()
-            && (generated_plans[current_flaw_order]
-                < params->search_limits[current_flaw_order])) {
-          if (params->search_algorithm == Parameters::IDA_STAR
-              && new_plan.primary_rank() > f_limit) {
-            next_f_limit = std::min(next_f_limit, new_plan.primary_rank());
-            delete &new_plan;
-            continue;
+      for (size_t bi = 0; bi < batch.size(); bi++) {
+        bool added = false;
+        for (PlanList::const_iterator pi = refinements[bi].begin();
+             pi != refinements[bi].end(); pi++) {
+          const Plan& new_plan = **pi;
+          if (pool != NULL) {
+            /* Children built by worker threads are checked here. */
+            if (generated_plans[current_flaw_order]
+                >= search_limits[current_flaw_order]) {
+              delete &new_plan;
+              continue;
+            } else if (!keep_child(new_plan, *batch[bi])) {
+              continue;
+            }
           }
-          if (!added && static_pred_flaw) {
+          if (!added && static_flaws[bi]) {
             num_static++;
           }
           added = true;
           plans[current_flaw_order].push(&new_plan);
           generated_plans[current_flaw_order]++;
           num_generated_plans++;
-          if (verbosity > 2) {
-            std::cerr << std::endl << "####CHILD (id " << new_plan.id_ << ")"
-                      << " with rank (" << new_plan.primary_rank();
-            for (size_t ri = 1; ri < new_plan.rank_.size(); ri++) {
-              std::cerr << ',' << new_plan.rank_[ri];
+          if (verbosity > 2 && deferred) {
+            std::cerr << std::endl << "####CHILD (id " << new_plan.id_
+                      << ")" << " with estimated rank "
+                      << new_plan.estimated_rank() << ":" << std::endl
+                      << new_plan << std::endl;
+          } else if (verbosity > 2) {
+            std::cerr << std::endl << "####CHILD (id " << new_plan.id_
+                      << ")" << " with rank (" << new_plan.primary_rank();
+            for (size_t ri = 1; ri < new_plan.num_ranks_; ri++) {
+              std::cerr << ',' << new_plan.rank(ri);
             }
             std::cerr << "):" << std::endl << new_plan << std::endl;
           }
-        } else {
-          delete &new_plan;
+        }
+        if (!added) {
+          num_dead_ends++;
+        }
+        /* The current plan is deleted when the next plan is selected. */
+        if (bi > 0) {
+          delete batch[bi];
         }
       }
-      if (!added) {
-        num_dead_ends++;
+
+      if (params->memory_limit != std::numeric_limits<size_t>::max()) {
+        evict_plans(plans, dead_queues, cutoff_plans, frontier_complete,
+                    generated_keys, state);
       }
 
       /*
@@ -714,7 +1405,7 @@ const Plan* Plan::plan(const Problem& problem, const Parameters& p,
        */
       bool limit_reached = false;
       if ((limit_reached = (generated_plans[current_flaw_order]
-                            >= params->search_limits[current_flaw_order]))
+                            >= search_limits[current_flaw_order]))
           || generated_plans[current_flaw_order] >= next_switch) {
         if (verbosity > 1) {
           std::cerr << "time to switch ("
@@ -732,12 +1423,12 @@ const Plan* Plan::plan(const Problem& problem, const Parameters& p,
               std::cerr << "use flaw order "
                         << current_flaw_order << "?" << std::endl;
             }
-            if (current_flaw_order >= params->flaw_orders.size()) {
+            if (current_flaw_order >= flaw_orders.size()) {
               current_flaw_order = 0;
               next_switch *= 2;
             }
           } while ((generated_plans[current_flaw_order]
-                    >= params->search_limits[current_flaw_order]));
+                    >= search_limits[current_flaw_order]));
           if (verbosity > 1) {
             std::cerr << "using flaw order " << current_flaw_order
                       << std::endl;
@@ -753,42 +1444,11 @@ const Plan* Plan::plan(const Problem& problem, const Parameters& p,
           if (current_plan != initial_plan) {
             delete current_plan;
           }
-          if (plans[current_flaw_order].empty()) {
-            /* Problem lacks solution. */
-            current_plan = NULL;
-          } else {
-            current_plan = plans[current_flaw_order].top();
-            plans[current_flaw_order].pop();
-          }
-        }
-        /*
-         * Instantiate all actions if the plan is otherwise complete.
-         */
-        bool instantiated = params->ground_actions;
-        while (current_plan != NULL && current_plan->complete()
-               && !instantiated) {
-          const Bindings* new_bindings =
-            step_instantiation(current_plan->steps(), 0,
-                               *current_plan->bindings_);
-          if (new_bindings != NULL) {
-            instantiated = true;
-            if (new_bindings != current_plan->bindings_) {
-              const Plan* inst_plan =
-                new Plan(current_plan->steps(), current_plan->num_steps(),
-                         current_plan->links(), current_plan->num_links(),
-                         current_plan->orderings(), *new_bindings,
-                         NULL, 0, NULL, 0, NULL, current_plan);
-              delete current_plan;
-              current_plan = inst_plan;
-            }
-          } else if (plans[current_flaw_order].empty()) {
-            /* Problem lacks solution. */
-            current_plan = NULL;
-          } else {
-            current_plan = plans[current_flaw_order].top();
-            plans[current_flaw_order].pop();
-          }
+          /* Problem lacks solution if there are no more plans. */
+          current_plan = pop_plan(plans[current_flaw_order]);
         }
+        current_plan = instantiate_plan(current_plan,
+                                        plans[current_flaw_order]);
       } else {
         if (next_f_limit != std::numeric_limits<float>::infinity()) {
           current_plan = NULL;
@@ -801,58 +1461,117 @@ const Plan* Plan::plan(const Problem& problem, const Parameters& p,
     }
     f_limit = next_f_limit;
     if (f_limit != std::numeric_limits<float>::infinity()) {
-      /* Restart search. */
       if (current_plan != NULL && current_plan != initial_plan) {
         delete current_plan;
       }
-      current_plan = initial_plan;
+      if (frontier_complete && flaw_orders_left > 0) {
+        /* Continue search from the plans that were cut off. */
+        std::vector<const Plan*> remaining_plans;
+        for (size_t i = 0; i < cutoff_plans.size(); i++) {
+          const Plan* plan = cutoff_plans[i];
+          if (plan->primary_rank() <= f_limit) {
+            plans[current_flaw_order].push(plan);
+            generated_plans[current_flaw_order]++;
+            num_generated_plans++;
+          } else {
+            remaining_plans.push_back(plan);
+          }
+        }
+        cutoff_plans.swap(remaining_plans);
+        current_plan = instantiate_plan(pop_plan(plans[current_flaw_order]),
+                                        plans[current_flaw_order]);
+      } else {
+        /* Restart search. */
+        for (size_t i = 0; i < cutoff_plans.size(); i++) {
+          delete cutoff_plans[i];
+        }
+        cutoff_plans.clear();
+        frontier_complete = reuse_frontier;
+        current_plan = initial_plan;
+        for (size_t i = 0; i < generated_keys.size(); i++) {
+          generated_keys[i].clear();
+        }
+      }
     }
   } while (f_limit != std::numeric_limits<float>::infinity());
-  if (verbosity > 0) {
-    /*
-     * Print statistics.
-     */
-    std::cerr << std::endl << "Plans generated: " << num_generated_plans;
-    if (num_static > 0) {
-      std::cerr << " [" << (num_generated_plans - num_static) << "]";
-    }
-    std::cerr << std::endl << "Plans visited: " << num_visited_plans;
-    if (num_static > 0) {
-      std::cerr << " [" << (num_visited_plans - num_static) << "]";
-    }
-    std::cerr << std::endl << "Dead ends encountered: " << num_dead_ends
-              << std::endl;
+  if (current_plan == NULL && state.num_evicted > 0) {
+    /* The queues ran out only because plans were evicted, so the
+       problem may still have a solution.  Report the search as
+       incomplete with the initial plan. */
+    current_plan = initial_plan;
   }
   /*
-   * Discard the rest of the plan queue and some other things, unless
-   * this is the last problem in which case we can save time by just
-   * letting the operating system reclaim the memory for us.
+   * Discard the rest of the plan queue, unless this is the last
+   * problem in which case we can save time by just letting the
+   * operating system reclaim the memory for us.
    */
   if (!last_problem) {
-    if (current_plan != initial_plan) {
-      delete initial_plan;
-    }
     for (size_t i = 0; i < plans.size(); i++) {
       while (!plans[i].empty()) {
         delete plans[i].top();
         plans[i].pop();
       }
     }
+    for (size_t i = 0; i < cutoff_plans.size(); i++) {
+      delete cutoff_plans[i];
+    }
+  }
+  if (best_plan != NULL) {
+    if (current_plan != NULL && current_plan != initial_plan) {
+      delete current_plan;
+    }
+    current_plan = best_plan;
+  } else if (params->anytime && current_plan != NULL
+             && current_plan->complete() && state.improved_plan) {
+    state.improved_plan(*current_plan);
   }
   /* Return last plan, or NULL if problem does not have a solution. */
   return current_plan;
 }
 
 
-/* Cleans up after planning. */
+/* Cleans up after planning on this thread. */
 void Plan::cleanup() {
-  if (planning_graph != NULL) {
-    delete planning_graph;
-    planning_graph = NULL;
+  if (context != NULL) {
+    if (context->planning_graph != NULL) {
+      delete context->planning_graph;
+    }
+    if (context->goal_action != NULL) {
+      delete context->goal_action;
+    }
+    /* Gives the memory for chains and plans back in one go, with any
+       plans that are left. */
+    NodePool::SetThreadArena(NULL);
+    delete context;
+    context = NULL;
   }
-  if (goal_action != NULL) {
-    delete goal_action;
-    goal_action = NULL;
+}
+
+
+/* Discards the achievers cached for the domain of the last problem. */
+void Plan::clear_domain_cache() {
+  std::lock_guard<std::mutex> lock(achievers_mutex);
+  achievers_domain = NULL;
+  domain_achieves_pred.clear();
+  domain_achieves_neg_pred.clear();
+}
+
+
+/* Constructs a list that keeps every plan and is never full. */
+Plan::PlanList::PlanList()
+  : capacity_(std::numeric_limits<size_t>::max()) {}
+
+
+/* Constructs a list that keeps the plans accepted by the given filter,
+   and is full once it holds the given number of plans. */
+Plan::PlanList::PlanList(size_t capacity, const Filter& filter)
+  : capacity_(capacity), filter_(filter) {}
+
+
+/* Adds a plan to this list, unless the filter rejects it. */
+void Plan::PlanList::push_back(const Plan* plan) {
+  if (!filter_ || filter_(plan)) {
+    std::vector<const Plan*>::push_back(plan);
   }
 }
 
@@ -869,7 +1588,9 @@ Plan::Plan(const Chain<Step>* steps, size_t num_steps,
     orderings_(&orderings), bindings_(&bindings),
     unsafes_(unsafes), num_unsafes_(num_unsafes),
     open_conds_(open_conds), num_open_conds_(num_open_conds),
-    mutex_threats_(mutex_threats) {
+    mutex_threats_(mutex_threats), rank_(), long_rank_(NULL), num_ranks_(0),
+    add_known_(false), parent_add_known_(false), parent_open_conds_(NULL),
+    parent_num_open_conds_(0) {
   RCObject::ref(steps);
   RCObject::ref(links);
   Orderings::register_use(&orderings);
@@ -877,6 +1598,18 @@ Plan::Plan(const Chain<Step>* steps, size_t num_steps,
   RCObject::ref(unsafes);
   RCObject::ref(open_conds);
   RCObject::ref(mutex_threats);
+  if (parent != NULL && parent->add_known_
+      && (parent->bindings_ == bindings_
+          || context->params->ground_actions)) {
+    /* The heuristic values of the open conditions shared with the
+       parent plan are unchanged. */
+    add_cost_ = parent->add_cost_;
+    add_work_ = parent->add_work_;
+    parent_add_known_ = true;
+    parent_open_conds_ = parent->open_conds_;
+    parent_num_open_conds_ = parent->num_open_conds_;
+    RCObject::ref(parent_open_conds_);
+  }
 #ifdef DEBUG
   depth_ = (parent != NULL) ? parent->depth() + 1 : 0;
 #endif
@@ -892,12 +1625,129 @@ Plan::~Plan() {
   RCObject::destructive_deref(unsafes_);
   RCObject::destructive_deref(open_conds_);
   RCObject::destructive_deref(mutex_threats_);
+  RCObject::destructive_deref(parent_open_conds_);
+  if (long_rank_ != NULL) {
+    delete[] long_rank_;
+    NodePool::Charge(-static_cast<long>(num_ranks_*sizeof(float)));
+  }
 }
 
 
 /* Returns the bindings of this plan. */
 const Bindings* Plan::bindings() const {
-  return params->ground_actions ? NULL : bindings_;
+  return context->params->ground_actions ? NULL : bindings_;
+}
+
+
+/* Returns the given step id renamed by the given map. */
+static size_t renamed(const std::vector<size_t>& step_ids, size_t id) {
+  return (id < step_ids.size()) ? step_ids[id] : id;
+}
+
+
+/* Returns the values identifying the given causal link, with step
+   ids renamed by the given map. */
+static std::array<uint64_t, 5> link_key(const Link& link,
+                                        const std::vector<size_t>& step_ids) {
+  return {{ renamed(step_ids, link.from_id()),
+            static_cast<uint64_t>(3*link.effect_time().point
+                                  + link.effect_time().rel),
+            renamed(step_ids, link.to_id()),
+            reinterpret_cast<uintptr_t>(&link.condition()),
+            static_cast<uint64_t>(link.condition_time()) }};
+}
+
+
+/* Sorts the given tuples and appends them to the given key. */
+template<size_t N>
+static void append_sorted(std::vector<uint64_t>& key,
+                          std::vector<std::array<uint64_t, N> >& tuples) {
+  std::sort(tuples.begin(), tuples.end());
+  key.push_back(tuples.size());
+  for (size_t i = 0; i < tuples.size(); i++) {
+    key.insert(key.end(), tuples[i].begin(), tuples[i].end());
+  }
+}
+
+
+/* Appends to the given key the steps, causal links, flaws, ordering
+   constraints and binding constraints of this plan, with the steps
+   renamed in a canonical order. */
+void Plan::key(std::vector<uint64_t>& key) const {
+  /* Rename the steps in order of their actions and the objects bound
+     to their parameters, so that plans that only differ in the order
+     in which equal steps were added get the same key.  Steps that
+     cannot be told apart this way keep their relative order. */
+  std::vector<std::vector<uint64_t> > steps;
+  for (const Chain<Step>* sc = this->steps(); sc != NULL; sc = sc->tail) {
+    const Step& step = sc->head;
+    if (step.id() == 0 || step.id() == GOAL_ID) {
+      continue;
+    }
+    steps.push_back(std::vector<uint64_t>(1, step.action().id()));
+    const ActionSchema* as = dynamic_cast<const ActionSchema*>(&step.action());
+    if (as != NULL && bindings() != NULL) {
+      const std::vector<Variable>& params = as->parameters();
+      for (size_t i = 0; i < params.size(); i++) {
+        Term t = bindings()->binding(params[i], step.id());
+        steps.back().push_back(t.object() ? t.index() + uint64_t{1} : 0);
+      }
+    }
+    steps.back().push_back(step.id());
+  }
+  std::sort(steps.begin(), steps.end());
+  std::vector<size_t> step_ids(num_steps() + 1, 0);
+  for (size_t i = 0; i < steps.size(); i++) {
+    step_ids[steps[i].back()] = i + 1;
+  }
+  key.push_back(steps.size());
+  for (size_t i = 0; i < steps.size(); i++) {
+    key.push_back(steps[i].front());
+  }
+  std::vector<std::array<uint64_t, 5> > links;
+  for (const Chain<Link>* lc = this->links(); lc != NULL; lc = lc->tail) {
+    links.push_back(link_key(lc->head, step_ids));
+  }
+  append_sorted(key, links);
+  std::vector<std::array<uint64_t, 3> > open_conds;
+  for (const Chain<OpenCondition>* oc = this->open_conds();
+       oc != NULL; oc = oc->tail) {
+    const OpenCondition& open_cond = oc->head;
+    open_conds.push_back(
+        {{ renamed(step_ids, open_cond.step_id()),
+           reinterpret_cast<uintptr_t>(&open_cond.condition()),
+           static_cast<uint64_t>(open_cond.when()) }});
+  }
+  append_sorted(key, open_conds);
+  std::vector<std::array<uint64_t, 7> > unsafes;
+  for (const Chain<Unsafe>* uc = this->unsafes(); uc != NULL; uc = uc->tail) {
+    const Unsafe& unsafe = uc->head;
+    std::array<uint64_t, 5> link = link_key(unsafe.link(), step_ids);
+    unsafes.push_back({{ link[0], link[1], link[2], link[3], link[4],
+                         renamed(step_ids, unsafe.step_id()),
+                         reinterpret_cast<uintptr_t>(&unsafe.effect()) }});
+  }
+  append_sorted(key, unsafes);
+  std::vector<std::array<uint64_t, 4> > mutex_threats;
+  for (const Chain<MutexThreat>* mc = this->mutex_threats();
+       mc != NULL; mc = mc->tail) {
+    const MutexThreat& mt = mc->head;
+    if (mt.step_id1() == 0) {
+      /* A place holder has no effects. */
+      mutex_threats.push_back({{ 0, 0, 0, 0 }});
+    } else {
+      mutex_threats.push_back(
+          {{ renamed(step_ids, mt.step_id1()),
+             reinterpret_cast<uintptr_t>(&mt.effect1()),
+             renamed(step_ids, mt.step_id2()),
+             reinterpret_cast<uintptr_t>(&mt.effect2()) }});
+    }
+  }
+  append_sorted(key, mutex_threats);
+  orderings().key(key, step_ids);
+  if (bindings() != NULL) {
+    bindings()->key(key, step_ids);
+  }
 }
 
 
@@ -910,9 +1760,18 @@ bool Plan::complete() const {
 /* Returns the primary rank of this plan, where a lower rank
    signifies a better plan. */
 float Plan::primary_rank() const {
-  if (rank_.empty()) {
-    params->heuristic.plan_rank(rank_, *this, params->weight, *domain,
-                                planning_graph);
+  if (num_ranks_ == 0) {
+    const Heuristic& heuristic = context->params->heuristic;
+    float* rank = rank_;
+    if (heuristic.size() > Heuristic::INLINE_RANKS) {
+      long_rank_ = new float[heuristic.size()];
+      NodePool::Charge(heuristic.size()*sizeof(float));
+      rank = long_rank_;
+    }
+    heuristic.plan_rank(rank, *this, context->params->weight,
+                        *context->domain, context->planning_graph);
+    rank_[0] = rank[0];
+    num_ranks_ = heuristic.size();
   }
   return rank_[0];
 }
@@ -924,10 +1783,40 @@ size_t Plan::serial_no() const {
 }
 
 
+/* Returns the summed ADD values of the open conditions of the parent
+   plan, if they are known and hold under the bindings of this plan. */
+bool Plan::parent_add_value(float& add_cost, int& add_work,
+                            const Chain<OpenCondition>*& open_conds,
+                            size_t& num_open_conds) const {
+  if (!parent_add_known_) {
+    return false;
+  }
+  add_cost = add_cost_;
+  add_work = add_work_;
+  open_conds = parent_open_conds_;
+  num_open_conds = parent_num_open_conds_;
+  return true;
+}
+
+
+/* Records the summed ADD values of the open conditions of this plan. */
+void Plan::set_add_value(float add_cost, int add_work, bool exact) const {
+  add_cost_ = add_cost;
+  add_work_ = add_work;
+  add_known_ = exact;
+  if (parent_add_known_) {
+    parent_add_known_ = false;
+    RCObject::destructive_deref(parent_open_conds_);
+    parent_open_conds_ = NULL;
+  }
+}
+
+
 /* Returns the next flaw to work on. */
 const Flaw& Plan::get_flaw(const FlawSelectionOrder& flaw_order) const {
-  const Flaw& flaw = flaw_order.select(*this, *problem, planning_graph);
-  if (!params->ground_actions) {
+  const Flaw& flaw = flaw_order.select(*this, *context->problem,
+                                       context->planning_graph);
+  if (!context->params->ground_actions) {
     const OpenCondition* open_cond = dynamic_cast<const OpenCondition*>(&flaw);
     static_pred_flaw = (open_cond != NULL && open_cond->is_static());
   }
@@ -1068,6 +1957,9 @@ int Plan::separable(const Unsafe& unsafe) const {
 /* Handles an unsafe link through separation. */
 int Plan::separate(PlanList& plans, const Unsafe& unsafe,
                    const BindingList& unifier, bool test_only) const {
+  if (plans.full()) {
+    return 0;
+  }
   const Formula* goal = &Formula::FALSE;
   for (BindingList::const_iterator si = unifier.begin();
        si != unifier.end(); si++) {
@@ -1130,13 +2022,15 @@ int Plan::separate(PlanList& plans, const Unsafe& unsafe,
     if (bindings != NULL) {
       if (!test_only) {
         const Orderings* new_orderings = orderings_;
-        if (!goal->tautology() && planning_graph != NULL) {
+        if (!goal->tautology() && context->planning_graph != NULL) {
           const TemporalOrderings* to =
             dynamic_cast<const TemporalOrderings*>(new_orderings);
           if (to != NULL) {
             HeuristicValue h, hs;
-            goal->heuristic_value(h, hs, *planning_graph, unsafe.step_id(),
-                                  params->ground_actions ? NULL : bindings);
+            goal->heuristic_value(h, hs, *context->planning_graph,
+                                  unsafe.step_id(),
+                                  context->params->ground_actions
+                                  ? NULL : bindings);
             new_orderings = to->refine(unsafe.step_id(),
                                        hs.makespan(), h.makespan());
           }
@@ -1203,6 +2097,9 @@ int Plan::promote(PlanList& plans, const Unsafe& unsafe,
 void Plan::new_ordering(PlanList& plans, size_t before_id, StepTime t1,
                         size_t after_id, StepTime t2,
                         const Unsafe& unsafe) const {
+  if (plans.full()) {
+    return;
+  }
   const Orderings* new_orderings =
     orderings().refine(Ordering(before_id, t1, after_id, t2));
   if (new_orderings != NULL) {
@@ -1257,7 +2154,7 @@ void Plan::handle_mutex_threat(PlanList& plans,
 /* Handles a mutex threat through separation. */
 void Plan::separate(PlanList& plans, const MutexThreat& mutex_threat,
                     const BindingList& unifier) const {
-  if (!unifier.empty()) {
+  if (!unifier.empty() && !plans.full()) {
     const Formula* goal = &Formula::FALSE;
     for (BindingList::const_iterator si = unifier.begin();
          si != unifier.end(); si++) {
@@ -1336,13 +2233,14 @@ void Plan::separate(PlanList& plans, const MutexThreat& mutex_threat,
         const Bindings* bindings = bindings_->add(new_bindings);
         if (bindings != NULL) {
           const Orderings* new_orderings = orderings_;
-          if (!goal->tautology() && planning_graph != NULL) {
+          if (!goal->tautology() && context->planning_graph != NULL) {
             const TemporalOrderings* to =
               dynamic_cast<const TemporalOrderings*>(new_orderings);
             if (to != NULL) {
               HeuristicValue h, hs;
-              goal->heuristic_value(h, hs, *planning_graph, step_id,
-                                    params->ground_actions ? NULL : bindings);
+              goal->heuristic_value(h, hs, *context->planning_graph, step_id,
+                                    context->params->ground_actions
+                                    ? NULL : bindings);
               new_orderings = to->refine(step_id, hs.makespan(), h.makespan());
             }
           }
@@ -1395,6 +2293,9 @@ void Plan::promote(PlanList& plans, const MutexThreat& mutex_threat) const {
 void Plan::new_ordering(PlanList& plans, size_t before_id, StepTime t1,
                         size_t after_id, StepTime t2,
                         const MutexThreat& mutex_threat) const {
+  if (plans.full()) {
+    return;
+  }
   const Orderings* new_orderings =
     orderings().refine(Ordering(before_id, t1, after_id, t2));
   if (new_orderings != NULL) {
@@ -1495,7 +2396,7 @@ void Plan::handle_open_condition(PlanList& plans,
     }
     const Negation* negation = dynamic_cast<const Negation*>(literal);
     if (negation != NULL) {
-      new_cw_link(plans, problem->init_action().effects(),
+      new_cw_link(plans, context->problem->init_action().effects(),
                   *negation, open_cond);
     }
   } else {
@@ -1521,7 +2422,7 @@ int Plan::handle_disjunction(PlanList& plans, const Disjunction& disj,
   int count = 0;
   const FormulaList& disjuncts = disj.disjuncts();
   for (FormulaList::const_iterator fi = disjuncts.begin();
-       fi != disjuncts.end(); fi++) {
+       fi != disjuncts.end() && !plans.full(); fi++) {
     BindingList new_bindings;
     const Chain<OpenCondition>* new_open_conds =
       test_only ? NULL : open_conds()->remove(open_cond);
@@ -1560,9 +2461,9 @@ int Plan::handle_inequality(PlanList& plans, const Inequality& neq,
   size_t step_id = open_cond.step_id();
   Variable variable2 = neq.term().as_variable();
   const NameSet& d1 = bindings_->domain(neq.variable(), neq.step_id1(step_id),
-                                        *problem);
+                                        *context->problem);
   const NameSet& d2 = bindings_->domain(variable2, neq.step_id2(step_id),
-                                        *problem);
+                                        *context->problem);
 
   /*
    * Branch on the variable with the smallest domain.
@@ -1575,7 +2476,7 @@ int Plan::handle_inequality(PlanList& plans, const Inequality& neq,
     (d1.size() < d2.size()) ? neq.step_id2(step_id) : neq.step_id1(step_id);
   const NameSet& var_domain = (d1.size() < d2.size()) ? d1 : d2;
   for (NameSet::const_iterator ni = var_domain.begin();
-       ni != var_domain.end(); ni++) {
+       ni != var_domain.end() && !plans.full(); ni++) {
     Object name = *ni;
     BindingList new_bindings;
     new_bindings.push_back(Binding(var1, id1, name, 0, true));
@@ -1593,7 +2494,7 @@ int Plan::handle_inequality(PlanList& plans, const Inequality& neq,
       count++;
     }
   }
-  if (planning_graph == NULL) {
+  if (context->planning_graph == NULL) {
     delete &d1;
     delete &d2;
   }
@@ -1633,7 +2534,7 @@ void Plan::add_step(PlanList& plans, const Literal& literal,
                     const OpenCondition& open_cond,
                     const ActionEffectMap& achievers) const {
   for (ActionEffectMap::const_iterator ai = achievers.begin();
-       ai != achievers.end(); ai++) {
+       ai != achievers.end() && !plans.full(); ai++) {
     const Action& action = *(*ai).first;
     if (action.name().substr(0, 1) != "<") {
       const Effect& effect = *(*ai).second;
@@ -1678,7 +2579,7 @@ bool Plan::reusable_steps(int& refinements, const Literal& literal,
   }
   const Negation* negation = dynamic_cast<const Negation*>(&literal);
   if (negation != NULL) {
-    count += new_cw_link(dummy, problem->init_action().effects(),
+    count += new_cw_link(dummy, context->problem->init_action().effects(),
                          *negation, open_cond, true);
   }
   refinements = count;
@@ -1691,7 +2592,8 @@ void Plan::reuse_step(PlanList& plans, const Literal& literal,
                       const OpenCondition& open_cond,
                       const ActionEffectMap& achievers) const {
   StepTime gt = start_time(open_cond.when());
-  for (const Chain<Step>* sc = steps(); sc != NULL; sc = sc->tail) {
+  for (const Chain<Step>* sc = steps(); sc != NULL && !plans.full();
+       sc = sc->tail) {
     const Step& step = sc->head;
     if (orderings().possibly_before(step.id(), StepTime::AT_START,
                                     open_cond.step_id(), gt)) {
@@ -1699,7 +2601,7 @@ void Plan::reuse_step(PlanList& plans, const Literal& literal,
         ActionEffectMap::const_iterator> b =
         achievers.equal_range(&step.action());
       for (ActionEffectMap::const_iterator ei = b.first;
-           ei != b.second; ei++) {
+           ei != b.second && !plans.full(); ei++) {
         const Effect& effect = *(*ei).second;
         StepTime et = end_time(effect);
         if (orderings().possibly_before(step.id(), et,
@@ -1733,6 +2635,9 @@ int Plan::new_link(PlanList& plans, const Step& step, const Effect& effect,
 int Plan::new_cw_link(PlanList& plans, const EffectList& effects,
                       const Negation& negation, const OpenCondition& open_cond,
                       bool test_only) const {
+  if (plans.full()) {
+    return 0;
+  }
   const Atom& goal = negation.atom();
   const Formula* goals = &Formula::TRUE;
   for (EffectList::const_iterator ei = effects.begin();
@@ -1875,8 +2780,9 @@ int Plan::make_link(PlanList& plans, const Step& step, const Effect& effect,
       }
       return 0;
     }
-    if (params->domain_constraints) {
-      bindings = bindings->add(step.id(), step.action(), *planning_graph);
+    if (context->params->domain_constraints) {
+      bindings = bindings->add(step.id(), step.action(),
+                               *context->planning_graph);
       if (bindings == NULL) {
         if (!test_only) {
           RCObject::ref(new_open_conds);
@@ -1909,16 +2815,17 @@ int Plan::make_link(PlanList& plans, const Step& step, const Effect& effect,
     StepTime gt = start_time(open_cond.when());
     const Orderings* new_orderings =
       orderings().refine(Ordering(step.id(), et, open_cond.step_id(), gt),
-                         step, planning_graph,
-                         params->ground_actions ? NULL : bindings);
+                         step, context->planning_graph,
+                         context->params->ground_actions ? NULL : bindings);
     if (new_orderings != NULL && !cond_goal->tautology()
-        && planning_graph != NULL) {
+        && context->planning_graph != NULL) {
       const TemporalOrderings* to =
         dynamic_cast<const TemporalOrderings*>(new_orderings);
       if (to != NULL) {
         HeuristicValue h, hs;
-        cond_goal->heuristic_value(h, hs, *planning_graph, step.id(),
-                                   params->ground_actions ? NULL : bindings);
+        cond_goal->heuristic_value(h, hs, *context->planning_graph, step.id(),
+                                   context->params->ground_actions
+                                   ? NULL : bindings);
         const Orderings* tmp_orderings = to->refine(step.id(), hs.makespan(),
                                                     h.makespan());
         if (tmp_orderings != new_orderings) {
@@ -1975,8 +2882,8 @@ int Plan::make_link(PlanList& plans, const Step& step, const Effect& effect,
 /* Less than operator for plans. */
 bool operator<(const Plan& p1, const Plan& p2) {
   float diff = p1.primary_rank() - p2.primary_rank();
-  for (size_t i = 1; i < p1.rank_.size() && diff == 0.0; i++) {
-    diff = p1.rank_[i] - p2.rank_[i];
+  for (size_t i = 1; i < p1.num_ranks_ && diff == 0.0; i++) {
+    diff = p1.rank(i) - p2.rank(i);
   }
   return diff > 0.0;
 }
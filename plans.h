@@ -22,9 +22,13 @@
 #ifndef PLANS_H
 #define PLANS_H
 
+#include <functional>
+
 #include "chain.h"
 #include "flaws.h"
+#include "heuristics.h"
 #include "orderings.h"
+#include "src/node-pool.h"
 
 struct Parameters;
 struct BindingList;
@@ -38,6 +42,7 @@ struct Problem;
 struct Bindings;
 struct ActionEffectMap;
 struct FlawSelectionOrder;
+struct SearchState;
 
 
 /* ====================================================================== */
@@ -123,19 +128,31 @@ private:
 /* Plan */
 
 /*
- * Plan.
+ * Plan.  Plans are allocated from the node pool.
  */
-struct Plan {
+struct Plan : public PooledObject {
   /* Id of goal step. */
   static const size_t GOAL_ID;
 
-  /* Returns plan for given problem. */
+  /* Function that receives the plans found in anytime mode. */
+  typedef std::function<void(const Plan&)> PlanCallback;
+
+  /* Returns plan for given problem.  In anytime mode, the search goes
+     on after the first complete plan is found, and each complete plan
+     with a shorter makespan than the plans before it is passed to the
+     given function as soon as it is found. */
   static const Plan* plan(const Problem& problem, const Parameters& params,
-                          bool last_problem);
+                          bool last_problem,
+                          const PlanCallback& improved_plan = PlanCallback());
 
-  /* Cleans up after planning. */
+  /* Cleans up after planning on this thread, and gives back the
+     memory for the chains and plans of the last problem. */
   static void cleanup();
 
+  /* Discards the achievers cached for the domain of the last problem.
+     Must be called when a domain is redefined or deleted. */
+  static void clear_domain_cache();
+
   /* Deletes this plan. */
   ~Plan();
 
@@ -179,9 +196,33 @@ struct Plan {
      signifies a better plan. */
   float primary_rank() const;
 
+  /* Returns the primary rank of this plan if it has been computed,
+     and otherwise the primary rank it is estimated to have. */
+  float estimated_rank() const { return rank_[0]; }
+
   /* Returns the serial number of this plan. */
   size_t serial_no() const;
 
+  /* Returns true, and sets the given values to the summed ADD cost
+     and work of the open conditions of the plan that this plan was
+     refined from and to those open conditions, if the sums are known
+     and still hold under the bindings of this plan. */
+  bool parent_add_value(float& add_cost, int& add_work,
+                        const Chain<OpenCondition>*& open_conds,
+                        size_t& num_open_conds) const;
+
+  /* Records the summed ADD cost and work of the open conditions of
+     this plan.  The plans refined from this plan compute their sums
+     from these if they are exact. */
+  void set_add_value(float add_cost, int add_work, bool exact) const;
+
+  /* Appends to the given key the steps, causal links, flaws,
+     ordering constraints and binding constraints of this plan, with
+     the steps renamed in a canonical order.  Plans with the same key
+     are the same up to the naming of their steps, regardless of the
+     order in which their components were added. */
+  void key(std::vector<uint64_t>& key) const;
+
 #ifdef DEBUG
   /* Returns the depth of this plan. */
   size_t depth() const { return depth_; }
@@ -219,10 +260,42 @@ struct Plan {
                       const OpenCondition& open_cond, int limit) const;
 
 private:
-  /* List of plans. */
+  /* List of plans.  A list can pass each plan to a filter as soon as
+     the plan is generated, and refinements stop adding plans to a list
+     once it is full, so children that would be discarded are never
+     built. */
   struct PlanList : public std::vector<const Plan*> {
+    /* Function that is given each plan added to a list, and returns
+       true if the list should keep the plan.  A plan that is not kept
+       belongs to the filter. */
+    typedef std::function<bool(const Plan*)> Filter;
+
+    /* Constructs a list that keeps every plan and is never full. */
+    PlanList();
+
+    /* Constructs a list that keeps the plans accepted by the given
+       filter, and is full once it holds the given number of plans. */
+    PlanList(size_t capacity, const Filter& filter);
+
+    /* Checks if no more plans should be added to this list. */
+    bool full() const { return size() >= capacity_; }
+
+    /* Adds a plan to this list, unless the filter rejects it. */
+    void push_back(const Plan* plan);
+
+  private:
+    /* Number of plans this list can hold. */
+    size_t capacity_;
+    /* Filter for the plans added to this list, or empty if every plan
+       is kept. */
+    Filter filter_;
   };
 
+  /* Returns the given value in the rank of this plan. */
+  float rank(size_t i) const {
+    return (long_rank_ != NULL) ? long_rank_[i] : rank_[i];
+  }
+
   /* Chain of steps. */
   const Chain<Step>* steps_;
   /* Number of unique steps in plan. */
@@ -245,10 +318,33 @@ private:
   const size_t num_open_conds_;
   /* Chain of mutex threats. */
   const Chain<MutexThreat>* mutex_threats_;
-  /* Rank of this plan. */
-  mutable std::vector<float> rank_;
+  /* Rank of this plan.  With deferred evaluation, the first value is
+     an estimate until the rank has been computed. */
+  mutable float rank_[Heuristic::INLINE_RANKS];
+  /* All values in the rank of this plan if there are more than fit
+     inline, or NULL. */
+  mutable float* long_rank_;
+  /* Number of values in the rank of this plan, or 0 if the rank has
+     not been computed yet. */
+  mutable unsigned char num_ranks_;
   /* Plan id (serial number). */
   mutable size_t id_;
+  /* Summed ADD cost and work of the open conditions of this plan, or
+     of the parent plan while parent_add_known_ is true. */
+  mutable float add_cost_;
+  mutable int add_work_;
+  /* Whether the summed ADD cost and work of this plan are known
+     exactly. */
+  mutable bool add_known_;
+  /* Whether the summed ADD cost and work of the parent plan are
+     known exactly and hold under the bindings of this plan, until
+     the rank of this plan has been computed. */
+  mutable bool parent_add_known_;
+  /* Open conditions of the parent plan, held while parent_add_known_
+     is true. */
+  mutable const Chain<OpenCondition>* parent_open_conds_;
+  /* Number of open conditions of the parent plan. */
+  size_t parent_num_open_conds_;
 #ifdef DEBUG
   /* Depth of this plan in the search space. */
   size_t depth_;
@@ -258,6 +354,13 @@ private:
      if goals of problem are inconsistent. */
   static const Plan* make_initial_plan(const Problem& problem);
 
+  /* Searches for a complete plan starting from the given initial plan,
+     switching between the given flaw selection orders. */
+  static const Plan* search(const Plan* initial_plan,
+                            const std::vector<FlawSelectionOrder>& flaw_orders,
+                            const std::vector<size_t>& search_limits,
+                            SearchState& state, bool last_problem);
+
   /* Constructs a plan. */
   Plan(const Chain<Step>* steps, size_t num_steps,
        const Chain<Link>* links, size_t num_links,
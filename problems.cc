@@ -65,6 +65,17 @@ void Problem::clear() {
 }
 
 
+/* Adds the given problem to the table of problems, replacing any
+   problem with the same name. */
+void Problem::add(const Problem* problem) {
+  const Problem* p = find(problem->name());
+  if (p != NULL && p != problem) {
+    delete p;
+  }
+  problems[problem->name()] = problem;
+}
+
+
 /* Constructs a problem. */
 Problem::Problem(const std::string& name, const Domain& domain)
   : name_(name), domain_(&domain), terms_(TermTable(domain.terms())),
@@ -72,22 +83,20 @@ Problem::Problem(const std::string& name, const Domain& domain)
     metric_(new Value(0)), durative_(false) {
   Formula::register_use(goal_);
   RCObject::ref(metric_);
-  const Problem* p = find(name);
-  if (p != NULL) {
-    delete p;
-  }
   for (const auto&[action_name, action] : domain.actions()) {
     if (action->durative()) {
       durative_ = true;
     }
   }
-  problems[name] = this;
 }
 
 
 /* Deletes a problem. */
 Problem::~Problem() {
-  problems.erase(name());
+  ProblemMap::iterator pi = problems.find(name());
+  if (pi != problems.end() && (*pi).second == this) {
+    problems.erase(pi);
+  }
   for (ValueMap::const_iterator vi = init_values_.begin();
        vi != init_values_.end(); vi++) {
     RCObject::destructive_deref((*vi).first);
@@ -103,7 +112,7 @@ Problem::~Problem() {
 
 /* Adds an atomic formula to the initial conditions of this problem. */
 void Problem::add_init_atom(const Atom& atom) {
-  init_atoms_.insert(&atom);
+  init_atoms_.insert(init_atoms_.end(), &atom);
   init_action_.add_effect(*new Effect(atom, Effect::AT_END));
 }
 
@@ -186,13 +195,14 @@ bool Problem::constant_metric() const {
 
 
 /* Fills the provided action list with ground actions instantiated
-   from the action schemas of the domain. */
-void Problem::instantiated_actions(
-    std::vector<const GroundAction*>& actions) const {
+   from the action schemas of the domain, using the threads of the
+   given pool if it is not null. */
+void Problem::instantiated_actions(std::vector<const GroundAction*>& actions,
+                                   WorkerPool* pool) const {
   for (std::map<std::string, const ActionSchema*>::const_iterator ai =
            domain().actions().begin();
        ai != domain().actions().end(); ai++) {
-    (*ai).second->instantiations(actions, *this);
+    (*ai).second->instantiations(actions, *this, pool);
   }
 }
 
@@ -62,7 +62,12 @@ struct Problem {
   /* Removes all defined problems. */
   static void clear();
 
-  /* Constructs a problem. */
+  /* Adds the given problem to the table of problems, replacing any
+     problem with the same name. */
+  static void add(const Problem* problem);
+
+  /* Constructs a problem.  The problem is not defined until it is
+     added to the table of problems. */
   Problem(const std::string& name, const Domain& domain);
 
   /* Deletes a problem. */
@@ -117,8 +122,10 @@ struct Problem {
   bool constant_metric() const;
 
   /* Fills the provided action list with ground actions instantiated
-     from the action schemas of the domain. */
-  void instantiated_actions(std::vector<const GroundAction*>& actions) const;
+     from the action schemas of the domain, using the threads of the
+     given pool if it is not null. */
+  void instantiated_actions(std::vector<const GroundAction*>& actions,
+                            WorkerPool* pool) const;
 
   // Whether this problem is durative.
   bool durative() const { return durative_; }
@@ -22,20 +22,23 @@
 #ifndef REFCOUNT_H_
 #define REFCOUNT_H_
 
-// An object with a reference counter.
+#include <atomic>
+
+// An object with a reference counter.  The counter is atomic so that objects
+// can be shared between search threads.
 class RCObject {
  public:
   // Increases the reference count for the given object.
   static void ref(const RCObject* o) {
     if (o != 0) {
-      o->ref_count_++;
+      o->ref_count_.fetch_add(1, std::memory_order_relaxed);
     }
   }
 
   // Decreases the reference count for the given object.
   static void deref(const RCObject* o) {
     if (o != 0) {
-      o->ref_count_--;
+      o->ref_count_.fetch_sub(1, std::memory_order_relaxed);
     }
   }
 
@@ -43,8 +46,7 @@ class RCObject {
   // reference count becomes zero.
   static void destructive_deref(const RCObject* o) {
     if (o != 0) {
-      o->ref_count_--;
-      if (o->ref_count_ == 0) {
+      if (o->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
         delete o;
       }
     }
@@ -60,9 +62,14 @@ class RCObject {
   // Copy constructor.
   RCObject(const RCObject& o) : ref_count_(0) {}
 
+  // Returns the reference count for this object.
+  unsigned long ref_count() const {
+    return ref_count_.load(std::memory_order_acquire);
+  }
+
  private:
   // Reference counter.
-  mutable unsigned long ref_count_;
+  mutable std::atomic<unsigned long> ref_count_;
 };
 
 #endif  // REFCOUNT_H_
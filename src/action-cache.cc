@@ -0,0 +1,173 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+#include "action-cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+// Marks the start of every action cache file.
+constexpr char kMagic[8] = {'V', 'H', 'P', 'O', 'P', 'A', 'C', '\0'};
+
+// Appends the given value to the given buffer in little-endian byte order, so
+// that files can be shared between machines.
+void PutInt(uint64_t value, int bytes, std::string* buffer) {
+  for (int i = 0; i < bytes; ++i) {
+    buffer->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+void PutString(const std::string& s, std::string* buffer) {
+  PutInt(s.size(), 4, buffer);
+  buffer->append(s);
+}
+
+// Reads values from the contents of an action cache file, failing once the
+// end of the contents is passed.
+class Reader {
+ public:
+  explicit Reader(const std::string& data) : data_(data), pos_(0) {}
+
+  bool GetInt(int bytes, uint64_t* value) {
+    if (data_.size() - pos_ < size_t(bytes)) {
+      return false;
+    }
+    *value = 0;
+    for (int i = 0; i < bytes; ++i) {
+      *value |= uint64_t(static_cast<unsigned char>(data_[pos_++])) << (8 * i);
+    }
+    return true;
+  }
+
+  bool GetString(std::string* s) {
+    uint64_t size;
+    if (!GetInt(4, &size) || data_.size() - pos_ < size) {
+      return false;
+    }
+    s->assign(data_, pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+  bool GetMagic() {
+    if (data_.compare(0, sizeof kMagic, kMagic, sizeof kMagic) != 0) {
+      return false;
+    }
+    pos_ += sizeof kMagic;
+    return true;
+  }
+
+  bool AtEnd() const { return pos_ == data_.size(); }
+
+ private:
+  const std::string& data_;
+  size_t pos_;
+};
+
+}  // namespace
+
+std::string ActionCacheFile(const std::string& directory, uint64_t key) {
+  char name[32];
+  snprintf(name, sizeof name, "%016llx.vhpc",
+           static_cast<unsigned long long>(key));
+  if (directory.empty() || directory.back() == '/') {
+    return directory + name;
+  }
+  return directory + '/' + name;
+}
+
+bool ReadActionCache(const std::string& filename, uint64_t key,
+                     std::vector<CachedAction>* actions) {
+  actions->clear();
+  std::ifstream in(filename, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  const std::string data((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+  Reader reader(data);
+  uint64_t version, file_key, num_actions;
+  if (!reader.GetMagic() || !reader.GetInt(4, &version) ||
+      version != kActionCacheVersion || !reader.GetInt(8, &file_key) ||
+      file_key != key || !reader.GetInt(4, &num_actions)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < num_actions; ++i) {
+    CachedAction action;
+    uint64_t num_arguments;
+    if (!reader.GetString(&action.schema) ||
+        !reader.GetInt(4, &num_arguments)) {
+      actions->clear();
+      return false;
+    }
+    action.arguments.resize(num_arguments);
+    for (std::string& argument : action.arguments) {
+      if (!reader.GetString(&argument)) {
+        actions->clear();
+        return false;
+      }
+    }
+    actions->push_back(std::move(action));
+  }
+  if (!reader.AtEnd()) {
+    actions->clear();
+    return false;
+  }
+  return true;
+}
+
+bool WriteActionCache(const std::string& filename, uint64_t key,
+                      const std::vector<CachedAction>& actions) {
+  std::string data(kMagic, sizeof kMagic);
+  PutInt(kActionCacheVersion, 4, &data);
+  PutInt(key, 8, &data);
+  PutInt(actions.size(), 4, &data);
+  for (const CachedAction& action : actions) {
+    PutString(action.schema, &data);
+    PutInt(action.arguments.size(), 4, &data);
+    for (const std::string& argument : action.arguments) {
+      PutString(argument, &data);
+    }
+  }
+  // Write to a fresh file next to the destination and rename it, so that
+  // concurrent readers and writers of the same file never interfere.
+  std::string tmp_name = filename + ".XXXXXX";
+  const int fd = mkstemp(&tmp_name[0]);
+  if (fd == -1) {
+    return false;
+  }
+  FILE* out = fdopen(fd, "wb");
+  if (out == nullptr) {
+    close(fd);
+    unlink(tmp_name.c_str());
+    return false;
+  }
+  const bool written = fwrite(data.data(), 1, data.size(), out) == data.size();
+  if (fclose(out) != 0 || !written ||
+      rename(tmp_name.c_str(), filename.c_str()) != 0) {
+    unlink(tmp_name.c_str());
+    return false;
+  }
+  return true;
+}
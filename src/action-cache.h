@@ -0,0 +1,57 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//
+// Files recording the ground actions of a planning problem between runs.
+
+#ifndef ACTION_CACHE_H_
+#define ACTION_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A ground action, identified by the name of its action schema and the names
+// of the objects bound to the parameters of the schema.
+struct CachedAction {
+  std::string schema;
+  std::vector<std::string> arguments;
+};
+
+// Version of the action cache file format.  Files written with a different
+// version are ignored.  Version 2 derives keys from the 64-bit FNV-1a hash of
+// the source files instead of std::hash, whose values differ between builds.
+constexpr uint32_t kActionCacheVersion = 2;
+
+// Returns the name of the file in the given directory that holds the actions
+// stored under the given key.
+std::string ActionCacheFile(const std::string& directory, uint64_t key);
+
+// Reads the actions stored in the given file, replacing the contents of
+// actions.  Returns false, leaving actions empty, if the file cannot be read,
+// was written with a different format version or key, or is truncated.
+bool ReadActionCache(const std::string& filename, uint64_t key,
+                     std::vector<CachedAction>* actions);
+
+// Writes the given actions to the given file under the given key.  The file is
+// replaced atomically, so readers never see a partially written file.  Returns
+// false if the file cannot be written.
+bool WriteActionCache(const std::string& filename, uint64_t key,
+                      const std::vector<CachedAction>& actions);
+
+#endif  // ACTION_CACHE_H_
@@ -0,0 +1,131 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+// Tests for action cache files.
+
+#include "action-cache.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class ActionCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    char dir[] = "/tmp/action-cache_testXXXXXX";
+    ASSERT_TRUE(mkdtemp(dir) != nullptr);
+    directory_ = dir;
+  }
+
+  void TearDown() override {
+    unlink(ActionCacheFile(directory_, 17).c_str());
+    rmdir(directory_.c_str());
+  }
+
+  std::string directory_;
+};
+
+std::vector<CachedAction> SomeActions() {
+  std::vector<CachedAction> actions(3);
+  actions[0].schema = "stack";
+  actions[0].arguments = {"a", "b"};
+  actions[1].schema = "noop";
+  actions[2].schema = "pick-up";
+  actions[2].arguments = {""};
+  return actions;
+}
+
+TEST(ActionCacheFileTest, NamesFileAfterKey) {
+  EXPECT_EQ("cache/00000000000000ff.vhpc", ActionCacheFile("cache", 255));
+  EXPECT_EQ("cache/00000000000000ff.vhpc", ActionCacheFile("cache/", 255));
+}
+
+TEST_F(ActionCacheTest, ReadsWrittenActions) {
+  const std::string filename = ActionCacheFile(directory_, 17);
+  ASSERT_TRUE(WriteActionCache(filename, 17, SomeActions()));
+  std::vector<CachedAction> actions;
+  ASSERT_TRUE(ReadActionCache(filename, 17, &actions));
+  const std::vector<CachedAction> expected = SomeActions();
+  ASSERT_EQ(expected.size(), actions.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i].schema, actions[i].schema);
+    EXPECT_EQ(expected[i].arguments, actions[i].arguments);
+  }
+}
+
+TEST_F(ActionCacheTest, ReadsEmptyActionList) {
+  const std::string filename = ActionCacheFile(directory_, 17);
+  ASSERT_TRUE(WriteActionCache(filename, 17, std::vector<CachedAction>()));
+  std::vector<CachedAction> actions = SomeActions();
+  EXPECT_TRUE(ReadActionCache(filename, 17, &actions));
+  EXPECT_TRUE(actions.empty());
+}
+
+TEST_F(ActionCacheTest, RejectsMissingFile) {
+  std::vector<CachedAction> actions = SomeActions();
+  EXPECT_FALSE(ReadActionCache(ActionCacheFile(directory_, 17), 17, &actions));
+  EXPECT_TRUE(actions.empty());
+}
+
+TEST_F(ActionCacheTest, RejectsOtherKey) {
+  const std::string filename = ActionCacheFile(directory_, 17);
+  ASSERT_TRUE(WriteActionCache(filename, 17, SomeActions()));
+  std::vector<CachedAction> actions;
+  EXPECT_FALSE(ReadActionCache(filename, 18, &actions));
+  EXPECT_TRUE(actions.empty());
+}
+
+TEST_F(ActionCacheTest, RejectsTruncatedFile) {
+  const std::string filename = ActionCacheFile(directory_, 17);
+  ASSERT_TRUE(WriteActionCache(filename, 17, SomeActions()));
+  std::string data;
+  {
+    std::ifstream in(filename, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>());
+  }
+  for (size_t size = 0; size < data.size(); ++size) {
+    {
+      std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+      out.write(data.data(), size);
+    }
+    std::vector<CachedAction> actions;
+    EXPECT_FALSE(ReadActionCache(filename, 17, &actions)) << "size " << size;
+    EXPECT_TRUE(actions.empty()) << "size " << size;
+  }
+}
+
+TEST_F(ActionCacheTest, RejectsTrailingData) {
+  const std::string filename = ActionCacheFile(directory_, 17);
+  ASSERT_TRUE(WriteActionCache(filename, 17, SomeActions()));
+  {
+    std::ofstream out(filename, std::ios::binary | std::ios::app);
+    out << "x";
+  }
+  std::vector<CachedAction> actions;
+  EXPECT_FALSE(ReadActionCache(filename, 17, &actions));
+}
+
+}  // namespace
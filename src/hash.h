@@ -0,0 +1,51 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//
+// Hash functions for building structural hashes of composite values.
+
+#ifndef HASH_H_
+#define HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Returns the given hash with the given value mixed in.  The result depends
+// on the order in which values are mixed in.
+inline uint64_t HashCombine(uint64_t hash, uint64_t value) {
+  // Finalizer of the SplitMix64 generator, applied to the combined value.
+  uint64_t z = hash ^ (value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2));
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+// Returns the 64-bit FNV-1a hash of the given bytes.  Unlike std::hash, the
+// result is the same for every build and platform, so it can name data that
+// is stored on disk.
+inline uint64_t Fnv1a64(std::string_view bytes) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (char c : bytes) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+#endif  // HASH_H_
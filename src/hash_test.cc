@@ -0,0 +1,46 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//
+// Tests for hash functions.
+
+#include "hash.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(HashTest, HashCombineDependsOnOrder) {
+  EXPECT_EQ(HashCombine(HashCombine(0, 1), 2),
+            HashCombine(HashCombine(0, 1), 2));
+  EXPECT_NE(HashCombine(HashCombine(0, 1), 2),
+            HashCombine(HashCombine(0, 2), 1));
+}
+
+TEST(HashTest, HashCombineDependsOnSeed) {
+  EXPECT_NE(HashCombine(0, 1), HashCombine(1, 1));
+  EXPECT_NE(0u, HashCombine(0, 0));
+}
+
+TEST(HashTest, Fnv1a64MatchesReferenceValues) {
+  EXPECT_EQ(0xcbf29ce484222325u, Fnv1a64(""));
+  EXPECT_EQ(0xaf63dc4c8601ec8cu, Fnv1a64("a"));
+  EXPECT_EQ(0x85944171f73967e8u, Fnv1a64("foobar"));
+}
+
+}  // namespace
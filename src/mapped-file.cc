@@ -0,0 +1,108 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+#include "mapped-file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace {
+
+// Returns zeroed, writable memory of the given size, or null on failure.
+char* MapAnonymous(size_t size) {
+  void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return p == MAP_FAILED ? nullptr : static_cast<char*>(p);
+}
+
+// Reads all remaining input from the given file descriptor.  Returns false,
+// with errno set, on failure.
+bool ReadAll(int fd, std::string* contents) {
+  char buffer[65536];
+  for (;;) {
+    const ssize_t n = read(fd, buffer, sizeof buffer);
+    if (n == 0) {
+      return true;
+    } else if (n > 0) {
+      contents->append(buffer, n);
+    } else if (errno != EINTR) {
+      return false;
+    }
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<MappedFile> MappedFile::Open(const std::string& name) {
+  const int fd = open(name.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    const int error = errno;
+    close(fd);
+    errno = error;
+    return nullptr;
+  }
+  char* data = nullptr;
+  size_t size = 0;
+  size_t mapped_size = 0;
+  if (S_ISREG(st.st_mode)) {
+    // Reserve zeroed memory for the file and the padding, and map the file
+    // over its start.  The end of the last page of the file reads as zeros,
+    // as does the reserved memory after it.
+    size = st.st_size;
+    mapped_size = size + kPadding;
+    data = MapAnonymous(mapped_size);
+    if (data != nullptr && size > 0 &&
+        mmap(data, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd,
+             0) == MAP_FAILED) {
+      const int error = errno;
+      munmap(data, mapped_size);
+      errno = error;
+      data = nullptr;
+    }
+  } else {
+    // Pipes and other special files cannot be mapped, so their contents are
+    // copied instead.
+    std::string contents;
+    if (ReadAll(fd, &contents)) {
+      size = contents.size();
+      mapped_size = size + kPadding;
+      data = MapAnonymous(mapped_size);
+      if (data != nullptr) {
+        memcpy(data, contents.data(), size);
+      }
+    }
+  }
+  const int error = errno;
+  close(fd);
+  if (data == nullptr) {
+    errno = error;
+    return nullptr;
+  }
+  return std::unique_ptr<MappedFile>(new MappedFile(data, size, mapped_size));
+}
+
+MappedFile::~MappedFile() { munmap(data_, mapped_size_); }
@@ -0,0 +1,61 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//
+// Files mapped into memory for scanning in place.
+
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// The contents of a file mapped into memory, followed by kPadding zero bytes,
+// as a scanner generated by flex requires of buffers that it scans in place.
+// The mapping is private, so writes to it never reach the file.
+class MappedFile {
+ public:
+  // Number of zero bytes following the contents of the file.
+  static constexpr size_t kPadding = 2;
+
+  // Maps the file with the given name.  Returns null, with errno set, if the
+  // file cannot be opened or mapped.
+  static std::unique_ptr<MappedFile> Open(const std::string& name);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // The contents of the file.
+  char* data() const { return data_; }
+
+  // The size of the file, not counting the padding.
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile(char* data, size_t size, size_t mapped_size)
+      : data_(data), size_(size), mapped_size_(mapped_size) {}
+
+  char* data_;
+  size_t size_;
+  size_t mapped_size_;
+};
+
+#endif  // MAPPED_FILE_H_
@@ -0,0 +1,115 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+// Tests for mapped files.
+
+#include "mapped-file.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class MappedFileTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/mapped-file_testXXXXXX";
+    const int fd = mkstemp(name);
+    ASSERT_NE(-1, fd);
+    close(fd);
+    filename_ = name;
+  }
+
+  void TearDown() override { unlink(filename_.c_str()); }
+
+  void WriteFile(const std::string& contents) {
+    std::ofstream out(filename_, std::ios::binary | std::ios::trunc);
+    out << contents;
+  }
+
+  // Expects the given mapped file to hold the given contents and padding.
+  void ExpectContents(const std::string& contents, const MappedFile& file) {
+    ASSERT_EQ(contents.size(), file.size());
+    EXPECT_EQ(contents, std::string(file.data(), file.size()));
+    for (size_t i = 0; i < MappedFile::kPadding; ++i) {
+      EXPECT_EQ('\0', file.data()[file.size() + i]) << "padding byte " << i;
+    }
+  }
+
+  std::string filename_;
+};
+
+TEST_F(MappedFileTest, MapsContents) {
+  WriteFile("(define (domain d))\n");
+  std::unique_ptr<MappedFile> file = MappedFile::Open(filename_);
+  ASSERT_TRUE(file != nullptr);
+  ExpectContents("(define (domain d))\n", *file);
+}
+
+TEST_F(MappedFileTest, MapsEmptyFile) {
+  std::unique_ptr<MappedFile> file = MappedFile::Open(filename_);
+  ASSERT_TRUE(file != nullptr);
+  ExpectContents("", *file);
+}
+
+TEST_F(MappedFileTest, PadsFileFillingWholePages) {
+  const std::string contents(2 * sysconf(_SC_PAGESIZE), 'x');
+  WriteFile(contents);
+  std::unique_ptr<MappedFile> file = MappedFile::Open(filename_);
+  ASSERT_TRUE(file != nullptr);
+  ExpectContents(contents, *file);
+}
+
+TEST_F(MappedFileTest, WritesStayPrivate) {
+  WriteFile("abc");
+  {
+    std::unique_ptr<MappedFile> file = MappedFile::Open(filename_);
+    ASSERT_TRUE(file != nullptr);
+    file->data()[1] = '\0';
+  }
+  std::unique_ptr<MappedFile> file = MappedFile::Open(filename_);
+  ASSERT_TRUE(file != nullptr);
+  ExpectContents("abc", *file);
+}
+
+TEST_F(MappedFileTest, ReadsPipe) {
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  ASSERT_EQ(3, write(fds[1], "abc", 3));
+  close(fds[1]);
+  std::unique_ptr<MappedFile> file =
+      MappedFile::Open("/dev/fd/" + std::to_string(fds[0]));
+  close(fds[0]);
+  ASSERT_TRUE(file != nullptr);
+  ExpectContents("abc", *file);
+}
+
+TEST_F(MappedFileTest, FailsOnMissingFile) {
+  unlink(filename_.c_str());
+  errno = 0;
+  EXPECT_TRUE(MappedFile::Open(filename_) == nullptr);
+  EXPECT_EQ(ENOENT, errno);
+}
+
+}  // namespace
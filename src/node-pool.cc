@@ -0,0 +1,344 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+#include "node-pool.h"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Alignment and granularity of block sizes.
+constexpr size_t kAlignment = 16;
+// Number of size classes.
+constexpr size_t kNumSizeClasses = NodePool::kMaxBlockSize / kAlignment;
+// Size of a slab.
+constexpr size_t kSlabSize = 64 * 1024;
+
+// A free block, linked through its first word.
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+// Returns the size class for a block of the given size.
+size_t SizeClass(size_t size) {
+  return (size == 0) ? 0 : (size - 1) / kAlignment;
+}
+
+// Returns the size of the blocks in the given size class.
+size_t BlockSize(size_t size_class) { return (size_class + 1) * kAlignment; }
+
+class ThreadCache;
+
+}  // namespace
+
+namespace node_pool_internal {
+
+// State of an arena, shared by the threads that allocate from it.
+struct ArenaState {
+  // Mutex protecting the fields below.
+  std::mutex mutex;
+  // All slabs allocated since the last release.
+  std::vector<char*> slabs;
+  // Unused slab space left behind by threads that have left the arena.
+  std::vector<std::pair<char*, char*>> spare_space;
+  // Free blocks left behind by threads that have left the arena.
+  FreeBlock* free_lists[kNumSizeClasses] = {};
+  // Caches of threads in the arena.
+  std::vector<ThreadCache*> caches;
+  // Blocks in use that were counted by threads that have left the arena.
+  long detached_blocks_in_use = 0;
+  // Bytes in those blocks.
+  long detached_bytes_in_use = 0;
+  // Incremented whenever the slabs are released, which invalidates the free
+  // lists of all thread caches.
+  std::atomic<unsigned long> generation{0};
+};
+
+}  // namespace node_pool_internal
+
+namespace {
+
+using node_pool_internal::ArenaState;
+
+ArenaState& shared() {
+  static ArenaState* state = new ArenaState();
+  return *state;
+}
+
+// Per-thread free lists and slab space for the arena the thread is in.
+class ThreadCache {
+ public:
+  ThreadCache() { Enter(nullptr, &shared()); }
+
+  ~ThreadCache() { Leave(); }
+
+  // Returns the arena this thread is in, or null for the shared arena.
+  NodePool::Arena* arena() const { return arena_; }
+
+  // Moves this thread to the given arena, with the given state.
+  void SetArena(NodePool::Arena* arena, ArenaState* state) {
+    if (state != state_) {
+      Leave();
+      Enter(arena, state);
+    }
+  }
+
+  void* Allocate(size_t size_class) {
+    CheckGeneration();
+    blocks_in_use_.store(blocks_in_use_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+    bytes_in_use_.store(bytes_in_use_.load(std::memory_order_relaxed) +
+                            BlockSize(size_class),
+                        std::memory_order_relaxed);
+    FreeBlock* block = free_lists_[size_class];
+    if (block == nullptr) {
+      block = Refill(size_class);
+    }
+    free_lists_[size_class] = block->next;
+    return block;
+  }
+
+  void Deallocate(void* p, size_t size_class) {
+    CheckGeneration();
+    blocks_in_use_.store(blocks_in_use_.load(std::memory_order_relaxed) - 1,
+                         std::memory_order_relaxed);
+    bytes_in_use_.store(bytes_in_use_.load(std::memory_order_relaxed) -
+                            BlockSize(size_class),
+                        std::memory_order_relaxed);
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+    block->next = free_lists_[size_class];
+    free_lists_[size_class] = block;
+  }
+
+  void Charge(long bytes) {
+    bytes_in_use_.store(bytes_in_use_.load(std::memory_order_relaxed) + bytes,
+                        std::memory_order_relaxed);
+  }
+
+  long blocks_in_use() const {
+    return blocks_in_use_.load(std::memory_order_relaxed);
+  }
+
+  long bytes_in_use() const {
+    return bytes_in_use_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Registers this cache with the given arena.
+  void Enter(NodePool::Arena* arena, ArenaState* state) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    arena_ = arena;
+    state_ = state;
+    generation_ = state->generation.load(std::memory_order_relaxed);
+    state->caches.push_back(this);
+  }
+
+  // Hands the free blocks, slab space and counts of this thread back to its
+  // arena.
+  void Leave() {
+    ArenaState& state = *state_;
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (generation_ == state.generation.load(std::memory_order_relaxed)) {
+      for (size_t c = 0; c < kNumSizeClasses; ++c) {
+        FreeBlock* list = free_lists_[c];
+        while (list != nullptr) {
+          FreeBlock* next = list->next;
+          list->next = state.free_lists[c];
+          state.free_lists[c] = list;
+          list = next;
+        }
+      }
+      if (slab_next_ != slab_end_) {
+        state.spare_space.push_back(std::make_pair(slab_next_, slab_end_));
+      }
+    }
+    for (size_t c = 0; c < kNumSizeClasses; ++c) {
+      free_lists_[c] = nullptr;
+    }
+    slab_next_ = slab_end_ = nullptr;
+    state.detached_blocks_in_use +=
+        blocks_in_use_.load(std::memory_order_relaxed);
+    state.detached_bytes_in_use +=
+        bytes_in_use_.load(std::memory_order_relaxed);
+    blocks_in_use_.store(0, std::memory_order_relaxed);
+    bytes_in_use_.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < state.caches.size(); ++i) {
+      if (state.caches[i] == this) {
+        state.caches[i] = state.caches.back();
+        state.caches.pop_back();
+        break;
+      }
+    }
+  }
+
+  // Forgets the free lists and slab space if the slabs have been released.
+  void CheckGeneration() {
+    const unsigned long generation =
+        state_->generation.load(std::memory_order_acquire);
+    if (generation != generation_) {
+      generation_ = generation;
+      for (size_t c = 0; c < kNumSizeClasses; ++c) {
+        free_lists_[c] = nullptr;
+      }
+      slab_next_ = slab_end_ = nullptr;
+    }
+  }
+
+  // Returns a non-empty free list for the given size class.
+  FreeBlock* Refill(size_t size_class) {
+    const ptrdiff_t block_size = BlockSize(size_class);
+    if (slab_end_ - slab_next_ < block_size) {
+      ArenaState& state = *state_;
+      std::lock_guard<std::mutex> lock(state.mutex);
+      if (state.free_lists[size_class] != nullptr) {
+        FreeBlock* list = state.free_lists[size_class];
+        state.free_lists[size_class] = nullptr;
+        return list;
+      }
+      if (!state.spare_space.empty() &&
+          state.spare_space.back().second - state.spare_space.back().first >=
+              block_size) {
+        slab_next_ = state.spare_space.back().first;
+        slab_end_ = state.spare_space.back().second;
+        state.spare_space.pop_back();
+      } else {
+        char* slab = static_cast<char*>(::operator new(kSlabSize));
+        state.slabs.push_back(slab);
+        slab_next_ = slab;
+        slab_end_ = slab + kSlabSize;
+      }
+    }
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(slab_next_);
+    block->next = nullptr;
+    slab_next_ += block_size;
+    return block;
+  }
+
+  // Arena this thread is in, or null for the shared arena.
+  NodePool::Arena* arena_;
+  // State of that arena.
+  ArenaState* state_;
+  // Free lists, one for each size class.
+  FreeBlock* free_lists_[kNumSizeClasses] = {};
+  // Unused space in the current slab.
+  char* slab_next_ = nullptr;
+  char* slab_end_ = nullptr;
+  // Blocks allocated minus blocks deallocated by this thread since it entered
+  // its arena.  Only written by the owning thread, but read by other threads
+  // in the same arena.
+  std::atomic<long> blocks_in_use_{0};
+  // Bytes in the blocks counted by blocks_in_use_.
+  std::atomic<long> bytes_in_use_{0};
+  // Generation of the free lists and slab space.
+  unsigned long generation_;
+};
+
+ThreadCache& thread_cache() {
+  thread_local ThreadCache cache;
+  return cache;
+}
+
+// Returns the number of blocks in use in the arena with the given state.
+long CountBlocksInUse(ArenaState& state) {
+  std::lock_guard<std::mutex> lock(state.mutex);
+  long blocks_in_use = state.detached_blocks_in_use;
+  for (const ThreadCache* cache : state.caches) {
+    blocks_in_use += cache->blocks_in_use();
+  }
+  return blocks_in_use;
+}
+
+// Returns the number of bytes in use in the arena with the given state.
+long CountBytesInUse(ArenaState& state) {
+  std::lock_guard<std::mutex> lock(state.mutex);
+  long bytes_in_use = state.detached_bytes_in_use;
+  for (const ThreadCache* cache : state.caches) {
+    bytes_in_use += cache->bytes_in_use();
+  }
+  return bytes_in_use;
+}
+
+// Frees all slabs of the arena with the given state.
+void FreeSlabs(ArenaState& state) {
+  for (char* slab : state.slabs) {
+    ::operator delete(slab);
+  }
+  state.slabs.clear();
+}
+
+}  // namespace
+
+void* NodePool::Allocate(size_t size) {
+  if (size > kMaxBlockSize) {
+    thread_cache().Charge(size);
+    return ::operator new(size);
+  }
+  return thread_cache().Allocate(SizeClass(size));
+}
+
+void NodePool::Deallocate(void* p, size_t size) {
+  if (size > kMaxBlockSize) {
+    thread_cache().Charge(-static_cast<long>(size));
+    ::operator delete(p);
+    return;
+  }
+  thread_cache().Deallocate(p, SizeClass(size));
+}
+
+void NodePool::Charge(long bytes) { thread_cache().Charge(bytes); }
+
+NodePool::Arena* NodePool::SetThreadArena(Arena* arena) {
+  ThreadCache& cache = thread_cache();
+  Arena* previous = cache.arena();
+  cache.SetArena(arena, (arena != nullptr) ? arena->state_ : &shared());
+  return previous;
+}
+
+long NodePool::BlocksInUse() { return CountBlocksInUse(shared()); }
+
+long NodePool::BytesInUse() { return CountBytesInUse(shared()); }
+
+bool NodePool::Release() {
+  if (BlocksInUse() != 0) {
+    return false;
+  }
+  ArenaState& state = shared();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  FreeSlabs(state);
+  state.spare_space.clear();
+  for (size_t c = 0; c < kNumSizeClasses; ++c) {
+    state.free_lists[c] = nullptr;
+  }
+  state.generation.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+NodePool::Arena::Arena() : state_(new ArenaState()) {}
+
+NodePool::Arena::~Arena() {
+  FreeSlabs(*state_);
+  delete state_;
+}
+
+long NodePool::Arena::BlocksInUse() const { return CountBlocksInUse(*state_); }
+
+long NodePool::Arena::BytesInUse() const { return CountBytesInUse(*state_); }
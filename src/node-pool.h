@@ -0,0 +1,120 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+// A pooled allocator for small, frequently allocated objects.
+
+#ifndef NODE_POOL_H_
+#define NODE_POOL_H_
+
+#include <cstddef>
+
+namespace node_pool_internal {
+struct ArenaState;
+}  // namespace node_pool_internal
+
+// A pooled allocator for chain nodes, plans and other small objects that are
+// allocated and freed at a high rate during search.  Blocks are carved from
+// large slabs and recycled through per-thread free lists, one for each size
+// class, so most allocations and deallocations touch no shared state.  Objects
+// larger than kMaxBlockSize are passed on to the global operator new, but
+// their bytes still count as in use.
+//
+// The slabs belong to an arena.  A thread allocates from the arena it has
+// entered with SetThreadArena, and otherwise from a shared arena that lives
+// as long as the process.
+class NodePool {
+ public:
+  class Arena;
+
+  // Size of the largest block served from the pool.
+  static constexpr size_t kMaxBlockSize = 512;
+
+  // Returns a block of at least the given size.
+  static void* Allocate(size_t size);
+
+  // Returns a block obtained from Allocate with the same size to the pool.  The
+  // calling thread must be in the arena the block was allocated from.
+  static void Deallocate(void* p, size_t size);
+
+  // Counts the given number of bytes, held outside the pool by objects that
+  // belong with the blocks of the calling thread's arena, as in use in that
+  // arena.  A negative number stops counting them, and must be given by a
+  // thread in the same arena.
+  static void Charge(long bytes);
+
+  // Makes the calling thread allocate from the given arena, or from the shared
+  // arena if arena is null, and returns the arena it allocated from before.
+  static Arena* SetThreadArena(Arena* arena);
+
+  // Frees all slabs of the shared arena at once if no blocks are in use, and
+  // returns true if it did.  Must not be called while other threads allocate
+  // from the shared arena.
+  static bool Release();
+
+  // Returns the number of blocks in use in the shared arena.  Must not be
+  // called while other threads allocate from the shared arena.
+  static long BlocksInUse();
+
+  // Returns the number of bytes in the blocks in use in the shared arena.  May
+  // be called while other threads allocate from the shared arena, in which
+  // case the result is only approximate.
+  static long BytesInUse();
+};
+
+// An arena of the node pool whose slabs are all freed when it is destroyed,
+// whether or not blocks are still in use.  This gives every block allocated
+// for one task a common lifetime.  Blocks must be returned to the pool by a
+// thread in the arena they came from, or not at all.
+class NodePool::Arena {
+ public:
+  Arena();
+
+  // Frees all slabs.  No thread may be in the arena.
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // Returns the number of blocks in use.  Must not be called while other
+  // threads allocate from the arena.
+  long BlocksInUse() const;
+
+  // Returns the number of bytes in the blocks in use.  May be called while
+  // other threads allocate from the arena, in which case the result is only
+  // approximate.
+  long BytesInUse() const;
+
+ private:
+  friend class NodePool;
+
+  node_pool_internal::ArenaState* const state_;
+};
+
+// Base class for objects allocated from the node pool.
+class PooledObject {
+ public:
+  // Allocates memory for an object from the node pool.
+  static void* operator new(size_t size) { return NodePool::Allocate(size); }
+
+  // Returns the memory for an object to the node pool.
+  static void operator delete(void* p, size_t size) {
+    NodePool::Deallocate(p, size);
+  }
+};
+
+#endif  // NODE_POOL_H_
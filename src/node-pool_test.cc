@@ -0,0 +1,206 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+// Tests for node pool.
+
+#include "node-pool.h"
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(NodePoolTest, ReturnsDistinctAlignedBlocks) {
+  std::vector<std::pair<void*, size_t>> blocks;
+  std::set<void*> addresses;
+  for (size_t size = 1; size <= 2 * NodePool::kMaxBlockSize; size += 7) {
+    void* p = NodePool::Allocate(size);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(p) % 16) << "size " << size;
+    std::memset(p, 0xab, size);
+    EXPECT_TRUE(addresses.insert(p).second) << "size " << size;
+    blocks.push_back(std::make_pair(p, size));
+  }
+  for (const auto& block : blocks) {
+    NodePool::Deallocate(block.first, block.second);
+  }
+}
+
+TEST(NodePoolTest, ReusesFreedBlocks) {
+  void* p = NodePool::Allocate(40);
+  NodePool::Deallocate(p, 40);
+  // Sizes in the same size class share free lists.
+  EXPECT_EQ(p, NodePool::Allocate(48));
+  NodePool::Deallocate(p, 48);
+}
+
+TEST(NodePoolTest, CountsBlocksInUse) {
+  const long blocks_in_use = NodePool::BlocksInUse();
+  void* p = NodePool::Allocate(24);
+  void* q = NodePool::Allocate(200);
+  EXPECT_EQ(blocks_in_use + 2, NodePool::BlocksInUse());
+  NodePool::Deallocate(p, 24);
+  NodePool::Deallocate(q, 200);
+  EXPECT_EQ(blocks_in_use, NodePool::BlocksInUse());
+}
+
+TEST(NodePoolTest, CountsBytesInUse) {
+  const long bytes_in_use = NodePool::BytesInUse();
+  void* p = NodePool::Allocate(24);
+  void* q = NodePool::Allocate(200);
+  EXPECT_EQ(bytes_in_use + 32 + 208, NodePool::BytesInUse());
+  NodePool::Deallocate(p, 24);
+  NodePool::Deallocate(q, 200);
+  EXPECT_EQ(bytes_in_use, NodePool::BytesInUse());
+}
+
+TEST(NodePoolTest, CountsChargedAndLargeBytes) {
+  NodePool::Arena arena;
+  NodePool::SetThreadArena(&arena);
+  NodePool::Charge(1000);
+  void* p = NodePool::Allocate(2 * NodePool::kMaxBlockSize);
+  EXPECT_EQ(0, arena.BlocksInUse());
+  EXPECT_EQ(static_cast<long>(1000 + 2 * NodePool::kMaxBlockSize),
+            arena.BytesInUse());
+  NodePool::Deallocate(p, 2 * NodePool::kMaxBlockSize);
+  NodePool::Charge(-1000);
+  EXPECT_EQ(0, arena.BytesInUse());
+  NodePool::SetThreadArena(nullptr);
+}
+
+TEST(NodePoolTest, ReleasesOnlyWhenNoBlocksInUse) {
+  void* p = NodePool::Allocate(64);
+  EXPECT_FALSE(NodePool::Release());
+  NodePool::Deallocate(p, 64);
+  EXPECT_TRUE(NodePool::Release());
+  // The pool is usable after a release.
+  p = NodePool::Allocate(64);
+  std::memset(p, 0, 64);
+  NodePool::Deallocate(p, 64);
+  EXPECT_TRUE(NodePool::Release());
+}
+
+TEST(NodePoolTest, FreesBlocksAcrossThreads) {
+  std::vector<void*> blocks;
+  std::thread producer([&blocks]() {
+    for (int i = 0; i < 10000; ++i) {
+      blocks.push_back(NodePool::Allocate(32));
+    }
+  });
+  producer.join();
+  for (void* p : blocks) {
+    NodePool::Deallocate(p, 32);
+  }
+  EXPECT_EQ(0, NodePool::BlocksInUse());
+  EXPECT_TRUE(NodePool::Release());
+}
+
+TEST(NodePoolTest, ArenaCountsOnlyItsOwnBlocks) {
+  const long shared_blocks_in_use = NodePool::BlocksInUse();
+  NodePool::Arena arena;
+  EXPECT_EQ(nullptr, NodePool::SetThreadArena(&arena));
+  void* p = NodePool::Allocate(24);
+  void* q = NodePool::Allocate(200);
+  EXPECT_EQ(2, arena.BlocksInUse());
+  EXPECT_EQ(32 + 208, arena.BytesInUse());
+  EXPECT_EQ(shared_blocks_in_use, NodePool::BlocksInUse());
+  NodePool::Deallocate(p, 24);
+  EXPECT_EQ(&arena, NodePool::SetThreadArena(nullptr));
+  // Blocks still count after the thread has left the arena.
+  EXPECT_EQ(1, arena.BlocksInUse());
+  EXPECT_EQ(shared_blocks_in_use, NodePool::BlocksInUse());
+  NodePool::SetThreadArena(&arena);
+  NodePool::Deallocate(q, 200);
+  EXPECT_EQ(0, arena.BlocksInUse());
+  NodePool::SetThreadArena(nullptr);
+}
+
+TEST(NodePoolTest, ReusesArenaBlocksAfterReentering) {
+  NodePool::Arena arena;
+  NodePool::SetThreadArena(&arena);
+  void* p = NodePool::Allocate(40);
+  void* q = NodePool::Allocate(40);
+  NodePool::Deallocate(p, 40);
+  NodePool::SetThreadArena(nullptr);
+  NodePool::SetThreadArena(&arena);
+  // The free block and the rest of the slab are handed back to the arena.
+  EXPECT_EQ(p, NodePool::Allocate(40));
+  void* r = NodePool::Allocate(40);
+  EXPECT_EQ(static_cast<char*>(q) + 48, r);
+  NodePool::SetThreadArena(nullptr);
+}
+
+TEST(NodePoolTest, FreesArenaWithBlocksInUse) {
+  const long shared_blocks_in_use = NodePool::BlocksInUse();
+  std::thread worker([]() {
+    for (int n = 0; n < 3; ++n) {
+      NodePool::Arena arena;
+      NodePool::SetThreadArena(&arena);
+      for (int i = 0; i < 10000; ++i) {
+        std::memset(NodePool::Allocate(64), 0, 64);
+      }
+      EXPECT_EQ(10000, arena.BlocksInUse());
+      NodePool::SetThreadArena(nullptr);
+    }
+  });
+  worker.join();
+  EXPECT_EQ(shared_blocks_in_use, NodePool::BlocksInUse());
+}
+
+TEST(NodePoolTest, SharesArenaAcrossThreads) {
+  NodePool::Arena arena;
+  std::vector<void*> blocks;
+  std::thread producer([&arena, &blocks]() {
+    NodePool::SetThreadArena(&arena);
+    for (int i = 0; i < 10000; ++i) {
+      blocks.push_back(NodePool::Allocate(32));
+    }
+  });
+  producer.join();
+  EXPECT_EQ(10000, arena.BlocksInUse());
+  NodePool::SetThreadArena(&arena);
+  for (void* p : blocks) {
+    NodePool::Deallocate(p, 32);
+  }
+  EXPECT_EQ(0, arena.BlocksInUse());
+  NodePool::SetThreadArena(nullptr);
+}
+
+struct PooledPair : public PooledObject {
+  PooledPair(int first, int second) : first(first), second(second) {}
+
+  int first;
+  int second;
+};
+
+TEST(NodePoolTest, PooledObject) {
+  const long blocks_in_use = NodePool::BlocksInUse();
+  PooledPair* pair = new PooledPair(17, 42);
+  EXPECT_EQ(blocks_in_use + 1, NodePool::BlocksInUse());
+  EXPECT_EQ(17, pair->first);
+  EXPECT_EQ(42, pair->second);
+  delete pair;
+  EXPECT_EQ(blocks_in_use, NodePool::BlocksInUse());
+}
+
+}  // namespace
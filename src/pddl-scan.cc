@@ -0,0 +1,67 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+#include "pddl-scan.h"
+
+#include <cctype>
+
+namespace {
+
+// Tests if the given character may be part of a name.
+bool IsNameChar(char c) {
+  return isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_';
+}
+
+// Tests if the given text starts with `domain', ignoring case, and the name
+// ends there.
+bool StartsWithDomain(std::string_view text) {
+  static constexpr std::string_view kDomain = "domain";
+  if (text.size() < kDomain.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < kDomain.size(); ++i) {
+    if (tolower(static_cast<unsigned char>(text[i])) != kDomain[i]) {
+      return false;
+    }
+  }
+  return text.size() == kDomain.size() || !IsNameChar(text[kDomain.size()]);
+}
+
+}  // namespace
+
+bool MayDefineDomain(std::string_view text) {
+  bool after_paren = false;
+  for (size_t i = 0; i < text.size(); ++i) {
+    const char c = text[i];
+    if (c == ';') {
+      while (i < text.size() && text[i] != '\n') {
+        ++i;
+      }
+    } else if (c == '(') {
+      after_paren = true;
+    } else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+      continue;
+    } else {
+      if (after_paren && StartsWithDomain(text.substr(i))) {
+        return true;
+      }
+      after_paren = false;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,35 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//
+// Quick scans of PDDL text that do not parse it.
+
+#ifndef PDDL_SCAN_H_
+#define PDDL_SCAN_H_
+
+#include <string_view>
+
+// Tests if the given PDDL text may define a domain, that is, if it holds the
+// name `domain' right after an opening parenthesis outside of comments.  The
+// test is conservative: it returns true for any text that defines a domain,
+// but also for some that do not, such as text with a predicate named
+// `domain'.  Text for which it returns false defines problems only, so it can
+// be parsed while other such text is parsed.
+bool MayDefineDomain(std::string_view text);
+
+#endif  // PDDL_SCAN_H_
@@ -0,0 +1,54 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+//
+// Tests for quick scans of PDDL text.
+
+#include "pddl-scan.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(MayDefineDomainTest, DomainDefinition) {
+  EXPECT_TRUE(MayDefineDomain("(define (domain blocks) (:action a))"));
+  EXPECT_TRUE(MayDefineDomain("(define\n  ( DOMAIN blocks))"));
+  EXPECT_TRUE(MayDefineDomain("(define (domain\tblocks))"));
+  EXPECT_TRUE(MayDefineDomain("(domain"));
+}
+
+TEST(MayDefineDomainTest, ProblemDefinition) {
+  EXPECT_FALSE(MayDefineDomain(
+      "(define (problem p1) (:domain blocks) (:init (on a b)))"));
+  EXPECT_FALSE(MayDefineDomain("(define (problem domain-1))"));
+  EXPECT_FALSE(MayDefineDomain("(define (problem p) (:objects domain))"));
+  EXPECT_FALSE(MayDefineDomain("(define (problem p) (:init (domains a)))"));
+  EXPECT_FALSE(MayDefineDomain(""));
+}
+
+TEST(MayDefineDomainTest, IgnoresComments) {
+  EXPECT_FALSE(MayDefineDomain("; (define (domain blocks))\n(problem p)"));
+  EXPECT_TRUE(MayDefineDomain("; comment\n(define (domain blocks))"));
+  EXPECT_TRUE(MayDefineDomain("(; comment\ndomain blocks)"));
+}
+
+TEST(MayDefineDomainTest, IsConservative) {
+  EXPECT_TRUE(MayDefineDomain("(define (problem p) (:init (domain a)))"));
+}
+
+}  // namespace
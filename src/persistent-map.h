@@ -0,0 +1,320 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+// A persistent hash map with structural sharing.
+
+#ifndef PERSISTENT_MAP_H_
+#define PERSISTENT_MAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+
+#include "node-pool.h"
+
+// A persistent map from keys to values, stored as a hash array mapped trie.
+// Copying a map takes constant time and shares all nodes with the original.
+// Setting a key copies only the nodes on the path to the key, so maps derived
+// from each other share most of their nodes, and lookups take time
+// logarithmic in the size of the map.  Nodes are allocated from the node pool
+// and are never changed while more than one map refers to them, so maps can be
+// copied and read by different threads at the same time.  Nodes that only one
+// map refers to are updated in place, so setting several keys in a row copies
+// each path only once.
+//
+// The hash function should mix all bits of its result, since the trie is
+// indexed by the hash bits from the least significant up.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class PersistentMap {
+ public:
+  // Constructs an empty map.
+  PersistentMap() : root_(nullptr), size_(0) {}
+
+  // Constructs a map sharing the nodes of the given map.
+  PersistentMap(const PersistentMap& other)
+      : root_(other.root_), size_(other.size_) {
+    Ref(root_);
+  }
+
+  // Makes this map share the nodes of the given map.
+  PersistentMap& operator=(const PersistentMap& other) {
+    Ref(other.root_);
+    Unref(root_);
+    root_ = other.root_;
+    size_ = other.size_;
+    return *this;
+  }
+
+  // Deletes this map, and the nodes no other map shares.
+  ~PersistentMap() { Unref(root_); }
+
+  // Returns true if this map is empty.
+  bool empty() const { return size_ == 0; }
+
+  // Returns the number of keys in this map.
+  size_t size() const { return size_; }
+
+  // Returns a pointer to the value for the given key, or nullptr if the key
+  // is not in this map.
+  const V* find(const K& key) const {
+    const uint64_t hash = Hash()(key);
+    const Node* node = root_;
+    for (int shift = 0; node != nullptr; shift += kBits) {
+      if (node->leaf) {
+        for (const Leaf* leaf = static_cast<const Leaf*>(node);
+             leaf != nullptr; leaf = leaf->next) {
+          if (leaf->hash == hash && leaf->key == key) {
+            return &leaf->value;
+          }
+        }
+        return nullptr;
+      }
+      const Branch* branch = static_cast<const Branch*>(node);
+      const uint32_t bit = Bit(hash, shift);
+      if ((branch->bitmap & bit) == 0) {
+        return nullptr;
+      }
+      node = branch->children()[Position(branch->bitmap, bit)];
+    }
+    return nullptr;
+  }
+
+  // Maps the given key to the given value.  Other maps sharing nodes with
+  // this map are not affected.
+  void set(const K& key, const V& value) {
+    bool added = false;
+    root_ = Insert(root_, Hash()(key), 0, key, value, &added);
+    if (added) {
+      ++size_;
+    }
+  }
+
+ private:
+  // Number of hash bits consumed at each level of the trie.
+  static constexpr int kBits = 5;
+
+  // A node of the trie, either a branch or a leaf.
+  struct Node {
+    explicit Node(bool leaf) : refs(1), leaf(leaf) {}
+
+    // Number of maps and branches referring to this node.
+    mutable std::atomic<size_t> refs;
+    // Whether this node is a leaf.
+    const bool leaf;
+  };
+
+  // A leaf holding a key and its value.  Keys with the same hash are chained
+  // through their leaves.
+  struct Leaf : Node {
+    Leaf(uint64_t hash, const K& key, const V& value, const Leaf* next)
+        : Node(true), hash(hash), key(key), value(value), next(next) {}
+
+    // Hash of the key.
+    const uint64_t hash;
+    // The key.
+    const K key;
+    // The value for the key.
+    const V value;
+    // Leaf for another key with the same hash, or nullptr.
+    const Leaf* const next;
+  };
+
+  // A branch with a child for each set bit of its bitmap.  The children are
+  // stored right after the branch, in order of their bits.
+  struct Branch : Node {
+    explicit Branch(uint32_t bitmap) : Node(false), bitmap(bitmap) {}
+
+    // Returns the number of children of this branch.
+    int size() const { return __builtin_popcount(bitmap); }
+
+    // Returns the children of this branch.
+    const Node** children() const {
+      return reinterpret_cast<const Node**>(
+          const_cast<Branch*>(this) + 1);
+    }
+
+    // Bits for the hash slices that have children.
+    const uint32_t bitmap;
+  };
+
+  // Returns the bit for the hash slice at the given shift.
+  static uint32_t Bit(uint64_t hash, int shift) {
+    return uint32_t(1) << ((hash >> shift) & ((1 << kBits) - 1));
+  }
+
+  // Returns the position of the child for the given bit in a branch with the
+  // given bitmap.
+  static int Position(uint32_t bitmap, uint32_t bit) {
+    return __builtin_popcount(bitmap & (bit - 1));
+  }
+
+  // Returns a new leaf, which takes over the reference to next.
+  static const Leaf* NewLeaf(uint64_t hash, const K& key, const V& value,
+                             const Leaf* next) {
+    return new (NodePool::Allocate(sizeof(Leaf))) Leaf(hash, key, value, next);
+  }
+
+  // Returns a new branch with the given bitmap, whose children are yet to be
+  // filled in.
+  static Branch* NewBranch(uint32_t bitmap) {
+    const size_t size =
+        sizeof(Branch) + __builtin_popcount(bitmap) * sizeof(const Node*);
+    return new (NodePool::Allocate(size)) Branch(bitmap);
+  }
+
+  // Adds a reference to the given node.
+  static void Ref(const Node* node) {
+    if (node != nullptr) {
+      node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // Removes a reference to the given node, and deletes the node if no
+  // references are left.
+  static void Unref(const Node* node) {
+    if (node == nullptr ||
+        node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    if (node->leaf) {
+      const Leaf* leaf = static_cast<const Leaf*>(node);
+      Unref(leaf->next);
+      leaf->~Leaf();
+      NodePool::Deallocate(const_cast<Leaf*>(leaf), sizeof(Leaf));
+    } else {
+      const Branch* branch = static_cast<const Branch*>(node);
+      const int n = branch->size();
+      for (int i = 0; i < n; ++i) {
+        Unref(branch->children()[i]);
+      }
+      branch->~Branch();
+      NodePool::Deallocate(const_cast<Branch*>(branch),
+                           sizeof(Branch) + n * sizeof(const Node*));
+    }
+  }
+
+  // Returns a copy of the given chain of leaves without the leaf for the
+  // given key, sharing the leaves after it.
+  static const Leaf* Without(const Leaf* leaf, const K& key) {
+    if (leaf == nullptr) {
+      return nullptr;
+    } else if (leaf->key == key) {
+      Ref(leaf->next);
+      return leaf->next;
+    } else {
+      return NewLeaf(leaf->hash, leaf->key, leaf->value,
+                     Without(leaf->next, key));
+    }
+  }
+
+  // Returns a branch at the given shift holding the two given nodes, whose
+  // keys have the given different hashes.  Takes over the references to the
+  // nodes.
+  static const Node* Join(const Node* a, uint64_t hash_a, const Node* b,
+                          uint64_t hash_b, int shift) {
+    const uint32_t bit_a = Bit(hash_a, shift);
+    const uint32_t bit_b = Bit(hash_b, shift);
+    if (bit_a == bit_b) {
+      Branch* branch = NewBranch(bit_a);
+      branch->children()[0] = Join(a, hash_a, b, hash_b, shift + kBits);
+      return branch;
+    }
+    Branch* branch = NewBranch(bit_a | bit_b);
+    branch->children()[bit_a < bit_b ? 0 : 1] = a;
+    branch->children()[bit_a < bit_b ? 1 : 0] = b;
+    return branch;
+  }
+
+  // Returns true if the given node has no other references than the one
+  // held by the caller, so that it can be changed in place.
+  static bool Unique(const Node* node) {
+    return node->refs.load(std::memory_order_acquire) == 1;
+  }
+
+  // Returns the node obtained by mapping the given key, with the given hash,
+  // to the given value in the given node at the given shift.  Sets added to
+  // true if the key was not in the node.  Takes over the reference to the
+  // given node, and the returned node holds a reference.
+  static const Node* Insert(const Node* node, uint64_t hash, int shift,
+                            const K& key, const V& value, bool* added) {
+    if (node == nullptr) {
+      *added = true;
+      return NewLeaf(hash, key, value, nullptr);
+    }
+    if (node->leaf) {
+      const Leaf* leaf = static_cast<const Leaf*>(node);
+      if (leaf->hash != hash) {
+        *added = true;
+        return Join(leaf, leaf->hash, NewLeaf(hash, key, value, nullptr),
+                    hash, shift);
+      }
+      *added = true;
+      for (const Leaf* l = leaf; l != nullptr; l = l->next) {
+        if (l->key == key) {
+          *added = false;
+        }
+      }
+      const Leaf* result = NewLeaf(hash, key, value, Without(leaf, key));
+      Unref(leaf);
+      return result;
+    }
+    const Branch* branch = static_cast<const Branch*>(node);
+    const uint32_t bit = Bit(hash, shift);
+    const int position = Position(branch->bitmap, bit);
+    const int n = branch->size();
+    if ((branch->bitmap & bit) != 0) {
+      const Node** children = branch->children();
+      if (Unique(branch)) {
+        children[position] = Insert(children[position], hash, shift + kBits,
+                                    key, value, added);
+        return branch;
+      }
+      Branch* copy = NewBranch(branch->bitmap);
+      for (int i = 0; i < n; ++i) {
+        copy->children()[i] = children[i];
+        Ref(children[i]);
+      }
+      copy->children()[position] = Insert(children[position], hash,
+                                          shift + kBits, key, value, added);
+      Unref(branch);
+      return copy;
+    }
+    *added = true;
+    Branch* copy = NewBranch(branch->bitmap | bit);
+    for (int i = 0; i < position; ++i) {
+      copy->children()[i] = branch->children()[i];
+      Ref(copy->children()[i]);
+    }
+    copy->children()[position] = NewLeaf(hash, key, value, nullptr);
+    for (int i = position; i < n; ++i) {
+      copy->children()[i + 1] = branch->children()[i];
+      Ref(copy->children()[i + 1]);
+    }
+    Unref(branch);
+    return copy;
+  }
+
+  // Root of the trie, or nullptr if this map is empty.
+  const Node* root_;
+  // Number of keys in this map.
+  size_t size_;
+};
+
+#endif  // PERSISTENT_MAP_H_
@@ -0,0 +1,164 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+// Tests for the persistent map.
+
+#include "persistent-map.h"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "hash.h"
+#include "node-pool.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+struct MixedHash {
+  size_t operator()(int key) const { return HashCombine(0, key); }
+};
+
+// Puts every key in the same slot, so that all keys collide.
+struct ConstantHash {
+  size_t operator()(int key) const { return 42; }
+};
+
+// Puts keys in the same slot at every level but the last.
+struct HighBitHash {
+  size_t operator()(int key) const { return uint64_t(key & 1) << 63; }
+};
+
+TEST(PersistentMapTest, FindsSetKeys) {
+  PersistentMap<int, std::string, MixedHash> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(nullptr, map.find(1));
+  map.set(1, "one");
+  map.set(2, "two");
+  map.set(3, "three");
+  EXPECT_EQ(3u, map.size());
+  ASSERT_NE(nullptr, map.find(2));
+  EXPECT_EQ("two", *map.find(2));
+  EXPECT_EQ(nullptr, map.find(4));
+  map.set(2, "deux");
+  EXPECT_EQ(3u, map.size());
+  EXPECT_EQ("deux", *map.find(2));
+  EXPECT_EQ("one", *map.find(1));
+}
+
+TEST(PersistentMapTest, CopiesAreIndependent) {
+  PersistentMap<int, int, MixedHash> map;
+  for (int i = 0; i < 100; ++i) {
+    map.set(i, i);
+  }
+  PersistentMap<int, int, MixedHash> copy(map);
+  copy.set(5, 50);
+  copy.set(100, 100);
+  EXPECT_EQ(5, *map.find(5));
+  EXPECT_EQ(nullptr, map.find(100));
+  EXPECT_EQ(100u, map.size());
+  EXPECT_EQ(50, *copy.find(5));
+  EXPECT_EQ(100, *copy.find(100));
+  EXPECT_EQ(101u, copy.size());
+  map = copy;
+  EXPECT_EQ(50, *map.find(5));
+  EXPECT_EQ(101u, map.size());
+}
+
+TEST(PersistentMapTest, HandlesCollisions) {
+  PersistentMap<int, int, ConstantHash> map;
+  for (int i = 0; i < 10; ++i) {
+    map.set(i, i);
+  }
+  PersistentMap<int, int, ConstantHash> copy(map);
+  copy.set(3, 30);
+  EXPECT_EQ(10u, copy.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, *map.find(i));
+    EXPECT_EQ(i == 3 ? 30 : i, *copy.find(i));
+  }
+  EXPECT_EQ(nullptr, map.find(10));
+}
+
+TEST(PersistentMapTest, SplitsAtTheLastLevel) {
+  PersistentMap<int, int, HighBitHash> map;
+  map.set(0, 0);
+  map.set(1, 1);
+  map.set(2, 2);
+  EXPECT_EQ(0, *map.find(0));
+  EXPECT_EQ(1, *map.find(1));
+  EXPECT_EQ(2, *map.find(2));
+  EXPECT_EQ(3u, map.size());
+}
+
+TEST(PersistentMapTest, MatchesStdMap) {
+  std::mt19937 random(17);
+  std::map<int, int> expected;
+  PersistentMap<int, int, MixedHash> map;
+  std::vector<PersistentMap<int, int, MixedHash>> versions;
+  std::vector<std::map<int, int>> expected_versions;
+  for (int i = 0; i < 5000; ++i) {
+    const int key = random() % 2000;
+    expected[key] = i;
+    map.set(key, i);
+    if (i % 500 == 0) {
+      versions.push_back(map);
+      expected_versions.push_back(expected);
+    }
+  }
+  EXPECT_EQ(expected.size(), map.size());
+  for (int key = 0; key < 2000; ++key) {
+    std::map<int, int>::const_iterator i = expected.find(key);
+    if (i == expected.end()) {
+      EXPECT_EQ(nullptr, map.find(key));
+    } else {
+      ASSERT_NE(nullptr, map.find(key));
+      EXPECT_EQ(i->second, *map.find(key));
+    }
+  }
+  for (size_t v = 0; v < versions.size(); ++v) {
+    EXPECT_EQ(expected_versions[v].size(), versions[v].size());
+    for (const auto& entry : expected_versions[v]) {
+      ASSERT_NE(nullptr, versions[v].find(entry.first));
+      EXPECT_EQ(entry.second, *versions[v].find(entry.first));
+    }
+  }
+}
+
+TEST(PersistentMapTest, FreesNodes) {
+  const long blocks = NodePool::BlocksInUse();
+  {
+    PersistentMap<int, int, MixedHash> map;
+    for (int i = 0; i < 1000; ++i) {
+      map.set(i, i);
+    }
+    PersistentMap<int, int, MixedHash> copy(map);
+    copy.set(0, 1);
+    PersistentMap<int, int, ConstantHash> collisions;
+    collisions.set(1, 1);
+    collisions.set(2, 2);
+    collisions.set(1, 3);
+    EXPECT_LT(blocks, NodePool::BlocksInUse());
+  }
+  EXPECT_EQ(blocks, NodePool::BlocksInUse());
+}
+
+}  // namespace
@@ -0,0 +1,51 @@
+#!/bin/bash
+#
+# Copyright (C) 2019 Google Inc
+#
+# This file is part of VHPOP.
+#
+# VHPOP is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+#
+# VHPOP is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+# License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with VHPOP; if not, write to the Free Software Foundation,
+# Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+#
+#
+# Checks the plans found for example problems against the number of steps
+# and the number of generated plans recorded in src/testdata/plan_counts.txt.
+# The recorded numbers were produced with the plan queue as a binary heap of
+# plans, so any change to the order in which plans are expanded shows up here.
+
+readonly SRCDIR=${TEST_SRCDIR:-.}
+readonly VHPOP=${VHPOP:-./vhpop}
+
+pass=1
+
+while read domain problem steps generated options; do
+  if [[ -z "${domain}" || "${domain}" = \#* ]]; then
+    continue
+  fi
+  echo -n "${problem}${options:+ ${options}}..."
+  output=$(${VHPOP} ${options} -v1 ${SRCDIR}/examples/${domain} \
+           ${SRCDIR}/examples/${problem} 2>&1)
+  actual_steps=$(echo "${output}" | grep -c '^[0-9.]*:')
+  actual_generated=$(echo "${output}" |
+                     sed -n 's/^Plans generated: \([0-9]*\).*/\1/p')
+  if [[ "${actual_steps}" = "${steps}" &&
+        "${actual_generated}" = "${generated}" ]]; then
+    echo pass
+  else
+    echo "fail (${actual_steps} steps, ${actual_generated} generated)"
+    pass=0
+  fi
+done < ${SRCDIR}/src/testdata/plan_counts.txt
+
+[[ ${pass} = 1 ]]
@@ -0,0 +1,86 @@
+#!/bin/bash
+#
+# Copyright (C) 2019 Google Inc
+#
+# This file is part of VHPOP.
+#
+# VHPOP is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+#
+# VHPOP is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+# License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with VHPOP; if not, write to the Free Software Foundation,
+# Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+#
+#
+# Checks that the memory used by the planner in server mode stays flat when
+# the same request is served over and over, so that nothing that belongs to
+# a solved problem is kept between requests.
+
+readonly SRCDIR=${TEST_SRCDIR:-.}
+readonly VHPOP=${VHPOP:-./vhpop}
+readonly REQUEST="${SRCDIR}/examples/briefcase-world-domain.pddl \
+${SRCDIR}/examples/get-paid2.pddl"
+# Allowed growth of the peak resident set size, in kB.
+readonly MAX_GROWTH=256
+
+if [[ ! -r /proc/self/status ]]; then
+  echo "no /proc/self/status; skipping"
+  exit 77
+fi
+
+coproc SERVER { exec ${VHPOP} -x 2>&1; }
+readonly PID=${SERVER_PID}
+
+# Reads one response from the server.
+read_response() {
+  local line
+  while read -r line <&${SERVER[0]}; do
+    if [[ "${line}" = . ]]; then
+      return 0
+    fi
+  done
+  return 1
+}
+
+# Serves the given number of requests.
+serve() {
+  local i
+  for ((i = 0; i < $1; i++)); do
+    echo "${REQUEST}" >&${SERVER[1]}
+    read_response || return 1
+  done
+}
+
+# Returns the peak resident set size of the server, in kB.
+peak_rss() {
+  sed -n 's/^VmHWM:[^0-9]*\([0-9]*\).*/\1/p' /proc/${PID}/status
+}
+
+pass=1
+# The response to the empty request given on the command line.
+read_response || pass=0
+if [[ ${pass} = 1 ]] && serve 200; then
+  before=$(peak_rss)
+  if serve 2000; then
+    after=$(peak_rss)
+    echo "peak RSS ${before} kB after 200 requests, ${after} kB after 2200"
+    if (( after - before > MAX_GROWTH )); then
+      pass=0
+    fi
+  else
+    pass=0
+  fi
+else
+  pass=0
+fi
+eval "exec ${SERVER[1]}>&-"
+wait ${PID}
+
+[[ ${pass} = 1 ]]
@@ -0,0 +1,106 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+#include "worker-pool.h"
+
+WorkerPool::WorkerPool(int num_threads)
+    : fn_(nullptr),
+      n_(0),
+      next_index_(0),
+      generation_(0),
+      busy_workers_(0),
+      shutdown_(false) {
+  for (int i = 1; i < num_threads; ++i) {
+    workers_.emplace_back(&WorkerPool::WorkerLoop, this);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  loop_started_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void WorkerPool::ParallelFor(size_t n,
+                             const std::function<void(size_t)>& fn) {
+  if (workers_.empty() || n <= 1) {
+    for (size_t i = 0; i < n; ++i) {
+      fn(i);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fn_ = &fn;
+    n_ = n;
+    next_index_.store(0, std::memory_order_relaxed);
+    exception_ = nullptr;
+    busy_workers_ = workers_.size();
+    ++generation_;
+  }
+  loop_started_.notify_all();
+  RunLoop();
+  std::unique_lock<std::mutex> lock(mutex_);
+  loop_finished_.wait(lock, [this]() { return busy_workers_ == 0; });
+  fn_ = nullptr;
+  if (exception_ != nullptr) {
+    std::exception_ptr exception = exception_;
+    exception_ = nullptr;
+    std::rethrow_exception(exception);
+  }
+}
+
+void WorkerPool::WorkerLoop() {
+  size_t generation = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    loop_started_.wait(lock, [this, generation]() {
+      return shutdown_ || generation_ != generation;
+    });
+    if (shutdown_) {
+      return;
+    }
+    generation = generation_;
+    lock.unlock();
+    RunLoop();
+    lock.lock();
+    if (--busy_workers_ == 0) {
+      loop_finished_.notify_one();
+    }
+  }
+}
+
+void WorkerPool::RunLoop() {
+  for (size_t i = next_index_.fetch_add(1, std::memory_order_relaxed); i < n_;
+       i = next_index_.fetch_add(1, std::memory_order_relaxed)) {
+    try {
+      (*fn_)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (exception_ == nullptr) {
+        exception_ = std::current_exception();
+      }
+      next_index_.store(n_, std::memory_order_relaxed);
+    }
+  }
+}
@@ -0,0 +1,89 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+// A pool of worker threads for running loops in parallel.
+
+#ifndef WORKER_POOL_H_
+#define WORKER_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A pool of worker threads for running loops in parallel.  The thread that
+// calls ParallelFor takes part in the loop, so a pool for n threads starts
+// n - 1 worker threads.
+class WorkerPool {
+ public:
+  // Constructs a pool that runs loops on num_threads threads.
+  explicit WorkerPool(int num_threads);
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  // Stops the worker threads and waits for them to exit.
+  ~WorkerPool();
+
+  // Returns the number of threads that run loops, including the calling
+  // thread.
+  int num_threads() const { return workers_.size() + 1; }
+
+  // Calls fn(i) for each i in [0, n) and returns when all calls have finished.
+  // Indices are handed out one at a time, so a thread that finishes early
+  // takes over work that would otherwise wait for a busy thread.  If fn throws,
+  // no new indices are handed out and the first exception is rethrown in the
+  // calling thread.
+  void ParallelFor(size_t n, const std::function<void(size_t)>& fn);
+
+ private:
+  // Main loop of a worker thread.
+  void WorkerLoop();
+
+  // Calls the current loop body for indices until none are left.
+  void RunLoop();
+
+  // The worker threads.
+  std::vector<std::thread> workers_;
+  // Mutex protecting the loop state below.
+  std::mutex mutex_;
+  // Signalled when a new loop starts or the pool shuts down.
+  std::condition_variable loop_started_;
+  // Signalled when the last worker is done with the current loop.
+  std::condition_variable loop_finished_;
+  // Body of the current loop.
+  const std::function<void(size_t)>* fn_;
+  // Number of iterations of the current loop.
+  size_t n_;
+  // Next index to hand out.
+  std::atomic<size_t> next_index_;
+  // Incremented for every loop, so that workers can tell loops apart.
+  size_t generation_;
+  // Number of workers not yet done with the current loop.
+  int busy_workers_;
+  // The first exception thrown by the current loop body.
+  std::exception_ptr exception_;
+  // Whether the workers should exit.
+  bool shutdown_;
+};
+
+#endif  // WORKER_POOL_H_
@@ -0,0 +1,79 @@
+// Copyright (C) 2019 Google Inc
+//
+// This file is part of VHPOP.
+//
+// VHPOP is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// VHPOP is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+// or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+// License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VHPOP; if not, write to the Free Software Foundation,
+// Inc., #59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+//
+// Tests for worker pool.
+
+#include "worker-pool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(WorkerPoolTest, NumThreads) {
+  EXPECT_EQ(1, WorkerPool(1).num_threads());
+  EXPECT_EQ(4, WorkerPool(4).num_threads());
+}
+
+TEST(WorkerPoolTest, VisitsEveryIndexOnce) {
+  for (int num_threads = 1; num_threads <= 4; ++num_threads) {
+    WorkerPool pool(num_threads);
+    std::vector<std::atomic<int>> visits(1000);
+    pool.ParallelFor(visits.size(), [&visits](size_t i) { ++visits[i]; });
+    for (size_t i = 0; i < visits.size(); ++i) {
+      EXPECT_EQ(1, visits[i]) << "index " << i << " with " << num_threads
+                              << " threads";
+    }
+  }
+}
+
+TEST(WorkerPoolTest, EmptyLoop) {
+  WorkerPool pool(4);
+  int calls = 0;
+  pool.ParallelFor(0, [&calls](size_t i) { ++calls; });
+  EXPECT_EQ(0, calls);
+}
+
+TEST(WorkerPoolTest, ReusesThreads) {
+  WorkerPool pool(3);
+  std::atomic<size_t> sum(0);
+  for (size_t n = 0; n < 100; ++n) {
+    pool.ParallelFor(n, [&sum](size_t i) { sum += i; });
+  }
+  EXPECT_EQ(161700u, sum.load());
+}
+
+TEST(WorkerPoolTest, RethrowsException) {
+  WorkerPool pool(4);
+  EXPECT_THROW(pool.ParallelFor(100,
+                                [](size_t i) {
+                                  if (i == 17) {
+                                    throw std::runtime_error("boom");
+                                  }
+                                }),
+               std::runtime_error);
+  // The pool remains usable after an exception.
+  std::atomic<int> calls(0);
+  pool.ParallelFor(10, [&calls](size_t i) { ++calls; });
+  EXPECT_EQ(10, calls);
+}
+
+}  // namespace
@@ -19,6 +19,7 @@
 
 #include "terms.h"
 
+#include <stdexcept>
 #include <typeinfo>
 
 Object Term::as_object() const {
@@ -39,16 +40,23 @@ Variable Term::as_variable() const {
 
 std::ostream& operator<<(std::ostream& os, const Term& t) {
   if (t.object()) {
-    os << TermTable::names_[t.index_];
+    os << TermTable::object_name(t.index_);
   } else {
     os << "?v" << -t.index_;
   }
   return os;
 }
 
-std::vector<std::string> TermTable::names_;
-std::vector<Type> TermTable::object_types_;
-std::vector<Type> TermTable::variable_types_;
+std::atomic<std::vector<std::string>*>
+    TermTable::object_names_[TermTable::kMaxObjectChunks];
+std::atomic<std::vector<Type>*>
+    TermTable::object_types_[TermTable::kMaxObjectChunks];
+size_t TermTable::num_objects_ = 0;
+std::mutex TermTable::objects_mutex_;
+std::atomic<std::vector<Type>*>
+    TermTable::variable_types_[TermTable::kMaxVariableChunks];
+size_t TermTable::num_variables_ = 0;
+std::mutex TermTable::variables_mutex_;
 
 TermTable::~TermTable() {
   for (std::map<Type, const std::vector<Object>*>::const_iterator oi =
@@ -59,31 +67,108 @@ TermTable::~TermTable() {
 }
 
 Variable TermTable::add_variable(const Type& type) {
-  variable_types_.push_back(type);
-  return Variable(-variable_types_.size());
+  std::lock_guard<std::mutex> lock(variables_mutex_);
+  const size_t index = num_variables_;
+  const size_t chunk = index >> kVariableChunkBits;
+  if (chunk >= kMaxVariableChunks) {
+    throw std::length_error("too many variables");
+  }
+  if (variable_types_[chunk].load(std::memory_order_relaxed) == 0) {
+    variable_types_[chunk].store(
+        new std::vector<Type>(size_t{1} << kVariableChunkBits, type),
+        std::memory_order_release);
+  }
+  ++num_variables_;
+  variable_type(index) = type;
+  return Variable(-static_cast<int>(num_variables_));
+}
+
+Type& TermTable::variable_type(size_t index) {
+  std::vector<Type>& chunk = *variable_types_[index >> kVariableChunkBits].load(
+      std::memory_order_acquire);
+  return chunk[index & ((size_t{1} << kVariableChunkBits) - 1)];
+}
+
+std::string& TermTable::object_name(size_t index) {
+  std::vector<std::string>& chunk =
+      *object_names_[index >> kObjectChunkBits].load(
+          std::memory_order_acquire);
+  return chunk[index & ((size_t{1} << kObjectChunkBits) - 1)];
+}
+
+Type& TermTable::object_type(size_t index) {
+  std::vector<Type>& chunk = *object_types_[index >> kObjectChunkBits].load(
+      std::memory_order_acquire);
+  return chunk[index & ((size_t{1} << kObjectChunkBits) - 1)];
 }
 
 void TermTable::set_type(const Term& term, const Type& type) {
   if (term.object()) {
-    object_types_[term.index_] = type;
+    object_type(term.index_) = type;
   } else {
-    variable_types_[-term.index_ - 1] = type;
+    variable_type(-term.index_ - 1) = type;
   }
 }
 
 const Type& TermTable::type(const Term& term) {
   if (term.object()) {
-    return object_types_[term.index_];
+    return object_type(term.index_);
   } else {
-    return variable_types_[-term.index_ - 1];
+    return variable_type(-term.index_ - 1);
+  }
+}
+
+TermTable::Mark TermTable::mark() {
+  Mark mark;
+  {
+    std::lock_guard<std::mutex> lock(objects_mutex_);
+    mark.num_objects = num_objects_;
+  }
+  {
+    std::lock_guard<std::mutex> lock(variables_mutex_);
+    mark.num_variables = num_variables_;
+  }
+  return mark;
+}
+
+void TermTable::release(const Mark& mark) {
+  {
+    std::lock_guard<std::mutex> lock(objects_mutex_);
+    if (mark.num_objects < num_objects_) {
+      num_objects_ = mark.num_objects;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(variables_mutex_);
+    if (mark.num_variables < num_variables_) {
+      num_variables_ = mark.num_variables;
+    }
   }
 }
 
 const Object& TermTable::add_object(const std::string& name, const Type& type) {
+  size_t index;
+  {
+    std::lock_guard<std::mutex> lock(objects_mutex_);
+    index = num_objects_;
+    const size_t chunk = index >> kObjectChunkBits;
+    if (chunk >= kMaxObjectChunks) {
+      throw std::length_error("too many objects");
+    }
+    if (object_names_[chunk].load(std::memory_order_relaxed) == 0) {
+      object_names_[chunk].store(
+          new std::vector<std::string>(size_t{1} << kObjectChunkBits),
+          std::memory_order_release);
+      object_types_[chunk].store(
+          new std::vector<Type>(size_t{1} << kObjectChunkBits, type),
+          std::memory_order_release);
+    }
+    ++num_objects_;
+  }
+  object_name(index) = name;
+  object_type(index) = type;
   std::pair<std::map<std::string, Object>::const_iterator, bool> oi =
-      objects_.insert(std::make_pair(name, Object(names_.size())));
-  names_.push_back(name);
-  object_types_.push_back(type);
+      objects_.insert(std::make_pair(name, Object(index)));
   return (*oi.first).second;
 }
 
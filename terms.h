@@ -22,8 +22,12 @@
 #ifndef TERMS_H_
 #define TERMS_H_
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -31,6 +35,11 @@
 
 class Term;
 
+namespace std {
+template <>
+struct hash<Term>;
+}  // namespace std
+
 // An object.
 class Object {
  public:
@@ -77,6 +86,9 @@ class Term {
   // Converts this term to a variable.  Fails if the term is not a variable.
   Variable as_variable() const;
 
+  // Returns the index of this term.  Distinct terms have distinct indices.
+  int index() const { return index_; }
+
  private:
   // Term index.
   int index_;
@@ -85,6 +97,7 @@ class Term {
   friend bool operator<(const Term& t1, const Term& t2);
   friend std::ostream& operator<<(std::ostream& os, const Term& t);
   friend struct TermTable;
+  friend struct std::hash<Term>;
 };
 
 inline Object::operator Term() const { return Term(index_); }
@@ -107,6 +120,16 @@ inline bool operator<(const Term& t1, const Term& t2) {
 // Output operator for terms.
 std::ostream& operator<<(std::ostream& os, const Term& t);
 
+namespace std {
+
+// Hash function object for terms.
+template <>
+struct hash<Term> {
+  size_t operator()(const Term& t) const { return hash<int>()(t.index_); }
+};
+
+}  // namespace std
+
 // Term table.
 class TermTable {
  public:
@@ -119,6 +142,20 @@ class TermTable {
   // Returns the type of the given term.
   static const Type& type(const Term& term);
 
+  // Number of objects and variables added to all term tables at some point.
+  struct Mark {
+    size_t num_objects;
+    size_t num_variables;
+  };
+
+  // Returns the number of objects and variables added so far.
+  static Mark mark();
+
+  // Releases the objects and variables added after the given mark, so that
+  // their indices can be reused.  Must not be called while any of these
+  // terms are still in use.
+  static void release(const Mark& mark);
+
   // Constructs an empty term table.
   TermTable() : parent_(0) {}
 
@@ -140,12 +177,43 @@ class TermTable {
   const std::vector<Object>& compatible_objects(const Type& type) const;
 
  private:
-  // Object names.
-  static std::vector<std::string> names_;
-  // Object types.
-  static std::vector<Type> object_types_;
-  // Variable types.
-  static std::vector<Type> variable_types_;
+  // Number of objects per chunk (log 2).
+  static constexpr int kObjectChunkBits = 12;
+  // Maximum number of chunks of objects.
+  static constexpr size_t kMaxObjectChunks = size_t{1} << 16;
+
+  // Returns a reference to the name of the object with the given index.
+  static std::string& object_name(size_t index);
+
+  // Returns a reference to the type of the object with the given index.
+  static Type& object_type(size_t index);
+
+  // Object names and types, stored in fixed-size chunks that never move so
+  // that files can be parsed concurrently while other threads look up the
+  // name or type of an object.
+  static std::atomic<std::vector<std::string>*> object_names_[kMaxObjectChunks];
+  static std::atomic<std::vector<Type>*> object_types_[kMaxObjectChunks];
+  // Number of objects.
+  static size_t num_objects_;
+  // Mutex protecting the addition of objects.
+  static std::mutex objects_mutex_;
+
+  // Number of variable types per chunk (log 2).
+  static constexpr int kVariableChunkBits = 12;
+  // Maximum number of chunks of variable types.
+  static constexpr size_t kMaxVariableChunks = size_t{1} << 16;
+
+  // Returns a reference to the type of the variable with the given index.
+  static Type& variable_type(size_t index);
+
+  // Variable types, stored in fixed-size chunks that never move so that
+  // search threads can look up the type of a variable while other threads
+  // add new variables.
+  static std::atomic<std::vector<Type>*> variable_types_[kMaxVariableChunks];
+  // Number of variables.
+  static size_t num_variables_;
+  // Mutex protecting the addition of variables.
+  static std::mutex variables_mutex_;
 
   // Parent term table.
   const TermTable* parent_;
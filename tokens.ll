@@ -27,6 +27,7 @@ struct Literal;
 struct Atom;
 struct Expression;
 struct Fluent;
+struct ParseState;
 
 #include "terms.h"
 #include "types.h"
@@ -38,26 +39,26 @@ struct Fluent;
 #include "pddl.hh"
 
 
-/* Current line number. */
-size_t line_number;
-
 /* Allocates a string containing the lowercase characters of the given
-   C string, and returns the given token. */
-static int make_string(const char* s, int token);
-/* Makes a number of the given string, and return the NUMBER token. */
-static int make_number(const char* s);
+   C string, stores it in the given semantic value, and returns the
+   given token. */
+static int make_string(YYSTYPE* lvalp, const char* s, int token);
+/* Makes a number of the given string, stores it in the given semantic
+   value, and returns the NUMBER token. */
+static int make_number(YYSTYPE* lvalp, const char* s);
 
 %}
 
 %option case-insensitive never-interactive nounput noyywrap
+%option reentrant bison-bridge extra-type="size_t*"
 
 IDENT  [A-Za-z]([A-Za-z0-9\-_])*
 
 %%
 
-define                      return make_string(yytext, DEFINE);
-domain                      return make_string(yytext, DOMAIN_TOKEN);
-problem                     return make_string(yytext, PROBLEM);
+define                      return make_string(yylval, yytext, DEFINE);
+domain                      return make_string(yylval, yytext, DOMAIN_TOKEN);
+problem                     return make_string(yylval, yytext, PROBLEM);
 :requirements               return REQUIREMENTS;
 :types                      return TYPES;
 :constants                  return CONSTANTS;
@@ -90,52 +91,54 @@ problem                     return make_string(yytext, PROBLEM);
 :init                       return INIT;
 :goal                       return GOAL;
 :metric                     return METRIC;
-number                      return make_string(yytext, NUMBER_TOKEN);
-object                      return make_string(yytext, OBJECT_TOKEN);
-either                      return make_string(yytext, EITHER);
-when                        return make_string(yytext, WHEN);
-not                         return make_string(yytext, NOT);
-and                         return make_string(yytext, AND);
-or                          return make_string(yytext, OR);
-imply                       return make_string(yytext, IMPLY);
-exists                      return make_string(yytext, EXISTS);
-forall                      return make_string(yytext, FORALL);
-at                          return make_string(yytext, AT);
-over                        return make_string(yytext, OVER);
-start                       return make_string(yytext, START);
-end                         return make_string(yytext, END);
-all                         return make_string(yytext, ALL);
-minimize                    return make_string(yytext, MINIMIZE);
-maximize                    return make_string(yytext, MAXIMIZE);
-total-time                  return make_string(yytext, TOTAL_TIME);
-{IDENT}                     return make_string(yytext, NAME);
-\?duration                  return make_string(yytext, DURATION_VAR);
-\?{IDENT}                   return make_string(yytext, VARIABLE);
-[0-9]*\.?[0-9]+             return make_number(yytext);
+number                      return make_string(yylval, yytext, NUMBER_TOKEN);
+object                      return make_string(yylval, yytext, OBJECT_TOKEN);
+either                      return make_string(yylval, yytext, EITHER);
+when                        return make_string(yylval, yytext, WHEN);
+not                         return make_string(yylval, yytext, NOT);
+and                         return make_string(yylval, yytext, AND);
+or                          return make_string(yylval, yytext, OR);
+imply                       return make_string(yylval, yytext, IMPLY);
+exists                      return make_string(yylval, yytext, EXISTS);
+forall                      return make_string(yylval, yytext, FORALL);
+at                          return make_string(yylval, yytext, AT);
+over                        return make_string(yylval, yytext, OVER);
+start                       return make_string(yylval, yytext, START);
+end                         return make_string(yylval, yytext, END);
+all                         return make_string(yylval, yytext, ALL);
+minimize                    return make_string(yylval, yytext, MINIMIZE);
+maximize                    return make_string(yylval, yytext, MAXIMIZE);
+total-time                  return make_string(yylval, yytext, TOTAL_TIME);
+{IDENT}                     return make_string(yylval, yytext, NAME);
+\?duration                  return make_string(yylval, yytext, DURATION_VAR);
+\?{IDENT}                   return make_string(yylval, yytext, VARIABLE);
+[0-9]*\.?[0-9]+             return make_number(yylval, yytext);
 [()=+\-\*/]                 return yytext[0];
 \<=                         return LE;
 >=                          return GE;
 ;.*$                        /* comment */
 [ \t\r]+                    /* whitespace */
-\n                          line_number++;
+\n                          ++*yyextra;
 .                           return ILLEGAL_TOKEN;
 
 %%
 
 /* Allocates a string containing the lowercase characters of the given
-   C string, and returns the given token. */
-static int make_string(const char* s, int token) {
+   C string, stores it in the given semantic value, and returns the
+   given token. */
+static int make_string(YYSTYPE* lvalp, const char* s, int token) {
   std::string* result = new std::string();
   for (const char* p = s; *p != '\0'; p++) {
     *result += tolower(*p);
   }
-  yylval.str = result;
+  lvalp->str = result;
   return token;
 }
 
 
-/* Makes a number of the given string, and return the NUMBER token. */
-static int make_number(const char* s) {
-  yylval.num = atof(s);
+/* Makes a number of the given string, stores it in the given semantic
+   value, and returns the NUMBER token. */
+static int make_number(YYSTYPE* lvalp, const char* s) {
+  lvalp->num = atof(s);
   return NUMBER;
 }
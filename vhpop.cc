@@ -19,20 +19,43 @@
 //
 // Main program.
 
+#include <atomic>
 #include <cerrno>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include "debug.h"
 #include "domains.h"
+#include "formulas.h"
 #include "heuristics.h"
 #include "parameters.h"
+#include "parser.h"
 #include "plans.h"
 #include "problems.h"
 
+#include "src/action-cache.h"
+#include "src/hash.h"
+#include "src/mapped-file.h"
+#include "src/pddl-scan.h"
 #include "src/timer.h"
+#include "src/worker-pool.h"
 
 #if HAVE_GETOPT_LONG
 #ifndef _GNU_SOURCE
@@ -41,31 +64,51 @@
 #include <getopt.h>
 #endif
 
-/* The parse function. */
-extern int yyparse();
-/* File to parse. */
-extern FILE* yyin;
-
-/* Name of current file. */
-std::string current_file;
 /* Level of warnings. */
 int warning_level;
 /* Verbosity level. */
 int verbosity;
 
+/* Directory holding the action cache, or empty if ground actions are
+   not cached. */
+static std::string cache_dir;
+/* Content hashes of the sources that define each domain and problem,
+   used to find their ground actions in the action cache. */
+static std::map<const Domain*, uint64_t> domain_sources;
+static std::map<const Problem*, uint64_t> problem_sources;
+/* Guards the content hashes, which are recorded while problems parsed
+   earlier are solved. */
+static std::mutex sources_mutex;
+/* Number of parsed problems per job that may wait to be solved. */
+static const size_t READ_AHEAD = 2;
+/* Guards standard output, which plans found in anytime mode are
+   written to while other problems are being solved. */
+static std::mutex output_mutex;
+
 
 /* Program options. */
 static struct option long_options[] = {
   { "action-cost", required_argument, NULL, 'a' },
+  { "anytime", no_argument, NULL, 'A' },
+  { "cache-dir", required_argument, NULL, 'c' },
+  { "deferred-evaluation", no_argument, NULL, 'e' },
   { "domain-constraints", optional_argument, NULL, 'd' },
   { "flaw-order", required_argument, NULL, 'f' },
   { "ground-actions", no_argument, NULL, 'g' },
+  { "grounding-threads", required_argument, NULL, 'G' },
   { "help", no_argument, NULL, 'H' },
   { "heuristic", required_argument, NULL, 'h' },
+  { "jobs", required_argument, NULL, 'j' },
   { "limit", required_argument, NULL, 'l' },
+  { "memory-limit", required_argument, NULL, 'm' },
+  { "name-order", no_argument, NULL, 'n' },
+  { "portfolio", no_argument, NULL, 'p' },
+  { "prune-duplicates", no_argument, NULL, 'D' },
   { "random-open-conditions", no_argument, NULL, 'r' },
   { "search-algorithm", required_argument, NULL, 's' },
   { "seed", required_argument, NULL, 'S' },
+  { "server", no_argument, NULL, 'x' },
+  { "threads", required_argument, NULL, 'P' },
   { "time-limit", required_argument, NULL, 'T' },
   { "tolerance", required_argument, NULL, 't' },
   { "version", no_argument, NULL, 'V' },
@@ -74,7 +117,7 @@ static struct option long_options[] = {
   { "weight", required_argument, NULL, 'w' },
   { 0, 0, 0, 0 }
 };
-static const char OPTION_STRING[] = "a:d::f:gHh:l:rS:s:T:t:Vv::W::w:";
+static const char OPTION_STRING[] = "Aa:c:d::Def:gG:Hh:j:l:m:npP:rS:s:T:t:Vv::W::w:x";
 
 
 /* Displays help. */
@@ -83,22 +126,52 @@ static void display_help() {
             << "options:" << std::endl
             << "  -a a,  --action-cost=a" << std::endl
             << "\t\t\tuse action cost a" << std::endl
+            << "  -A,    --anytime\t"
+            << "keep searching for plans with shorter makespan" << std::endl
+            << "  -c d,  --cache-dir=d\t"
+            << "cache ground actions in directory d" << std::endl
             << "  -d[k], --domain-constraints=[k]" << std::endl
             << "\t\t\tuse parameter domain constraints;" << std::endl
             << "\t\t\t  if k is 0, static preconditions are pruned;"
             << std::endl
             << "\t\t\t  otherwise (default) static preconditions are kept"
             << std::endl
+            << "  -D,    --prune-duplicates" << std::endl
+            << "\t\t\tprune plans that duplicate earlier plans" << std::endl
+            << "  -e,    --deferred-evaluation" << std::endl
+            << "\t\t\trank plans when they are selected rather than"
+            << std::endl
+            << "\t\t\t  when they are generated" << std::endl
             << "  -f f,  --flaw-order=f\t"
             << "use flaw selection order f" << std::endl
             << "  -g,    --ground-actions" << std::endl
             << "\t\t\tuse ground actions" << std::endl
+            << "  -G n,  --grounding-threads=n" << std::endl
+            << "\t\t\tuse n threads to ground actions and build the"
+            << std::endl
+            << "\t\t\t  planning graph (default is 1)" << std::endl
             << "  -H     --help\t\t"
             << "display this help and exit" << std::endl
             << "  -h h,  --heuristic=h\t"
             << "use heuristic h to rank plans" << std::endl
+            << "\t\t\t  (at most 255 components)" << std::endl
+            << "  -j n,  --jobs=n\t"
+            << "solve up to n problems concurrently (default is 1)"
+            << std::endl
             << "  -l l,  --limit=l\t"
             << "search no more than l plans" << std::endl
+            << "  -m m,  --memory-limit=m" << std::endl
+            << "\t\t\tevict the worst pending plans when plans use more"
+            << std::endl
+            << "\t\t\t  than m megabytes" << std::endl
+            << "  -n,    --name-order\t"
+            << "print results in the order of the problem names"
+            << std::endl
+            << "\t\t\t  once all problems are solved" << std::endl
+            << "  -p,    --portfolio\t"
+            << "run flaw selection orders concurrently" << std::endl
+            << "  -P n,  --threads=n\t"
+            << "use n threads to expand plans (default is 1)" << std::endl
             << "  -r,    --random-open-conditions" << std::endl
             << "\t\t\tadd open conditions in random order"
             << std::endl
@@ -128,6 +201,10 @@ static void display_help() {
             << "\t\t\t  2 treats warnings as errors" << std::endl
             << "  -w,    --weight=w\t"
             << "weight to use with heuristic (default is 1)" << std::endl
+            << "  -x,    --server\t"
+            << "solve problems named on standard input, keeping"
+            << std::endl
+            << "\t\t\t  domains loaded between requests" << std::endl
             << "  file ...\t\t"
             << "files containing domain and problem descriptions;" << std::endl
             << "\t\t\t  if none, descriptions are read from standard input"
@@ -154,18 +231,752 @@ static void display_version() {
 }
 
 
-/* Parses the given file, and returns true on success. */
-static bool read_file(const char* name) {
-  yyin = fopen(name, "r");
-  if (yyin == NULL) {
+/* ====================================================================== */
+/* ProblemQueue */
+
+/*
+ * A queue of parsed problems waiting to be solved, in the order they
+ * were parsed.  The queue holds a bounded number of problems, so the
+ * parser cannot get far ahead of the solvers.
+ */
+struct ProblemQueue {
+  /* Constructs an empty queue holding at most the given number of
+     problems. */
+  explicit ProblemQueue(size_t capacity);
+
+  /* Adds the given problem to the end of this queue, waiting while the
+     queue is full.  Returns false without adding the problem if
+     solving has stopped. */
+  bool push(const Problem* problem);
+
+  /* Marks that no more problems will be added. */
+  void close();
+
+  /* Stops solving, so that no more problems are added or removed. */
+  void stop();
+
+  /* Removes the first problem from this queue, waiting while the queue
+     is empty and more problems may be added.  Returns false if there
+     are no more problems or solving has stopped.  Otherwise sets index
+     to the position of the problem among all problems added, and last
+     to whether the problem is known to be the last one. */
+  bool pop(const Problem*& problem, size_t& index, bool& last);
+
+  /* Marks a removed problem as solved. */
+  void solved();
+
+  /* Waits until every problem added so far has been solved.  Returns
+     false if solving has stopped. */
+  bool wait_until_solved();
+
+ private:
+  /* Maximum number of problems waiting to be solved. */
+  size_t capacity_;
+  /* Problems waiting to be solved. */
+  std::deque<const Problem*> problems_;
+  /* Number of problems added so far. */
+  size_t added_;
+  /* Number of problems solved so far. */
+  size_t solved_;
+  /* Whether no more problems will be added. */
+  bool closed_;
+  /* Whether solving has stopped. */
+  bool stopped_;
+  /* Guards the state of this queue. */
+  std::mutex mutex_;
+  /* Notified whenever the state of this queue changes. */
+  std::condition_variable changed_;
+};
+
+
+/* Constructs an empty queue holding at most the given number of
+   problems. */
+ProblemQueue::ProblemQueue(size_t capacity)
+  : capacity_(capacity), added_(0), solved_(0), closed_(false),
+    stopped_(false) {}
+
+
+/* Adds the given problem to the end of this queue, waiting while the
+   queue is full. */
+bool ProblemQueue::push(const Problem* problem) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  changed_.wait(lock, [this]() {
+    return problems_.size() < capacity_ || stopped_;
+  });
+  if (stopped_) {
+    return false;
+  }
+  problems_.push_back(problem);
+  added_++;
+  changed_.notify_all();
+  return true;
+}
+
+
+/* Marks that no more problems will be added. */
+void ProblemQueue::close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  closed_ = true;
+  changed_.notify_all();
+}
+
+
+/* Stops solving, so that no more problems are added or removed. */
+void ProblemQueue::stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stopped_ = true;
+  changed_.notify_all();
+}
+
+
+/* Removes the first problem from this queue, waiting while the queue
+   is empty and more problems may be added. */
+bool ProblemQueue::pop(const Problem*& problem, size_t& index, bool& last) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  changed_.wait(lock, [this]() {
+    return !problems_.empty() || closed_ || stopped_;
+  });
+  if (problems_.empty() || stopped_) {
+    return false;
+  }
+  problem = problems_.front();
+  index = added_ - problems_.size();
+  problems_.pop_front();
+  last = (closed_ && problems_.empty());
+  changed_.notify_all();
+  return true;
+}
+
+
+/* Marks a removed problem as solved. */
+void ProblemQueue::solved() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  solved_++;
+  changed_.notify_all();
+}
+
+
+/* Waits until every problem added so far has been solved. */
+bool ProblemQueue::wait_until_solved() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  changed_.wait(lock, [this]() { return solved_ == added_ || stopped_; });
+  return !stopped_;
+}
+
+
+/* Deletes the given problem, which is not in the table of problems. */
+static void release_problem(const Problem* problem) {
+  if (!cache_dir.empty()) {
+    std::lock_guard<std::mutex> lock(sources_mutex);
+    problem_sources.erase(problem);
+  }
+  delete problem;
+}
+
+
+/* Forgets the recorded sources of domains that have since been
+   deleted, because a later source redefined them.  Must be called
+   with sources_mutex held. */
+static void forget_deleted_domains() {
+  std::set<const Domain*> defined;
+  for (Domain::DomainMap::const_iterator di = Domain::begin();
+       di != Domain::end(); di++) {
+    defined.insert((*di).second);
+  }
+  for (std::map<const Domain*, uint64_t>::iterator di =
+           domain_sources.begin();
+       di != domain_sources.end();) {
+    if (defined.find((*di).first) == defined.end()) {
+      di = domain_sources.erase(di);
+    } else {
+      di++;
+    }
+  }
+}
+
+
+/* Defines the problems the given parser has parsed, by adding them to
+   the table of problems or, if a queue is given, to the queue of
+   problems to solve.  Problems are not queued but deleted if the
+   source failed to parse, or if solving has stopped.  If ground
+   actions are cached, the given content hash of the parsed source is
+   recorded for the domains and problems it defines.  Returns true if
+   the source was parsed and its problems defined. */
+static bool define_parsed(const PddlParser& parser, bool parsed,
+                          uint64_t content_hash, ProblemQueue* queue) {
+  if (!cache_dir.empty()) {
+    std::lock_guard<std::mutex> lock(sources_mutex);
+    forget_deleted_domains();
+    for (const Domain* domain : parser.domains()) {
+      domain_sources[domain] = content_hash;
+    }
+    for (const Problem* problem : parser.problems()) {
+      problem_sources[problem] = content_hash;
+    }
+  }
+  for (const Problem* problem : parser.problems()) {
+    if (queue == NULL) {
+      Problem::add(problem);
+    } else if (!parsed || !queue->push(problem)) {
+      parsed = false;
+      release_problem(problem);
+    }
+  }
+  return parsed;
+}
+
+
+/* Waits until the problems in the given queue, if any, have been
+   solved, so that the next source can redefine their domains.
+   Returns false if solving has stopped. */
+static bool solve_queued(ProblemQueue* queue) {
+  if (queue == NULL) {
+    return true;
+  }
+  if (!queue->wait_until_solved()) {
+    return false;
+  }
+  Plan::clear_domain_cache();
+  return true;
+}
+
+
+/* Returns the content hash of the given file, or 0 if ground actions
+   are not cached. */
+static uint64_t content_hash(const MappedFile& file) {
+  if (cache_dir.empty()) {
+    return 0;
+  }
+  return Fnv1a64(std::string_view(file.data(), file.size()));
+}
+
+
+/* Parses the given mapped file in place, and returns true on success.
+   Errors and warnings are reported on the given stream.  The problems
+   the file defines are not added to the table of problems. */
+static bool parse_mapped(PddlParser& parser, MappedFile& file) {
+  return parser.parse(file.data(), file.size() + MappedFile::kPadding);
+}
+
+
+/* Parses the given file, and returns true on success.  The file is
+   mapped into memory and scanned in place.  The problems it defines
+   are added to the given queue, or to the table of problems if no
+   queue is given. */
+static bool read_file(const char* name, ProblemQueue* queue) {
+  std::unique_ptr<MappedFile> file = MappedFile::Open(name);
+  if (file == NULL) {
     std::cerr << PACKAGE << ':' << name << ": " << strerror(errno)
               << std::endl;
     return false;
   } else {
-    current_file = name;
-    bool success = (yyparse() == 0);
-    fclose(yyin);
-    return success;
+    if (queue != NULL
+        && MayDefineDomain(std::string_view(file->data(), file->size()))
+        && !solve_queued(queue)) {
+      return false;
+    }
+    /* Hashed before scanning, which changes the buffer temporarily. */
+    const uint64_t hash = content_hash(*file);
+    PddlParser parser(name, std::cerr);
+    bool success = parse_mapped(parser, *file);
+    return define_parsed(parser, success, hash, queue);
+  }
+}
+
+
+/* Parses the given files, and returns true on success.  Files that
+   cannot define domains are parsed on the given number of threads,
+   but their errors and problems are reported and defined in the order
+   of the files, and nothing after the first failing file is.  The
+   problems are added to the given queue, or to the table of problems
+   if no queue is given. */
+static bool read_files(const std::vector<const char*>& names, int jobs,
+                       ProblemQueue* queue) {
+  if (jobs <= 1 || names.size() <= 1) {
+    for (const char* name : names) {
+      if (!read_file(name, queue)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  std::vector<std::unique_ptr<MappedFile>> files;
+  for (const char* name : names) {
+    files.push_back(MappedFile::Open(name));
+    if (files.back() == NULL) {
+      break;
+    }
+  }
+  const int open_errno = errno;
+  WorkerPool pool(jobs);
+  size_t i = 0;
+  while (i < files.size() && files[i] != NULL) {
+    /* A file that may define domains is parsed on its own, since
+       later files may refer to the domains it defines. */
+    size_t j = i;
+    /* When problems are queued, files are parsed a few at a time, so
+       that the parser does not get far ahead of the solvers. */
+    while (j < files.size() && files[j] != NULL
+           && (queue == NULL || j - i < size_t(jobs))
+           && !MayDefineDomain(
+                  std::string_view(files[j]->data(), files[j]->size()))) {
+      j++;
+    }
+    if (j == i) {
+      if (!solve_queued(queue)) {
+        return false;
+      }
+      const uint64_t hash = content_hash(*files[i]);
+      PddlParser parser(names[i], std::cerr);
+      bool success = parse_mapped(parser, *files[i]);
+      success = define_parsed(parser, success, hash, queue);
+      files[i].reset();
+      if (!success) {
+        return false;
+      }
+      i++;
+      continue;
+    }
+    const size_t n = j - i;
+    std::vector<uint64_t> hashes(n);
+    std::vector<std::ostringstream> messages(n);
+    std::vector<std::unique_ptr<PddlParser>> parsers(n);
+    std::vector<char> parsed(n, false);
+    pool.ParallelFor(n, [&](size_t k) {
+      hashes[k] = content_hash(*files[i + k]);
+      parsers[k].reset(new PddlParser(names[i + k], messages[k]));
+      parsed[k] = parse_mapped(*parsers[k], *files[i + k]);
+    });
+    bool success = true;
+    for (size_t k = 0; k < n; k++) {
+      if (success) {
+        std::cerr << messages[k].str();
+        success = define_parsed(*parsers[k], parsed[k], hashes[k], queue);
+      } else {
+        for (const Problem* problem : parsers[k]->problems()) {
+          release_problem(problem);
+        }
+      }
+      files[i + k].reset();
+    }
+    if (!success) {
+      return false;
+    }
+    i = j;
+  }
+  if (i < files.size()) {
+    std::cerr << PACKAGE << ':' << names[i] << ": " << strerror(open_errno)
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+
+/* Parses the given PDDL text, and returns true on success. */
+static bool read_string(const std::string& text) {
+  /* The scanner requires two zero bytes after the text. */
+  std::string buffer(text);
+  buffer.append(2, '\0');
+  PddlParser parser("-", std::cerr);
+  bool success = parser.parse(&buffer[0], buffer.size());
+  return define_parsed(parser, success, Fnv1a64(text), NULL);
+}
+
+
+/* Returns the planning parameters for the given problem.  If ground
+   actions are cached, they are looked up under the content of the
+   sources that define the problem and its domain. */
+static Parameters problem_parameters(const Problem& problem,
+                                     const Parameters& params) {
+  Parameters problem_params(params);
+  if (!cache_dir.empty()) {
+    std::lock_guard<std::mutex> lock(sources_mutex);
+    std::map<const Domain*, uint64_t>::const_iterator di =
+        domain_sources.find(&problem.domain());
+    std::map<const Problem*, uint64_t>::const_iterator pi =
+        problem_sources.find(&problem);
+    if (di != domain_sources.end() && pi != problem_sources.end()) {
+      uint64_t key = HashCombine((*di).second,
+                                 Fnv1a64(problem.domain().name()));
+      key = HashCombine(key, (*pi).second);
+      key = HashCombine(key, Fnv1a64(problem.name()));
+      problem_params.action_cache = ActionCacheFile(cache_dir, key);
+      problem_params.action_cache_key = key;
+    }
+  }
+  return problem_params;
+}
+
+
+/* Solves the given problem and prints the resulting plan to the given
+   stream.  Memory used for planning is freed unless this is the last
+   problem. */
+static void solve_problem(const Problem& problem,
+                          const Parameters& search_params,
+                          bool last_problem, std::ostream& os) {
+  const Parameters params = problem_parameters(problem, search_params);
+  os << ';' << problem.name() << std::endl;
+  Timer<> timer;
+  /* In anytime mode, plans are printed to standard output as soon as
+     they are found, even if the rest of the output is buffered, in
+     which case they are preceded by the name of the problem. */
+  Plan::PlanCallback print_plan;
+  if (params.anytime) {
+    print_plan = [&timer, &problem, &os](const Plan& plan) {
+      const auto elapsed_millis =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              timer.ElapsedTime());
+      std::lock_guard<std::mutex> lock(output_mutex);
+      if (&os != &std::cout) {
+        std::cout << ';' << problem.name() << std::endl;
+      }
+      std::cout << ";Plan found at " << elapsed_millis.count() << " ms"
+                << std::endl << plan << std::endl << std::flush;
+    };
+  }
+  const Plan* plan = Plan::plan(problem, params, last_problem, print_plan);
+  if (plan != NULL) {
+    if (plan->complete()) {
+      if (verbosity > 0) {
+#ifdef DEBUG
+        std::cerr << "Depth of solution: " << plan->depth() << std::endl;
+#endif
+        std::cerr << "Number of steps: " << plan->num_steps() << std::endl;
+      }
+      if (!params.anytime) {
+        os << *plan << std::endl;
+      }
+    } else {
+      os << "no plan" << std::endl;
+      os << ";Search limit reached." << std::endl;
+    }
+  } else {
+    os << "no plan" << std::endl;
+    os << ";Problem has no solution." << std::endl;
+  }
+  if (!last_problem) {
+    if (plan != NULL) {
+      delete plan;
+    }
+    Plan::cleanup();
+  }
+  /* Planning time. */
+  const auto elapsed_millis =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          timer.ElapsedTime());
+  os << "Time: " << elapsed_millis.count() << std::endl;
+}
+
+
+/* Prints the given outputs of solved problems, indexed by the
+   position of the problems in their queue, in the order of the
+   problem names.  Only the last problem with a given name counts.
+   Printing stops at the first of these problems that failed, and the
+   exception thrown while solving it is rethrown, as is the exception
+   of any other problem that failed. */
+static void print_by_name(const std::map<size_t, std::string>& names,
+                          const std::map<size_t, std::string>& outputs,
+                          const std::map<size_t, std::exception_ptr>& errors) {
+  std::map<std::string, size_t> last_defined;
+  for (std::map<size_t, std::string>::const_iterator ni = names.begin();
+       ni != names.end(); ni++) {
+    last_defined[(*ni).second] = (*ni).first;
+  }
+  for (std::map<std::string, size_t>::const_iterator li =
+           last_defined.begin();
+       li != last_defined.end(); li++) {
+    const size_t index = (*li).second;
+    std::map<size_t, std::exception_ptr>::const_iterator ei =
+        errors.find(index);
+    if (ei != errors.end()) {
+      std::rethrow_exception((*ei).second);
+    }
+    std::map<size_t, std::string>::const_iterator oi = outputs.find(index);
+    if (oi != outputs.end()) {
+      std::cout << (*oi).second;
+    }
+  }
+  std::cout << std::flush;
+  /* A problem that failed may have been redefined by a problem that
+     was never solved. */
+  if (!errors.empty()) {
+    std::rethrow_exception((*errors.begin()).second);
+  }
+}
+
+
+/* Solves the problems in the given queue on the given number of
+   threads, and prints the results in the order of the problems, or,
+   if by_name is true, in the order of the problem names once all
+   problems are solved, with only the last problem with a given name
+   counting.  The tables that parsers add to are held shared while a
+   problem is solved.  Each problem is deleted once it has been solved
+   if release is true.  Memory used for the last problem is not freed
+   if keep_last is true. */
+static void solve_problems(ProblemQueue& queue, const Parameters& params,
+                           int jobs, bool keep_last, bool release,
+                           bool by_name) {
+  const Problem* problem;
+  size_t index;
+  bool last;
+  /* Name, output and exception of each problem solved but not yet
+     printed. */
+  std::map<size_t, std::string> names;
+  std::map<size_t, std::string> outputs;
+  std::map<size_t, std::exception_ptr> errors;
+  if (jobs <= 1) {
+    while (queue.pop(problem, index, last)) {
+      const bool keep = keep_last && last;
+      std::ostringstream output;
+      std::exception_ptr error;
+      try {
+        std::shared_lock<std::shared_mutex> tables =
+            PddlParser::read_tables();
+        solve_problem(*problem, params, keep,
+                      by_name ? output : std::cout);
+      } catch (...) {
+        if (!by_name) {
+          throw;
+        }
+        error = std::current_exception();
+        queue.stop();
+      }
+      if (by_name) {
+        names[index] = problem->name();
+        outputs[index] = output.str();
+        if (error != NULL) {
+          errors[index] = error;
+        }
+      }
+      if (release && !keep) {
+        release_problem(problem);
+      }
+      queue.solved();
+    }
+    if (by_name) {
+      print_by_name(names, outputs, errors);
+    }
+    return;
+  }
+  /* Number of threads still solving problems. */
+  int running = jobs;
+  std::mutex mutex;
+  std::condition_variable finished;
+  std::vector<std::thread> threads;
+  for (int j = 0; j < jobs; j++) {
+    threads.emplace_back([&]() {
+      const Problem* problem;
+      size_t index;
+      bool last;
+      while (queue.pop(problem, index, last)) {
+        std::ostringstream output;
+        std::exception_ptr error;
+        try {
+          std::shared_lock<std::shared_mutex> tables =
+              PddlParser::read_tables();
+          solve_problem(*problem, params, false, output);
+        } catch (...) {
+          error = std::current_exception();
+          queue.stop();
+        }
+        const std::string name = problem->name();
+        if (release) {
+          release_problem(problem);
+        }
+        queue.solved();
+        std::lock_guard<std::mutex> lock(mutex);
+        names[index] = name;
+        outputs[index] = output.str();
+        if (error != NULL) {
+          errors[index] = error;
+        }
+        finished.notify_all();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      running--;
+      finished.notify_all();
+    });
+  }
+  /* Print the output of each problem as soon as the problems before it
+     are done, until a problem fails. */
+  std::exception_ptr error;
+  for (index = 0; !by_name; index++) {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&]() {
+      return outputs.find(index) != outputs.end() || running == 0;
+    });
+    std::map<size_t, std::string>::iterator oi = outputs.find(index);
+    if (oi == outputs.end()) {
+      break;
+    }
+    std::map<size_t, std::exception_ptr>::const_iterator ei =
+        errors.find(index);
+    if (ei != errors.end()) {
+      error = (*ei).second;
+      break;
+    }
+    const std::string output = std::move((*oi).second);
+    outputs.erase(oi);
+    lock.unlock();
+    std::lock_guard<std::mutex> output_lock(output_mutex);
+    std::cout << output << std::flush;
+  }
+  for (size_t j = 0; j < threads.size(); j++) {
+    threads[j].join();
+  }
+  if (error != NULL) {
+    std::rethrow_exception(error);
+  }
+  if (by_name) {
+    print_by_name(names, outputs, errors);
+  }
+}
+
+
+/* Solves the problems in the table of problems on the given number of
+   threads, and prints the results in the order of the table.  Memory
+   used for the last problem is not freed if keep_last is true. */
+static void solve_defined(const Parameters& params, int jobs,
+                          bool keep_last) {
+  ProblemQueue queue(std::numeric_limits<size_t>::max());
+  for (Problem::ProblemMap::const_iterator pi = Problem::begin();
+       pi != Problem::end(); pi++) {
+    queue.push((*pi).second);
+  }
+  queue.close();
+  solve_problems(queue, params, jobs, keep_last, false, false);
+}
+
+
+/* Parses the given files on a separate thread, and solves the problems
+   they define on the given number of threads while later files are
+   parsed.  The problems are solved in the order they are parsed, and
+   each problem is deleted once it has been solved.  The result of
+   each problem is printed as soon as the problems before it are done,
+   or, if by_name is true, in the order of the problem names once all
+   problems have been solved, with a problem redefined by a later file
+   replaced by the later definition.  Only a few problems per job are
+   parsed ahead of the solvers.  Memory used for the last problem is
+   not freed if keep_last is true.  Returns false if a file fails to
+   parse, once the problems defined before it have been solved. */
+static bool solve_files(const std::vector<const char*>& names,
+                        const Parameters& params, int jobs,
+                        bool keep_last, bool by_name) {
+  ProblemQueue queue(READ_AHEAD * jobs);
+  bool success = false;
+  std::exception_ptr error;
+  std::thread reader([&]() {
+    try {
+      success = read_files(names, jobs, &queue);
+    } catch (...) {
+      error = std::current_exception();
+      queue.stop();
+    }
+    queue.close();
+  });
+  try {
+    solve_problems(queue, params, jobs, keep_last, true, by_name);
+  } catch (...) {
+    queue.stop();
+    reader.join();
+    throw;
+  }
+  reader.join();
+  if (error != NULL) {
+    std::rethrow_exception(error);
+  }
+  return success;
+}
+
+
+/* Parses the given files, with `-' standing for PDDL text read from
+   standard input up to a line holding a single `.', then solves the
+   problems they define on the given number of threads and removes
+   them.  Files that define domains but no
+   problems are added to the given set, and are skipped if they are
+   already in it, so their domains stay loaded between requests. */
+static void serve_request(const std::vector<std::string>& names,
+                          const Parameters& params, int jobs,
+                          std::set<std::string>& domain_files) {
+  const std::map<std::string, const Domain*> old_domains(Domain::begin(),
+                                                         Domain::end());
+  const TermTable::Mark terms_mark = TermTable::mark();
+  bool success = true;
+  for (size_t i = 0; success && i < names.size(); i++) {
+    const std::string& name = names[i];
+    if (name != "-" && domain_files.find(name) != domain_files.end()) {
+      continue;
+    }
+    const std::map<std::string, const Domain*> domains(Domain::begin(),
+                                                       Domain::end());
+    const bool no_problems = (Problem::begin() == Problem::end());
+    bool domain_only = false;
+    if (name == "-") {
+      std::string text;
+      std::string line;
+      while (std::getline(std::cin, line) && line != ".") {
+        text += line;
+        text += '\n';
+      }
+      success = read_string(text);
+    } else {
+      success = read_file(name.c_str(), NULL);
+      domain_only = (success && no_problems
+                     && Problem::begin() == Problem::end());
+    }
+    for (std::map<std::string, const Domain*>::const_iterator di =
+             domains.begin();
+         di != domains.end(); di++) {
+      if (Domain::find((*di).first) != (*di).second) {
+        /* A domain was redefined, and the files that define it may
+           have to be parsed again. */
+        Plan::clear_domain_cache();
+        domain_files.clear();
+        break;
+      }
+    }
+    if (domain_only) {
+      domain_files.insert(name);
+    }
+  }
+  if (success) {
+    solve_defined(params, jobs, false);
+  }
+  Problem::clear();
+  problem_sources.clear();
+  /* Ground literals and fluents of the problems that were solved are
+     only held by their tables now. */
+  Literal::release_unused();
+  Fluent::release_unused();
+  if (std::map<std::string, const Domain*>(Domain::begin(), Domain::end())
+      == old_domains) {
+    /* All objects and variables added by this request belong to the
+       problems that were solved, or to their plans. */
+    TermTable::release(terms_mark);
+  }
+  /* End of response. */
+  std::cout << '.' << std::endl;
+}
+
+
+/* Serves planning requests, one per line of standard input, until end
+   of file.  Each request lists the files to parse.  The given files
+   are handled as a first request, before reading from standard
+   input. */
+static void serve(const std::vector<std::string>& files,
+                  const Parameters& params, int jobs) {
+  std::set<std::string> domain_files;
+  serve_request(files, params, jobs, domain_files);
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    std::istringstream request(line);
+    std::vector<std::string> names;
+    std::string name;
+    while (request >> name) {
+      names.push_back(name);
+    }
+    serve_request(names, params, jobs, domain_files);
   }
 }
 
@@ -174,6 +985,9 @@ static bool read_file(const char* name) {
 static void cleanup() {
   Problem::clear();
   Domain::clear();
+  Fluent::clear();
+  Negation::clear();
+  Atom::clear();
 }
 
 
@@ -186,6 +1000,12 @@ int main(int argc, char* argv[]) {
   Parameters params;
   bool no_flaw_order = true;
   bool no_search_limit = true;
+  /* Whether to serve planning requests read from standard input. */
+  bool server = false;
+  /* Number of problems to solve concurrently. */
+  int jobs = 1;
+  /* Whether to print results in the order of the problem names. */
+  bool name_order = false;
   /* Set default verbosity. */
   verbosity = 0;
   /* Set default warning level. */
@@ -205,6 +1025,9 @@ int main(int argc, char* argv[]) {
       break;
     }
     switch (c) {
+    case 'A':
+      params.anytime = true;
+      break;
     case 'a':
       try {
         params.set_action_cost(optarg);
@@ -215,10 +1038,19 @@ int main(int argc, char* argv[]) {
         return -1;
       }
       break;
+    case 'c':
+      cache_dir = optarg;
+      break;
     case 'd':
       params.domain_constraints = true;
       params.keep_static_preconditions = (optarg == NULL || atoi(optarg) != 0);
       break;
+    case 'D':
+      params.prune_duplicates = true;
+      break;
+    case 'e':
+      params.deferred_evaluation = true;
+      break;
     case 'f':
       try {
         if (no_flaw_order) {
@@ -236,6 +1068,16 @@ int main(int argc, char* argv[]) {
     case 'g':
       params.ground_actions = true;
       break;
+    case 'G':
+      params.grounding_threads = atoi(optarg);
+      if (params.grounding_threads < 1) {
+        std::cerr << PACKAGE ": invalid number of threads `" << optarg << "'"
+                  << std::endl
+                  << "Try `" PACKAGE " --help' for more information."
+                  << std::endl;
+        return -1;
+      }
+      break;
     case 'H':
       display_help();
       return 0;
@@ -249,6 +1091,16 @@ int main(int argc, char* argv[]) {
         return -1;
       }
       break;
+    case 'j':
+      jobs = atoi(optarg);
+      if (jobs < 1) {
+        std::cerr << PACKAGE ": invalid number of jobs `" << optarg << "'"
+                  << std::endl
+                  << "Try `" PACKAGE " --help' for more information."
+                  << std::endl;
+        return -1;
+      }
+      break;
     case 'l':
       if (no_search_limit) {
         params.search_limits.clear();
@@ -260,6 +1112,37 @@ int main(int argc, char* argv[]) {
         params.search_limits.push_back(atoi(optarg));
       }
       break;
+    case 'm':
+      if (optarg == std::string("unlimited")) {
+        params.memory_limit = std::numeric_limits<size_t>::max();
+      } else {
+        int megabytes = atoi(optarg);
+        if (megabytes < 1) {
+          std::cerr << PACKAGE ": invalid memory limit `" << optarg << "'"
+                    << std::endl
+                    << "Try `" PACKAGE " --help' for more information."
+                    << std::endl;
+          return -1;
+        }
+        params.memory_limit = size_t(megabytes) << 20;
+      }
+      break;
+    case 'n':
+      name_order = true;
+      break;
+    case 'p':
+      params.portfolio = true;
+      break;
+    case 'P':
+      params.search_threads = atoi(optarg);
+      if (params.search_threads < 1) {
+        std::cerr << PACKAGE ": invalid number of threads `" << optarg << "'"
+                  << std::endl
+                  << "Try `" PACKAGE " --help' for more information."
+                  << std::endl;
+        return -1;
+      }
+      break;
     case 'r':
       params.random_open_conditions = true;
       break;
@@ -298,6 +1181,9 @@ int main(int argc, char* argv[]) {
     case 'w':
       params.weight = atof(optarg);
       break;
+    case 'x':
+      server = true;
+      break;
     case ':':
     default:
       std::cerr << "Try `" PACKAGE " --help' for more information."
@@ -311,6 +1197,26 @@ int main(int argc, char* argv[]) {
   }
 
   try {
+    if (server) {
+      std::cerr.setf(std::ios::unitbuf);
+      serve(std::vector<std::string>(argv + optind, argv + argc), params,
+            jobs);
+      return 0;
+    }
+
+    if (optind < argc && verbosity <= 1) {
+      /*
+       * Solve the problems defined in the files named by the remaining
+       * command line arguments as soon as they are parsed.
+       */
+      std::cerr.setf(std::ios::unitbuf);
+      if (!solve_files(std::vector<const char*>(argv + optind, argv + argc),
+                       params, jobs, !free_all_memory, name_order)) {
+        return -1;
+      }
+      return 0;
+    }
+
     /*
      * Read pddl files.
      */
@@ -318,18 +1224,27 @@ int main(int argc, char* argv[]) {
       /*
        * Use remaining command line arguments as file names.
        */
-      while (optind < argc) {
-        if (!read_file(argv[optind++])) {
-          return -1;
-        }
+      if (!read_files(std::vector<const char*>(argv + optind, argv + argc),
+                      jobs, NULL)) {
+        return -1;
       }
     } else {
       /*
        * No remaining command line argument, so read from standard input.
        */
-      yyin = stdin;
-      if (yyparse() != 0) {
-        return -1;
+      if (cache_dir.empty()) {
+        PddlParser parser("", std::cerr);
+        bool success = parser.parse(stdin);
+        if (!define_parsed(parser, success, 0, NULL)) {
+          return -1;
+        }
+      } else {
+        /* Read all input first, so that its content can be hashed. */
+        std::string text((std::istreambuf_iterator<char>(std::cin)),
+                         std::istreambuf_iterator<char>());
+        if (!read_string(text)) {
+          return -1;
+        }
       }
     }
 
@@ -357,43 +1272,7 @@ int main(int argc, char* argv[]) {
     /*
      * Solve the problems.
      */
-    for (Problem::ProblemMap::const_iterator pi = Problem::begin();
-         pi != Problem::end(); ) {
-      const Problem& problem = *(*pi).second;
-      pi++;
-      std::cout << ';' << problem.name() << std::endl;
-      Timer<> timer;
-      const Plan* plan =
-          Plan::plan(problem, params, !free_all_memory && pi == Problem::end());
-      if (plan != NULL) {
-        if (plan->complete()) {
-          if (verbosity > 0) {
-#ifdef DEBUG
-            std::cerr << "Depth of solution: " << plan->depth() << std::endl;
-#endif
-            std::cerr << "Number of steps: " << plan->num_steps() << std::endl;
-          }
-          std::cout << *plan << std::endl;
-        } else {
-          std::cout << "no plan" << std::endl;
-          std::cout << ";Search limit reached." << std::endl;
-        }
-      } else {
-        std::cout << "no plan" << std::endl;
-        std::cout << ";Problem has no solution." << std::endl;
-      }
-      if (free_all_memory || pi != Problem::end()) {
-        if (plan != NULL) {
-          delete plan;
-        }
-        Plan::cleanup();
-      }
-      /* Planning time. */
-      const auto elapsed_millis =
-          std::chrono::duration_cast<std::chrono::milliseconds>(
-              timer.ElapsedTime());
-      std::cout << "Time: " << elapsed_millis.count() << std::endl;
-    }
+    solve_defined(params, jobs, !free_all_memory);
   } catch (const std::exception& e) {
     std::cerr << PACKAGE ": " << e.what() << std::endl;
     return -1;